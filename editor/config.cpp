@@ -4,6 +4,7 @@
 #include "filesystemwatcher.hpp"
 
 #include <parser/nodegraph.hpp>
+#include <parser/skeletonanimationmanager.hpp>
 
 #include <QDebug>
 
@@ -43,6 +44,10 @@ bool Self::loadProject(const QFileInfo& path) {
     setProjectSettings(settings);
     auto&& watcher = FileSystemWatcher::getInstance();
     watcher.setDirectories(settings.getResourceDirectories());
+    SkeletonAnimationManager::getInstance().setCacheDirectory(
+        settings.getProjectDirectory()
+            .absoluteFilePath(".cache/spine")
+            .toStdString());
     Q_EMIT projectLoaded(path);
     return true;
 }
@@ -1,5 +1,6 @@
 include(../libraries/cocos2d/cocos2d.pri)
 
+QT += concurrent
 QT += opengl
 QT += xml
 
@@ -96,6 +97,8 @@ DISTFILES += \
     res/selection_box_locked.png
 
 HEADERS += \
+    history/history.hpp \
+    history/historyentry.hpp \
     inspectors/inspector.hpp \
     inspectors/inspectorblend.hpp \
     inspectors/inspectorbool.hpp \
@@ -146,7 +149,9 @@ HEADERS += \
     projectresources.hpp \
     projectsettings.hpp \
     projectsettingsdialog.hpp \
+    resourceindex.hpp \
     resourcetree.hpp \
+    resourcetreemodel.hpp \
     settings.hpp \
     spritesheet.hpp \
     utils.hpp \
@@ -163,6 +168,8 @@ HEADERS += \
     inspectors/skeletonanimationinspectorloader.hpp
 
 SOURCES += \
+    history/history.cpp \
+    history/historyentry.cpp \
     inspectors/inspector.cpp \
     inspectors/inspectorblend.cpp \
     inspectors/inspectorbool.cpp \
@@ -213,7 +220,9 @@ SOURCES += \
     projectresources.cpp \
     projectsettings.cpp \
     projectsettingsdialog.cpp \
+    resourceindex.cpp \
     resourcetree.cpp \
+    resourcetreemodel.cpp \
     settings.cpp \
     spritesheet.cpp \
     utils.cpp \
@@ -1,8 +1,387 @@
+#include <ciso646>
+#include <cstdint>
+#include <functional>
+
 #include "filesystemwatcher.hpp"
 
 #include <QDebug>
+#include <QDirIterator>
+#include <QEvent>
+#include <QFileSystemWatcher>
+#include <QHash>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <QFile>
+#include <QSocketNotifier>
+#endif // Q_OS_LINUX
 
 namespace ee {
+namespace {
+/// Changes closer than this are reported together.
+constexpr auto debounce_interval = 150;
+
+/// Maximum delay of a change while changes keep coming.
+constexpr auto max_delay = 1000;
+
+QVector<QString> listSubdirectories(const QString& path) {
+    QVector<QString> paths;
+    QDirIterator iter(path, QDir::Filter::Dirs | QDir::Filter::NoDotAndDotDot,
+                      QDirIterator::IteratorFlag::Subdirectories);
+    while (iter.hasNext()) {
+        paths.append(iter.next());
+    }
+    return paths;
+}
+
+QVector<QString> listEntries(const QString& path) {
+    QVector<QString> paths;
+    QDirIterator iter(path, QDir::Filter::AllEntries |
+                                QDir::Filter::NoDotAndDotDot,
+                      QDirIterator::IteratorFlag::Subdirectories);
+    while (iter.hasNext()) {
+        paths.append(iter.next());
+    }
+    return paths;
+}
+} // namespace
+
+/// Platform-specific source of changes.
+class FileWatcherBackend {
+public:
+    using Callback = std::function<void(const QString& path,
+                                        FileSystemWatcher::Change change)>;
+
+    explicit FileWatcherBackend(const Callback& callback)
+        : callback_(callback) {}
+
+    virtual ~FileWatcherBackend() = default;
+
+    /// Replaces the watched directories.
+    virtual void setDirectories(const QVector<QDir>& directories) = 0;
+
+protected:
+    Callback callback_;
+};
+
+namespace {
+using Change = FileSystemWatcher::Change;
+
+/// Watches every directory with QFileSystemWatcher and compares the
+/// directory contents to find what changed, used where inotify is not
+/// available. Modified files are only noticed when their directory changes.
+class DirectoryBackend : public FileWatcherBackend {
+private:
+    using Self = DirectoryBackend;
+    using Super = FileWatcherBackend;
+
+public:
+    explicit DirectoryBackend(const Callback& callback)
+        : Super(callback) {
+        QObject::connect(
+            &watcher_, &QFileSystemWatcher::directoryChanged,
+            [this](const QString& path) { compareDirectory(path); });
+    }
+
+    virtual void setDirectories(const QVector<QDir>& directories) override {
+        auto paths = watcher_.directories();
+        if (not paths.isEmpty()) {
+            watcher_.removePaths(paths);
+        }
+        entries_.clear();
+        for (auto&& directory : directories) {
+            addDirectory(directory.absolutePath(), false);
+        }
+    }
+
+private:
+    struct Entry {
+        bool isDir;
+        qint64 size;
+        qint64 modified;
+
+        bool operator==(const Entry& other) const {
+            return isDir == other.isDir && size == other.size &&
+                   modified == other.modified;
+        }
+    };
+
+    using Entries = QHash<QString, Entry>;
+
+    static Entries listDirectory(const QString& path) {
+        Entries entries;
+        QDir dir(path);
+        for (auto&& info : dir.entryInfoList(QDir::Filter::NoDotAndDotDot |
+                                             QDir::Filter::AllEntries)) {
+            Entry entry;
+            entry.isDir = info.isDir();
+            entry.size = info.size();
+            entry.modified = info.lastModified().toMSecsSinceEpoch();
+            entries.insert(info.fileName(), entry);
+        }
+        return entries;
+    }
+
+    /// Watches the specified directory and its sub-directories.
+    /// @param isNew Whether to report their contents as added.
+    void addDirectory(const QString& path, bool isNew) {
+        watcher_.addPath(path);
+        auto entries = listDirectory(path);
+        for (auto iter = entries.cbegin(); iter != entries.cend(); ++iter) {
+            auto childPath = path + '/' + iter.key();
+            if (isNew) {
+                callback_(childPath, Change::Added);
+            }
+            if (iter.value().isDir) {
+                addDirectory(childPath, isNew);
+            }
+        }
+        entries_.insert(path, entries);
+    }
+
+    /// Forgets the specified directory and its sub-directories.
+    void removeDirectory(const QString& path) {
+        auto prefix = path + '/';
+        for (auto iter = entries_.begin(); iter != entries_.end();) {
+            if (iter.key() == path || iter.key().startsWith(prefix)) {
+                watcher_.removePath(iter.key());
+                iter = entries_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    void compareDirectory(const QString& path) {
+        if (not entries_.contains(path)) {
+            return;
+        }
+        if (not QFileInfo(path).isDir()) {
+            // Reported by its parent directory.
+            removeDirectory(path);
+            return;
+        }
+        auto oldEntries = entries_.value(path);
+        auto newEntries = listDirectory(path);
+        entries_.insert(path, newEntries);
+        for (auto iter = oldEntries.cbegin(); iter != oldEntries.cend();
+             ++iter) {
+            auto newIter = newEntries.constFind(iter.key());
+            auto childPath = path + '/' + iter.key();
+            if (newIter == newEntries.cend() ||
+                newIter.value().isDir != iter.value().isDir) {
+                if (iter.value().isDir) {
+                    removeDirectory(childPath);
+                }
+                callback_(childPath, Change::Removed);
+            } else if (not iter.value().isDir &&
+                       not(newIter.value() == iter.value())) {
+                callback_(childPath, Change::Modified);
+            }
+        }
+        for (auto iter = newEntries.cbegin(); iter != newEntries.cend();
+             ++iter) {
+            auto oldIter = oldEntries.constFind(iter.key());
+            if (oldIter != oldEntries.cend() &&
+                oldIter.value().isDir == iter.value().isDir) {
+                continue;
+            }
+            auto childPath = path + '/' + iter.key();
+            callback_(childPath, Change::Added);
+            if (iter.value().isDir) {
+                addDirectory(childPath, true);
+            }
+        }
+    }
+
+    QFileSystemWatcher watcher_;
+
+    /// Last known contents of each watched directory.
+    QHash<QString, Entries> entries_;
+};
+
+#ifdef Q_OS_LINUX
+/// Calls back when the socket is readable.
+/// Handles the activation event directly since the signature of the
+/// activated signal differs between Qt versions.
+class ReadNotifier : public QSocketNotifier {
+private:
+    using Super = QSocketNotifier;
+
+public:
+    explicit ReadNotifier(int socket, const std::function<void()>& callback)
+        : Super(socket, Type::Read)
+        , callback_(callback) {}
+
+protected:
+    virtual bool event(QEvent* event) override {
+        if (event->type() == QEvent::Type::SockAct) {
+            callback_();
+            return true;
+        }
+        return Super::event(event);
+    }
+
+private:
+    std::function<void()> callback_;
+};
+
+/// Watches every directory with inotify, which reports the changed files
+/// directly.
+class InotifyBackend : public FileWatcherBackend {
+private:
+    using Self = InotifyBackend;
+    using Super = FileWatcherBackend;
+
+public:
+    explicit InotifyBackend(const Callback& callback)
+        : Super(callback) {
+        fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd_ >= 0) {
+            notifier_ =
+                std::make_unique<ReadNotifier>(fd_, [this] { readEvents(); });
+        }
+    }
+
+    virtual ~InotifyBackend() override {
+        notifier_.reset();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    bool isValid() const {
+        return fd_ >= 0;
+    }
+
+    virtual void setDirectories(const QVector<QDir>& directories) override {
+        for (auto iter = paths_.cbegin(); iter != paths_.cend(); ++iter) {
+            inotify_rm_watch(fd_, iter.key());
+        }
+        paths_.clear();
+        roots_.clear();
+        for (auto&& directory : directories) {
+            auto path = directory.absolutePath();
+            roots_.append(path);
+            addDirectory(path);
+            for (auto&& subpath : listSubdirectories(path)) {
+                addDirectory(subpath);
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint32_t watch_mask =
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+        IN_ATTRIB | IN_ONLYDIR;
+
+    void addDirectory(const QString& path) {
+        auto wd = inotify_add_watch(fd_, QFile::encodeName(path).constData(),
+                                    watch_mask);
+        if (wd < 0) {
+            qWarning() << "Couldn't watch directory: " << path;
+            return;
+        }
+        paths_.insert(wd, path);
+    }
+
+    /// Stops watching the specified moved directory and its sub-directories.
+    void removeDirectory(const QString& path) {
+        auto prefix = path + '/';
+        for (auto iter = paths_.begin(); iter != paths_.end();) {
+            if (iter.value() == path || iter.value().startsWith(prefix)) {
+                inotify_rm_watch(fd_, iter.key());
+                iter = paths_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    void readEvents() {
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            auto size = ::read(fd_, buffer, sizeof(buffer));
+            if (size <= 0) {
+                break;
+            }
+            for (auto ptr = buffer; ptr < buffer + size;) {
+                auto event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+                processEvent(*event);
+            }
+        }
+    }
+
+    void processEvent(const inotify_event& event) {
+        if ((event.mask & IN_Q_OVERFLOW) != 0) {
+            // Some events were dropped, directories created meanwhile are
+            // not watched yet.
+            QVector<QDir> directories;
+            for (auto&& root : roots_) {
+                directories.append(QDir(root));
+            }
+            setDirectories(directories);
+            callback_(QString(), Change::Rescan);
+            return;
+        }
+        if ((event.mask & IN_IGNORED) != 0) {
+            paths_.remove(event.wd);
+            return;
+        }
+        auto iter = paths_.constFind(event.wd);
+        if (iter == paths_.cend() || event.len == 0) {
+            return;
+        }
+        auto path = iter.value() + '/' + QFile::decodeName(event.name);
+        auto isDir = (event.mask & IN_ISDIR) != 0;
+        if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+            callback_(path, Change::Added);
+            if (isDir) {
+                // Contents may have been created before the watch.
+                addDirectory(path);
+                for (auto&& subpath : listSubdirectories(path)) {
+                    addDirectory(subpath);
+                }
+                for (auto&& entry : listEntries(path)) {
+                    callback_(entry, Change::Added);
+                }
+            }
+        } else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+            if (isDir) {
+                removeDirectory(path);
+            }
+            callback_(path, Change::Removed);
+        } else if (not isDir) {
+            callback_(path, Change::Modified);
+        }
+    }
+
+    int fd_;
+    std::unique_ptr<ReadNotifier> notifier_;
+
+    /// Watched directory of each watch descriptor.
+    QHash<int, QString> paths_;
+
+    QVector<QString> roots_;
+};
+#endif // Q_OS_LINUX
+
+std::unique_ptr<FileWatcherBackend>
+createBackend(const FileWatcherBackend::Callback& callback) {
+#ifdef Q_OS_LINUX
+    auto backend = std::make_unique<InotifyBackend>(callback);
+    if (backend->isValid()) {
+        return std::move(backend);
+    }
+    qWarning() << "inotify is unavailable, watching directories instead";
+#endif // Q_OS_LINUX
+    return std::make_unique<DirectoryBackend>(callback);
+}
+} // namespace
+
 using Self = FileSystemWatcher;
 
 Self& Self::getInstance() {
@@ -11,28 +390,63 @@ Self& Self::getInstance() {
 }
 
 Self::FileSystemWatcher() {
-    connect(&watcher_, &QFileSystemWatcher::fileChanged,
-            [this](const QString& path) {
-                qInfo() << "file changed: " << path;
-                fileChanged(path);
-            });
-
-    connect(&watcher_, &QFileSystemWatcher::directoryChanged,
-            [this](const QString& path) {
-                qInfo() << "directory changed: " << path;
-                directoryChanged(path);
-            });
+    timer_.setSingleShot(true);
+    connect(&timer_, &QTimer::timeout, [this] { flush(); });
+    backend_ = createBackend([this](const QString& path, Change change) {
+        record(path, change);
+    });
 }
 
 Self::~FileSystemWatcher() {}
 
 void Self::setDirectories(const QVector<QDir>& directories) {
-    for (const QDir& dir : directories_) {
-        watcher_.removePath(dir.absolutePath());
+    backend_->setDirectories(directories);
+}
+
+void Self::record(const QString& path, Change change) {
+    switch (change) {
+    case Change::Added:
+        if (pending_.removed.remove(path)) {
+            // Replaced.
+            pending_.modified.insert(path);
+        } else {
+            pending_.added.insert(path);
+        }
+        break;
+    case Change::Removed:
+        pending_.modified.remove(path);
+        if (not pending_.added.remove(path)) {
+            pending_.removed.insert(path);
+        }
+        break;
+    case Change::Modified:
+        if (not pending_.added.contains(path)) {
+            pending_.modified.insert(path);
+        }
+        break;
+    case Change::Rescan:
+        pending_.rescan = true;
+        break;
     }
-    for (const QDir& dir : directories) {
-        watcher_.addPath(dir.absolutePath());
+    if (not timer_.isActive()) {
+        pendingTimer_.start();
+    }
+    if (pendingTimer_.elapsed() < max_delay || not timer_.isActive()) {
+        timer_.start(debounce_interval);
+    }
+}
+
+void Self::flush() {
+    if (pending_.added.isEmpty() && pending_.removed.isEmpty() &&
+        pending_.modified.isEmpty() && not pending_.rescan) {
+        return;
     }
-    directories_ = directories;
+    auto changes = std::move(pending_);
+    pending_ = Changes();
+    qInfo() << "files changed: " << changes.added.size() << " added, "
+            << changes.removed.size() << " removed, "
+            << changes.modified.size() << " modified"
+            << (changes.rescan ? ", rescan" : "");
+    Q_EMIT changed(changes);
 }
 } // namespace ee
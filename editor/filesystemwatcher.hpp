@@ -1,11 +1,19 @@
 #ifndef EE_EDITOR_FILE_SYSTEM_WATCHER_HPP
 #define EE_EDITOR_FILE_SYSTEM_WATCHER_HPP
 
+#include <memory>
+
 #include <QDir>
-#include <QFileSystemWatcher>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QTimer>
 #include <QVector>
 
 namespace ee {
+class FileWatcherBackend;
+
+/// Recursively watches the resource directories and reports the changes in
+/// batches, so that many changes at once, e.g. a checkout, are handled once.
 class FileSystemWatcher : public QObject {
     Q_OBJECT
 
@@ -13,13 +21,33 @@ private:
     using Self = FileSystemWatcher;
 
 public:
+    /// Absolute paths of the changed files and directories. The contents of
+    /// a removed or moved-away directory may not be reported.
+    struct Changes {
+        QSet<QString> added;
+        QSet<QString> removed;
+        QSet<QString> modified;
+
+        /// Whether changes were lost, everything must be listed again.
+        bool rescan = false;
+    };
+
+    enum class Change {
+        Added,
+        Removed,
+        Modified,
+
+        /// Changes were lost, reported with an empty path.
+        Rescan,
+    };
+
     static Self& getInstance();
 
     void setDirectories(const QVector<QDir>& directories);
 
 Q_SIGNALS:
-    void fileChanged(const QString& path);
-    void directoryChanged(const QString& path);
+    /// Occurs once the changes settle.
+    void changed(const Changes& changes);
 
 private:
     FileSystemWatcher();
@@ -28,8 +56,18 @@ private:
     FileSystemWatcher(const Self&) = delete;
     Self& operator=(const Self&) = delete;
 
-    QVector<QDir> directories_;
-    QFileSystemWatcher watcher_;
+    /// Merges the specified change into the pending changes.
+    void record(const QString& path, Change change);
+
+    /// Emits the pending changes.
+    void flush();
+
+    std::unique_ptr<FileWatcherBackend> backend_;
+    Changes pending_;
+
+    /// Restarted on each change, until the pending changes are too old.
+    QTimer timer_;
+    QElapsedTimer pendingTimer_;
 };
 } // namespace ee
 
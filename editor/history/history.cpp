@@ -0,0 +1,102 @@
+#include <ciso646>
+
+#include "history.hpp"
+
+namespace ee {
+using Self = History;
+
+Self::History(std::size_t budget)
+    : position_(0)
+    , budget_(budget)
+    , usage_(0)
+    , mergeInterval_(500)
+    , sealed_(true) {}
+
+Self::~History() {}
+
+void Self::setBudget(std::size_t budget) {
+    budget_ = budget;
+    trim();
+}
+
+std::size_t Self::getBudget() const {
+    return budget_;
+}
+
+std::size_t Self::getUsage() const {
+    return usage_;
+}
+
+void Self::setMergeInterval(std::chrono::milliseconds interval) {
+    mergeInterval_ = interval;
+}
+
+void Self::push(const NodeGraphDiff& forward, const NodeGraphDiff& backward) {
+    while (entries_.size() > position_) {
+        usage_ -= entries_.back().getSize();
+        entries_.pop_back();
+    }
+    HistoryEntry entry(forward, backward);
+    if (not sealed_ && not entries_.empty()) {
+        auto&& last = entries_.back();
+        if (entry.getTime() - last.getTime() <= mergeInterval_ &&
+            last.canMerge(entry)) {
+            usage_ -= last.getSize();
+            last.merge(entry);
+            usage_ += last.getSize();
+            trim();
+            return;
+        }
+    }
+    usage_ += entry.getSize();
+    entries_.push_back(std::move(entry));
+    position_ = entries_.size();
+    sealed_ = false;
+    trim();
+}
+
+void Self::seal() {
+    sealed_ = true;
+}
+
+bool Self::canUndo() const {
+    return position_ > 0;
+}
+
+bool Self::canRedo() const {
+    return position_ < entries_.size();
+}
+
+const NodeGraphDiff* Self::undo() {
+    if (not canUndo()) {
+        return nullptr;
+    }
+    seal();
+    --position_;
+    return &entries_[position_].getBackward();
+}
+
+const NodeGraphDiff* Self::redo() {
+    if (not canRedo()) {
+        return nullptr;
+    }
+    seal();
+    ++position_;
+    return &entries_[position_ - 1].getForward();
+}
+
+void Self::clear() {
+    entries_.clear();
+    position_ = 0;
+    usage_ = 0;
+    sealed_ = true;
+}
+
+void Self::trim() {
+    while (usage_ > budget_ && entries_.size() > 1 && position_ > 1) {
+        usage_ -= entries_.front().getSize();
+        entries_.pop_front();
+        --position_;
+    }
+}
+} // namespace ee
@@ -0,0 +1,72 @@
+#ifndef EE_EDITOR_HISTORY_HPP
+#define EE_EDITOR_HISTORY_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+
+#include "history/historyentry.hpp"
+
+namespace ee {
+/// Undo/redo journal storing node graph deltas instead of snapshots.
+class History {
+private:
+    using Self = History;
+
+public:
+    /// Constructs an empty history.
+    /// @param budget The maximum number of bytes used by the entries.
+    explicit History(std::size_t budget = 16 * 1024 * 1024);
+
+    ~History();
+
+    /// Sets the memory budget, the oldest entries are dropped when it is
+    /// exceeded. The latest entry is always kept.
+    void setBudget(std::size_t budget);
+    std::size_t getBudget() const;
+
+    /// Gets the approximate number of bytes used by the entries.
+    std::size_t getUsage() const;
+
+    /// Sets the maximum interval between two changes of the same properties
+    /// to be merged into a single entry, e.g. while dragging.
+    void setMergeInterval(std::chrono::milliseconds interval);
+
+    /// Records a change, discards the redoable entries.
+    /// @param forward Transforms the old node graph into the new one.
+    /// @param backward Transforms the new node graph into the old one.
+    void push(const NodeGraphDiff& forward, const NodeGraphDiff& backward);
+
+    /// Prevents the next change from being merged into the latest entry.
+    void seal();
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+    /// Moves back by one entry.
+    /// @return The diff to apply, nullptr if there is nothing to undo.
+    const NodeGraphDiff* undo();
+
+    /// Moves forward by one entry.
+    /// @return The diff to apply, nullptr if there is nothing to redo.
+    const NodeGraphDiff* redo();
+
+    /// Removes all entries.
+    void clear();
+
+private:
+    void trim();
+
+    std::deque<HistoryEntry> entries_;
+
+    /// Number of applied entries, entries after it can be redone.
+    std::size_t position_;
+
+    std::size_t budget_;
+    std::size_t usage_;
+    std::chrono::milliseconds mergeInterval_;
+    bool sealed_;
+};
+} // namespace ee
+
+#endif // EE_EDITOR_HISTORY_HPP
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <ciso646>
+
+#include "historyentry.hpp"
+
+#include <parser/nodegraph.hpp>
+
+#include <QtGlobal>
+
+namespace ee {
+namespace {
+using Kind = NodeGraphDiff::Kind;
+using Operation = NodeGraphDiff::Operation;
+
+std::size_t estimateSize(const Value& value) {
+    auto size = sizeof(Value);
+    if (value.isString()) {
+        size += value.asString().capacity();
+    } else if (value.isList()) {
+        for (auto&& elt : value.asList()) {
+            size += estimateSize(elt);
+        }
+    } else if (value.isMap()) {
+        for (auto&& elt : value.asMap()) {
+            size += elt.first.capacity() + estimateSize(elt.second);
+        }
+    }
+    return size;
+}
+
+std::size_t estimateSize(const NodeGraph& graph) {
+    auto size = sizeof(NodeGraph);
+    auto&& handler = graph.getPropertyHandler();
+    size += handler.getPropertyCount() * sizeof(Symbol);
+    for (auto&& value : handler.getPropertyValues()) {
+        size += estimateSize(value);
+    }
+    for (auto&& child : graph.getChildren()) {
+        size += estimateSize(child);
+    }
+    return size;
+}
+
+std::size_t estimateSize(const NodeGraphDiff& diff) {
+    std::size_t size = 0;
+    for (auto&& operation : diff.getOperations()) {
+        size += sizeof(Operation);
+        size += operation.path.capacity() * sizeof(std::size_t);
+        size += estimateSize(operation.value);
+        if (operation.graph) {
+            // Subtrees may be shared with the live graph, count them anyway
+            // so that structural changes do not escape the budget.
+            size += estimateSize(*operation.graph);
+        }
+    }
+    return size;
+}
+
+std::size_t estimateSize(const NodeGraphDiff& forward,
+                         const NodeGraphDiff& backward) {
+    return sizeof(HistoryEntry) + estimateSize(forward) +
+           estimateSize(backward);
+}
+
+bool isSameTarget(const Operation& lhs, const Operation& rhs) {
+    return lhs.kind == rhs.kind && lhs.key == rhs.key && lhs.path == rhs.path;
+}
+} // namespace
+
+using Self = HistoryEntry;
+
+Self::HistoryEntry(const NodeGraphDiff& forward, const NodeGraphDiff& backward)
+    : forward_(forward)
+    , backward_(backward)
+    , size_(estimateSize(forward, backward))
+    , time_(Clock::now()) {}
+
+Self::~HistoryEntry() {}
+
+const NodeGraphDiff& Self::getForward() const {
+    return forward_;
+}
+
+const NodeGraphDiff& Self::getBackward() const {
+    return backward_;
+}
+
+std::size_t Self::getSize() const {
+    return size_;
+}
+
+Self::Clock::time_point Self::getTime() const {
+    return time_;
+}
+
+bool Self::isPropertyOnly() const {
+    auto&& operations = forward_.getOperations();
+    return std::all_of(operations.cbegin(), operations.cend(),
+                       [](const Operation& operation) {
+                           return operation.kind == Kind::SetProperty;
+                       });
+}
+
+bool Self::canMerge(const Self& other) const {
+    if (not isPropertyOnly() || not other.isPropertyOnly()) {
+        return false;
+    }
+    auto&& lhs = forward_.getOperations();
+    auto&& rhs = other.forward_.getOperations();
+    return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(),
+                      isSameTarget);
+}
+
+void Self::merge(const Self& other) {
+    Q_ASSERT(canMerge(other));
+    // The same properties are set: keep the oldest values for undo and the
+    // newest values for redo.
+    forward_ = other.forward_;
+    size_ = estimateSize(forward_, backward_);
+    time_ = other.time_;
+}
+} // namespace ee
@@ -0,0 +1,53 @@
+#ifndef EE_EDITOR_HISTORY_ENTRY_HPP
+#define EE_EDITOR_HISTORY_ENTRY_HPP
+
+#include <chrono>
+#include <cstddef>
+
+#include <parser/nodegraphdiff.hpp>
+
+namespace ee {
+/// A single undoable change of the node graph.
+class HistoryEntry {
+private:
+    using Self = HistoryEntry;
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Constructs an entry.
+    /// @param forward Transforms the old node graph into the new one.
+    /// @param backward Transforms the new node graph into the old one.
+    explicit HistoryEntry(const NodeGraphDiff& forward,
+                          const NodeGraphDiff& backward);
+
+    ~HistoryEntry();
+
+    const NodeGraphDiff& getForward() const;
+    const NodeGraphDiff& getBackward() const;
+
+    /// Gets the approximate number of bytes owned by this entry.
+    std::size_t getSize() const;
+
+    /// Gets the time of the last change recorded in this entry.
+    Clock::time_point getTime() const;
+
+    /// Checks whether the specified entry can be merged into this entry,
+    /// i.e. both only set the same properties of the same nodes.
+    bool canMerge(const Self& other) const;
+
+    /// Merges the specified later entry into this entry, the size is
+    /// estimated again.
+    void merge(const Self& other);
+
+private:
+    bool isPropertyOnly() const;
+
+    NodeGraphDiff forward_;
+    NodeGraphDiff backward_;
+    std::size_t size_;
+    Clock::time_point time_;
+};
+} // namespace ee
+
+#endif // EE_EDITOR_HISTORY_ENTRY_HPP
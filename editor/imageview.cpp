@@ -1,4 +1,5 @@
 #include "imageview.hpp"
+#include "projectresources.hpp"
 
 #include <2d/CCSpriteFrameCache.h>
 #include <base/CCDirector.h>
@@ -64,7 +65,10 @@ void Self::displayImage(const QString& imagePath) {
     auto director = cocos2d::Director::getInstance();
     auto textureCache = director->getTextureCache();
     auto texture = textureCache->getTextureForKey(imagePath.toStdString());
-    Q_ASSERT(texture != nullptr);
+    if (texture == nullptr) {
+        // Could not be loaded.
+        return;
+    }
 
     cocos2d::Rect rect;
     rect.origin = cocos2d::Point::ZERO;
@@ -76,6 +80,9 @@ void Self::displaySpriteFrame(const QString& spriteFrameName) {
     auto cache = cocos2d::SpriteFrameCache::getInstance();
     auto spriteFrame =
         cache->getSpriteFrameByName(spriteFrameName.toStdString());
+    if (spriteFrame == nullptr) {
+        return;
+    }
     auto texture = spriteFrame->getTexture();
     auto&& rect = spriteFrame->getRect();
     auto&& offset = spriteFrame->getOffset();
@@ -186,6 +193,8 @@ void Self::setImagePath(const QString& path) {
     qDebug() << "Image view set image path: " << path;
     display_ = Display::Image;
     imagePath_ = path;
+    // Textures are loaded on first use, not while painting.
+    ProjectResources::getInstance().loadTexture(path);
     update();
 }
 
@@ -193,6 +202,7 @@ void Self::setSpriteFrameName(const QString& name) {
     qDebug() << "Image view set sprite frame name: " << name;
     display_ = Display::SpriteFrame;
     spriteFrameName_ = name;
+    ProjectResources::getInstance().loadSpriteFrame(name);
     update();
 }
 
@@ -1,12 +1,12 @@
 #include <ciso646>
 
 #include "inspectortexture.hpp"
+#include "projectresources.hpp"
 #include "selection/selectionpath.hpp"
 #include "selection/selectiontree.hpp"
 #include "ui_inspectortexture.h"
 
-#include <base/CCDirector.h>
-#include <renderer/CCTextureCache.h>
+#include <platform/CCFileUtils.h>
 
 #include <QDebug>
 #include <QDragEnterEvent>
@@ -33,9 +33,14 @@ Self::InspectorTexture(QWidget* parent)
                 setPropertyValue("", true);
             });
     connect(ui_->resetSizeButton, &QPushButton::clicked, [this] {
-        auto cache = cocos2d::Director::getInstance()->getTextureCache();
-        auto texture =
-            cache->getTextureForKey(ui_->propertyInput->text().toStdString());
+        auto fileUtils = cocos2d::FileUtils::getInstance();
+        auto path = fileUtils->fullPathForFilename(
+            ui_->propertyInput->text().toStdString());
+        if (path.empty()) {
+            return;
+        }
+        auto texture = ProjectResources::getInstance().loadTexture(
+            QString::fromStdString(path));
         if (texture != nullptr) {
             Q_EMIT contentSizeResetRequested();
         }
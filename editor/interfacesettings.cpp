@@ -3,9 +3,13 @@
 #include "interfacesettings.hpp"
 #include "utils.hpp"
 
+#include <parser/binarygraph.hpp>
 #include <parser/graphreader.hpp>
+#include <parser/jsongraphreader.hpp>
 #include <parser/nodeloaderlibrary.hpp>
 
+#include <platform/CCFileUtils.h>
+
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -22,6 +26,19 @@ constexpr auto publish_directory = "generated";
 
 using Self = InterfaceSettings;
 
+std::optional<NodeGraph> Self::readPrefab(const std::string& path) {
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    auto fullPath = fileUtils->fullPathForFilename(path);
+    if (fullPath.empty()) {
+        return std::nullopt;
+    }
+    Self settings(QFileInfo(QString::fromStdString(fullPath)));
+    if (not settings.read()) {
+        return std::nullopt;
+    }
+    return settings.getNodeGraph();
+}
+
 Self::InterfaceSettings(const QFileInfo& interfacePath)
     : interfacePath_(interfacePath) {}
 
@@ -41,6 +58,7 @@ void Self::setNodeGraph(const NodeGraph& graph) {
     NodeLoaderLibrary library;
     library.addDefaultLoaders();
     GraphReader reader(library);
+    reader.migrateProperties(graph_.value());
     reader.addDefaultProperties(graph_.value());
 }
 
@@ -51,8 +69,36 @@ bool Self::read() {
         return false;
     }
 
-    auto obj = QJsonDocument().fromJson(file.readAll()).object();
-    return deserialize(obj);
+    auto size = file.size();
+    auto data = file.map(0, size);
+    QByteArray buffer;
+    if (data == nullptr) {
+        // Mapping may fail on some file systems.
+        buffer = file.readAll();
+        data = reinterpret_cast<uchar*>(buffer.data());
+        size = buffer.size();
+    }
+
+    auto bytes = reinterpret_cast<const char*>(data);
+    if (BinaryGraph::isBinary(bytes, static_cast<std::size_t>(size))) {
+        BinaryGraph binaryGraph(bytes, static_cast<std::size_t>(size));
+        if (not binaryGraph.isValid()) {
+            qWarning() << "Corrupted binary interface file";
+            return false;
+        }
+        setNodeGraph(binaryGraph.toNodeGraph());
+        return true;
+    }
+
+    // Stream the properties straight into the node graph.
+    auto graph = JsonGraphReader::read(bytes, static_cast<std::size_t>(size),
+                                       key::node_graph);
+    if (not graph.has_value()) {
+        qWarning() << "Corrupted interface file";
+        return false;
+    }
+    setNodeGraph(graph.value());
+    return true;
 }
 
 bool Self::write() const {
@@ -69,6 +115,21 @@ bool Self::write() const {
     return true;
 }
 
+bool Self::writeBinary(const QString& path) const {
+    if (not getNodeGraph().has_value()) {
+        return false;
+    }
+    QFile file(path);
+    if (not file.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        qWarning() << "Could't open binary interface file to write";
+        return false;
+    }
+
+    auto buffer = BinaryGraph::encode(getNodeGraph().value());
+    file.write(buffer.data(), static_cast<qint64>(buffer.size()));
+    return true;
+}
+
 bool Self::deserialize(const QJsonObject& json) {
     auto obj = json.value(key::node_graph).toObject();
     auto dict = convertToValue(obj).asMap();
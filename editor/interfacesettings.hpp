@@ -14,6 +14,11 @@ private:
     using Self = InterfaceSettings;
 
 public:
+    /// Reads the node graph of the interface at the specified path, resolved
+    /// by the cocos2d file utils. Used as the prefab loader of graph readers.
+    /// @return std::nullopt if the interface could not be read.
+    static std::optional<NodeGraph> readPrefab(const std::string& path);
+
     explicit InterfaceSettings(const QFileInfo& interfacePath);
 
     virtual ~InterfaceSettings() override;
@@ -29,11 +34,16 @@ public:
     virtual void serialize(QJsonObject& json) const override;
 
     /// Attempts to read from file.
+    /// Both the json and the binary formats are accepted.
     bool read();
 
     /// Attempts to write to file.
     bool write() const;
 
+    /// Attempts to write the node graph in the binary format.
+    /// @param path The output file's path.
+    bool writeBinary(const QString& path) const;
+
 private:
     QFileInfo interfacePath_;
     std::optional<NodeGraph> graph_;
@@ -102,17 +102,22 @@ Self::MainWindow(QWidget* parent)
         sceneManager_->connect();
     });
 
-    auto&& watcher = FileSystemWatcher::getInstance();
-    connect(&watcher, &FileSystemWatcher::fileChanged,
-            [this](const QString& path) {
-                Q_UNUSED(path);
-                ui_->resourceTree->updateResourceDirectories();
-            });
+    connect(ui_->actionUndo, &QAction::triggered, [this] {
+        if (sceneManager_) {
+            sceneManager_->undo();
+        }
+    });
 
-    connect(&watcher, &FileSystemWatcher::directoryChanged,
-            [this](const QString& path) {
-                Q_UNUSED(path);
-                ui_->resourceTree->updateResourceDirectories();
+    connect(ui_->actionRedo, &QAction::triggered, [this] {
+        if (sceneManager_) {
+            sceneManager_->redo();
+        }
+    });
+
+    auto&& watcher = FileSystemWatcher::getInstance();
+    connect(&watcher, &FileSystemWatcher::changed,
+            [this](const FileSystemWatcher::Changes& changes) {
+                ui_->resourceTree->applyChanges(changes);
             });
 
     //  ui_->actionProject_Settings->setEnabled(false);
@@ -216,9 +221,15 @@ void Self::openInterface(const QString& path) {
     qDebug() << "open interface: " << path;
     QFileInfo info(path);
     auto&& config = Config::getInstance();
-    if (config.loadInterface(info)) {
-        loadInterface(info);
+    if (not config.loadInterface(info)) {
+        return;
     }
+    // Decode the textures and parse the skeletons in the background, the
+    // scene then finds them cached.
+    auto&& graph = config.getInterfaceSettings()->getNodeGraph().value();
+    auto&& resources = ProjectResources::getInstance();
+    resources.preloadSkeletons(graph);
+    resources.prefetchTextures(graph, [this, info] { loadInterface(info); });
 }
 
 void Self::loadInterface(const QFileInfo& path) {
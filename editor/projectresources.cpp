@@ -1,17 +1,32 @@
+#include <ciso646>
+
 #include "projectresources.hpp"
 #include "fileclassifier.hpp"
+#include "interfacesettings.hpp"
 #include "projectsettings.hpp"
+#include "resourceindex.hpp"
 #include "utils.hpp"
 
+#include <parser/graphreader.hpp>
+#include <parser/nodegraph.hpp>
+#include <parser/skeletonanimationloader.hpp>
+#include <parser/skeletonanimationmanager.hpp>
+
 #include <2d/CCSpriteFrameCache.h>
 #include <base/CCDirector.h>
 #include <platform/CCFileUtils.h>
+#include <platform/CCImage.h>
 #include <renderer/CCTextureCache.h>
 
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
 namespace ee {
 using Self = ProjectResources;
 
 namespace {
+constexpr auto index_name = ".resource-index";
+
 using FileCallback = std::function<void(const QFileInfo& info)>;
 
 void listFiles(const QFileInfo& info, const FileCallback& callback) {
@@ -28,6 +43,40 @@ void listFiles(const QFileInfo& info, const FileCallback& callback) {
 void listFiles(const QDir& dir, const FileCallback& callback) {
     listFiles(QFileInfo(dir.absolutePath()), callback);
 }
+
+void preloadGraphSkeletons(const NodeGraph& graph,
+                           SkeletonAnimationManager& manager) {
+    using Property = SkeletonAnimationLoader::Property;
+    auto&& handler = graph.getPropertyHandler();
+    auto dataFile =
+        handler.getProperty<std::string>(Property::DataFile.getSymbol());
+    auto atlasFile =
+        handler.getProperty<std::string>(Property::AtlasFile.getSymbol());
+    if (dataFile && atlasFile && not dataFile->empty() &&
+        not atlasFile->empty()) {
+        // Same default scale as the loader, so that the node finds the entry.
+        auto scale =
+            handler.getProperty<float>(Property::AnimationScale.getSymbol())
+                .value_or(1.0f);
+        manager.preloadSkeletonData(*dataFile, *atlasFile, scale);
+    }
+    for (auto&& child : graph.getChildren()) {
+        preloadGraphSkeletons(child, manager);
+    }
+}
+
+/// Decodes an image, called on worker threads.
+cocos2d::Image* decodeImage(const std::string& path) {
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    auto data = fileUtils->getDataFromFile(path);
+    auto image = new cocos2d::Image();
+    if (data.isNull() ||
+        not image->initWithImageData(data.getBytes(), data.getSize())) {
+        image->release();
+        return nullptr;
+    }
+    return image;
+}
 } // namespace
 
 Self& Self::getInstance() {
@@ -35,32 +84,34 @@ Self& Self::getInstance() {
     return sharedInstance;
 }
 
-Self::ProjectResources() {}
+Self::ProjectResources()
+    : prefetchId_(0) {}
+
 Self::~ProjectResources() {}
 
 void Self::removeResources(const ProjectSettings& settings) {
+    Q_UNUSED(settings);
     makeCocosContext();
-    auto&& directories = settings.getResourceDirectories();
-    for (auto&& directory : directories) {
-        listFiles(directory, [](const QFileInfo& info) {
-            if (info.isDir()) {
-                return;
-            }
-            FileClassifier classifier(info);
-            auto path = info.absoluteFilePath();
-            if (classifier.isImage()) {
-                auto director = cocos2d::Director::getInstance();
-                auto cache = director->getTextureCache();
-                qDebug() << "Remove image: " << path;
-                cache->removeTextureForKey(path.toStdString());
-            }
-            if (classifier.isSpriteSheet()) {
-                auto cache = cocos2d::SpriteFrameCache::getInstance();
-                qDebug() << "Remove sheet: " << path;
-                cache->removeSpriteFramesFromFile(path.toStdString());
-            }
-        });
+    auto textureCache = cocos2d::Director::getInstance()->getTextureCache();
+    for (auto&& image : images_) {
+        // No-op for the images that were never loaded.
+        textureCache->removeTextureForKey(image.path.toStdString());
+    }
+    auto spriteFrameCache = cocos2d::SpriteFrameCache::getInstance();
+    for (auto&& path : loadedSpriteSheets_) {
+        qDebug() << "Remove sheet: " << path;
+        spriteFrameCache->removeSpriteFramesFromFile(path.toStdString());
     }
+    if (index_) {
+        index_->write();
+        index_.reset();
+    }
+    images_.clear();
+    spriteSheets_.clear();
+    spriteFrameSheets_.clear();
+    loadedSpriteSheets_.clear();
+    ++prefetchId_;
+
     auto fileUtils = cocos2d::FileUtils::getInstance();
     fileUtils->setSearchPaths({});
     // doneCocosContext();
@@ -68,6 +119,9 @@ void Self::removeResources(const ProjectSettings& settings) {
 
 void Self::addResources(const ProjectSettings& settings) {
     makeCocosContext();
+    index_ = std::make_unique<ResourceIndex>(
+        settings.getProjectDirectory().filePath(index_name));
+    index_->read();
     auto&& directories = settings.getResourceDirectories();
     std::vector<std::string> searchPaths;
     for (auto&& path : defaultSearchPaths_) {
@@ -75,25 +129,37 @@ void Self::addResources(const ProjectSettings& settings) {
     }
     for (auto&& directory : directories) {
         searchPaths.push_back(directory.absolutePath().toStdString());
-        listFiles(directory, [](const QFileInfo& info) {
+        listFiles(directory, [this](const QFileInfo& info) {
             if (info.isDir()) {
                 return;
             }
             FileClassifier classifier(info);
-            auto path = info.absoluteFilePath();
+            if (not classifier.isImage() && not classifier.isSpriteSheet()) {
+                return;
+            }
+            auto&& entry = index_->getEntry(info);
+            Resource resource;
+            resource.path = info.absoluteFilePath();
+            resource.size = entry.size;
+            resource.format = info.suffix();
+            resource.imageSize = entry.imageSize;
             if (classifier.isImage()) {
-                auto director = cocos2d::Director::getInstance();
-                auto cache = director->getTextureCache();
-                qDebug() << "Add image: " << path;
-                cache->addImage(path.toStdString());
+                images_.append(resource);
             }
             if (classifier.isSpriteSheet()) {
-                auto cache = cocos2d::SpriteFrameCache::getInstance();
-                qDebug() << "Add sheet: " << path;
-                cache->addSpriteFramesWithFile(path.toStdString());
+                spriteSheets_.append(resource);
+                for (auto&& frame : entry.frames) {
+                    spriteFrameSheets_.insert(frame, resource.path);
+                }
             }
         });
     }
+    index_->removeUnusedEntries();
+    index_->write();
+    qDebug() << "Registered " << images_.size() << " images and "
+             << spriteSheets_.size() << " sheets, rescanned "
+             << index_->getRescannedCount() << " files";
+
     auto fileUtils = cocos2d::FileUtils::getInstance();
     fileUtils->setSearchPaths(searchPaths);
     for (auto&& path : searchPaths) {
@@ -105,4 +171,93 @@ void Self::addResources(const ProjectSettings& settings) {
 void Self::addDefaultSearchPath(const QString& path) {
     defaultSearchPaths_.append(path);
 }
+
+const QVector<Self::Resource>& Self::getImages() const {
+    return images_;
+}
+
+const QVector<Self::Resource>& Self::getSpriteSheets() const {
+    return spriteSheets_;
+}
+
+QVector<QString> Self::getSpriteFrames(const QString& path) {
+    if (not index_) {
+        return {};
+    }
+    return index_->getEntry(QFileInfo(path)).frames;
+}
+
+cocos2d::Texture2D* Self::loadTexture(const QString& path) {
+    makeCocosContext();
+    auto cache = cocos2d::Director::getInstance()->getTextureCache();
+    auto key = path.toStdString();
+    auto texture = cache->getTextureForKey(key);
+    if (texture == nullptr) {
+        qDebug() << "Load image: " << path;
+        texture = cache->addImage(key);
+    }
+    return texture;
+}
+
+cocos2d::SpriteFrame* Self::loadSpriteFrame(const QString& name) {
+    auto cache = cocos2d::SpriteFrameCache::getInstance();
+    auto iter = spriteFrameSheets_.constFind(name);
+    if (iter == spriteFrameSheets_.cend()) {
+        return nullptr;
+    }
+    auto&& path = iter.value();
+    if (not loadedSpriteSheets_.contains(path)) {
+        makeCocosContext();
+        qDebug() << "Load sheet: " << path;
+        cache->addSpriteFramesWithFile(path.toStdString());
+        loadedSpriteSheets_.insert(path);
+    }
+    return cache->getSpriteFrameByName(name.toStdString());
+}
+
+void Self::prefetchTextures(const NodeGraph& graph,
+                            const std::function<void()>& callback) {
+    auto id = ++prefetchId_;
+    makeCocosContext();
+    // Textures of prefab instances are prefetched as well.
+    GraphReader reader;
+    reader.setPrefabLoader(&InterfaceSettings::readPrefab);
+    auto paths = reader.getUncachedTextures(graph);
+    if (paths.empty()) {
+        callback();
+        return;
+    }
+    qDebug() << "Prefetch " << paths.size() << " textures";
+    auto watcher = new QFutureWatcher<cocos2d::Image*>();
+    QObject::connect(
+        watcher, &QFutureWatcherBase::finished,
+        [this, watcher, paths, id, callback] {
+            makeCocosContext();
+            auto cache = cocos2d::Director::getInstance()->getTextureCache();
+            auto future = watcher->future();
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+                auto image = future.resultAt(static_cast<int>(i));
+                if (image == nullptr) {
+                    continue;
+                }
+                // May have been loaded on demand meanwhile.
+                if (cache->getTextureForKey(paths[i]) == nullptr) {
+                    cache->addImage(image, paths[i]);
+                }
+                image->release();
+            }
+            watcher->deleteLater();
+            if (id == prefetchId_) {
+                callback();
+            }
+        });
+    watcher->setFuture(QtConcurrent::mapped(paths, decodeImage));
+}
+
+void Self::preloadSkeletons(const NodeGraph& graph) {
+    // Atlases are loaded on this thread.
+    makeCocosContext();
+    preloadGraphSkeletons(graph, SkeletonAnimationManager::getInstance());
+}
+
 } // namespace ee
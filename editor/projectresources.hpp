@@ -1,24 +1,87 @@
 #ifndef EE_EDITOR_PROJECT_RESOURCES_HPP
 #define EE_EDITOR_PROJECT_RESOURCES_HPP
 
+#include <functional>
+#include <memory>
+
+#include <QHash>
+#include <QSet>
+#include <QSize>
 #include <QString>
 #include <QVector>
 
+namespace cocos2d {
+class SpriteFrame;
+class Texture2D;
+} // namespace cocos2d
+
 namespace ee {
+class NodeGraph;
 class ProjectSettings;
+class ResourceIndex;
 
+/// Keeps track of the images and sprite sheets of the opened project.
+/// Registering a project only records metadata, textures and sprite sheets
+/// are loaded on first use. The metadata is cached in the project's resource
+/// index.
 class ProjectResources {
 private:
     using Self = ProjectResources;
 
 public:
+    /// Metadata of a resource file.
+    struct Resource {
+        /// Absolute path.
+        QString path;
+
+        /// Size in bytes.
+        qint64 size;
+
+        /// Suffix, e.g. png or plist.
+        QString format;
+
+        /// Dimensions of images, invalid if unknown.
+        QSize imageSize;
+    };
+
     static Self& getInstance();
 
+    /// Unloads the resources of the specified project.
     void removeResources(const ProjectSettings& settings);
+
+    /// Registers the resources of the specified project and sets the search
+    /// paths.
     void addResources(const ProjectSettings& settings);
 
     void addDefaultSearchPath(const QString& path);
 
+    const QVector<Resource>& getImages() const;
+    const QVector<Resource>& getSpriteSheets() const;
+
+    /// Gets the frame names of the specified sprite sheet, the sheet is only
+    /// parsed if it changed since it was indexed.
+    QVector<QString> getSpriteFrames(const QString& path);
+
+    /// Gets the texture at the specified path, loading it if needed.
+    /// @return nullptr if the image could not be loaded.
+    cocos2d::Texture2D* loadTexture(const QString& path);
+
+    /// Gets the specified sprite frame, loading its sprite sheet if needed.
+    /// @return nullptr if no sprite sheet contains the frame.
+    cocos2d::SpriteFrame* loadSpriteFrame(const QString& name);
+
+    /// Decodes the uncached textures of the specified graph on background
+    /// threads and adds them to the texture cache.
+    /// @param callback Called on this thread once the textures are cached,
+    /// unless another prefetch was started meanwhile.
+    void prefetchTextures(const NodeGraph& graph,
+                          const std::function<void()>& callback);
+
+    /// Starts parsing the skeleton data used by the specified graph on a
+    /// background thread, the scene then waits for it instead of parsing it
+    /// again. Prefab instances are not expanded.
+    void preloadSkeletons(const NodeGraph& graph);
+
 private:
     ProjectResources();
     ~ProjectResources();
@@ -27,7 +90,17 @@ private:
     Self& operator=(const Self&) = delete;
 
     QVector<QString> defaultSearchPaths_;
-    QVector<QString> loadedResources_;
+    std::unique_ptr<ResourceIndex> index_;
+    QVector<Resource> images_;
+    QVector<Resource> spriteSheets_;
+
+    /// Sheet of each sprite frame.
+    QHash<QString, QString> spriteFrameSheets_;
+
+    QSet<QString> loadedSpriteSheets_;
+
+    /// Identifies the latest prefetch.
+    int prefetchId_;
 };
 } // namespace ee
 
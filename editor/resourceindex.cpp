@@ -0,0 +1,155 @@
+#include <ciso646>
+
+#include "fileclassifier.hpp"
+#include "resourceindex.hpp"
+#include "spritesheet.hpp"
+
+#include <xxhash/xxhash.h>
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QImageReader>
+#include <QSaveFile>
+
+namespace ee {
+namespace {
+constexpr quint32 index_magic = 0x45455249; // EERI
+constexpr quint32 index_version = 1;
+constexpr auto stream_version = QDataStream::Version::Qt_5_6;
+} // namespace
+
+// Found by QHash's stream operators through argument-dependent lookup.
+QDataStream& operator<<(QDataStream& stream, const ResourceIndex::Entry& e) {
+    return stream << e.size << e.modified << e.hash << e.imageSize
+                  << e.frames;
+}
+
+QDataStream& operator>>(QDataStream& stream, ResourceIndex::Entry& e) {
+    return stream >> e.size >> e.modified >> e.hash >> e.imageSize >>
+           e.frames;
+}
+
+using Self = ResourceIndex;
+
+Self::ResourceIndex(const QString& path)
+    : path_(path)
+    , rescannedCount_(0)
+    , dirty_(false) {}
+
+bool Self::read() {
+    entries_.clear();
+    usedPaths_.clear();
+    rescannedCount_ = 0;
+    dirty_ = false;
+
+    QFile file(path_);
+    if (not file.open(QIODevice::OpenModeFlag::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(stream_version);
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+    if (magic != index_magic || version != index_version) {
+        qWarning() << "Ignored outdated resource index";
+        return false;
+    }
+    QHash<QString, Entry> entries;
+    stream >> entries;
+    if (stream.status() != QDataStream::Status::Ok) {
+        qWarning() << "Corrupted resource index";
+        return false;
+    }
+    entries_ = std::move(entries);
+    return true;
+}
+
+bool Self::write() {
+    if (not dirty_) {
+        return true;
+    }
+    QSaveFile file(path_);
+    if (not file.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        qWarning() << "Couldn't open resource index to write";
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(stream_version);
+    stream << index_magic << index_version << entries_;
+    if (not file.commit()) {
+        return false;
+    }
+    dirty_ = false;
+    return true;
+}
+
+const Self::Entry& Self::getEntry(const QFileInfo& info) {
+    auto path = info.absoluteFilePath();
+    usedPaths_.insert(path);
+    auto iter = entries_.find(path);
+    auto isNew = iter == entries_.end();
+    if (isNew) {
+        iter = entries_.insert(path, Entry());
+    }
+    auto&& entry = iter.value();
+    auto modified = info.lastModified().toMSecsSinceEpoch();
+    if (isNew || entry.size != info.size() || entry.modified != modified) {
+        entry.size = info.size();
+        entry.modified = modified;
+        rescan(info, entry, isNew);
+    }
+    return entry;
+}
+
+void Self::removeUnusedEntries() {
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+        if (usedPaths_.contains(iter.key())) {
+            ++iter;
+        } else {
+            iter = entries_.erase(iter);
+            dirty_ = true;
+        }
+    }
+}
+
+int Self::getRescannedCount() const {
+    return rescannedCount_;
+}
+
+void Self::rescan(const QFileInfo& info, Entry& entry, bool isNew) {
+    ++rescannedCount_;
+    dirty_ = true;
+    QFile file(info.absoluteFilePath());
+    if (not file.open(QIODevice::OpenModeFlag::ReadOnly)) {
+        entry.hash = 0;
+        entry.imageSize = QSize();
+        entry.frames.clear();
+        return;
+    }
+    auto data = file.readAll();
+    auto hash = XXH32(data.constData(), data.size(), 0);
+    if (not isNew && entry.hash == hash) {
+        // Touched but not modified.
+        return;
+    }
+    entry.hash = hash;
+    entry.imageSize = QSize();
+    entry.frames.clear();
+
+    FileClassifier classifier(info);
+    if (classifier.isImage()) {
+        // Only decodes the header, formats unknown to Qt stay invalid.
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer);
+        entry.imageSize = reader.size();
+    }
+    if (classifier.isSpriteSheet()) {
+        SpriteSheet sheet(data);
+        entry.frames = sheet.getFrames();
+    }
+}
+} // namespace ee
@@ -0,0 +1,69 @@
+#ifndef EE_EDITOR_RESOURCE_INDEX_HPP
+#define EE_EDITOR_RESOURCE_INDEX_HPP
+
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+namespace ee {
+/// Project-local cache of what is known about the resource files, so that
+/// reopening a project only rescans the files whose size or modification
+/// time changed.
+class ResourceIndex {
+private:
+    using Self = ResourceIndex;
+
+public:
+    struct Entry {
+        qint64 size;
+
+        /// Modification time in milliseconds since epoch.
+        qint64 modified;
+
+        /// xxHash of the content.
+        quint32 hash;
+
+        /// Dimensions of images, invalid if unknown.
+        QSize imageSize;
+
+        /// Frame names of sprite sheets.
+        QVector<QString> frames;
+    };
+
+    /// Constructs an empty index.
+    /// @param path The index file's path.
+    explicit ResourceIndex(const QString& path);
+
+    /// Attempts to read from file, the index is left empty on failure.
+    bool read();
+
+    /// Attempts to write to file, nothing is written if unchanged.
+    bool write();
+
+    /// Gets the entry of the specified file, the file is rescanned if new or
+    /// if its size or modification time changed.
+    const Entry& getEntry(const QFileInfo& info);
+
+    /// Removes the entries of the files not accessed since the index was
+    /// read, i.e. the deleted files.
+    void removeUnusedEntries();
+
+    /// Gets the number of files rescanned since the index was read.
+    int getRescannedCount() const;
+
+private:
+    /// Reads the content of the file and updates its entry.
+    void rescan(const QFileInfo& info, Entry& entry, bool isNew);
+
+    QString path_;
+    QHash<QString, Entry> entries_;
+    QSet<QString> usedPaths_;
+    int rescannedCount_;
+    bool dirty_;
+};
+} // namespace ee
+
+#endif // EE_EDITOR_RESOURCE_INDEX_HPP
@@ -1,24 +1,34 @@
 #ifndef EE_EDITOR_RESOURCE_TREE_HPP
 #define EE_EDITOR_RESOURCE_TREE_HPP
 
-#include <QFileInfo>
-#include <QTreeWidget>
+#include <memory>
+
+#include <QTreeView>
+
+#include "filesystemwatcher.hpp"
 
 namespace ee {
+class ResourceTreeModel;
+
 /// Displays all resource files in the current project.
-class ResourceTree : public QTreeWidget {
+class ResourceTree : public QTreeView {
     Q_OBJECT
 
 private:
     using Self = ResourceTree;
-    using Super = QTreeWidget;
+    using Super = QTreeView;
 
 public:
     explicit ResourceTree(QWidget* parent = nullptr);
 
+    virtual ~ResourceTree() override;
+
     void setListenToFileChangeEvents(bool enabled);
     void updateResourceDirectories();
 
+    /// Updates the listed items affected by the specified changes.
+    void applyChanges(const FileSystemWatcher::Changes& changes);
+
 Q_SIGNALS:
     /// Occurs when the user double-clicks an interface file.
     /// @param interfacePath The interface file's path, relative to the
@@ -37,23 +47,12 @@ Q_SIGNALS:
     void noneSelected();
 
 protected:
-    void updateResourcePath(QTreeWidgetItem* item, const QFileInfo& info);
-
-    virtual QMimeData*
-    mimeData(const QList<QTreeWidgetItem*> items) const override;
-
-    virtual QStringList mimeTypes() const override;
+    virtual void currentChanged(const QModelIndex& current,
+                                const QModelIndex& previous) override;
 
 private:
-    QSet<QString> saveExpandedItems();
-    void restoreExpandedItems(const QSet<QString>& expandedItems);
-    void reloadResources();
-    QStack<QString> saveSelectedItem();
-    void restoreSelectedItem(QStack<QString> names);
-    QStringList getPathComponents(const QTreeWidgetItem* item) const;
-    QString getPath(const QTreeWidgetItem* item) const;
-
     bool listened_;
+    std::unique_ptr<ResourceTreeModel> treeModel_;
 };
 } // namespace ee
 
@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <ciso646>
+
+#include "fileclassifier.hpp"
+#include "projectresources.hpp"
+#include "resourcetreemodel.hpp"
+
+#include <QMimeData>
+#include <QSet>
+
+namespace ee {
+using Self = ResourceTreeModel;
+
+struct Self::Item {
+    enum class Kind {
+        Directory,
+        File,
+        SpriteSheet,
+        SpriteFrame,
+    };
+
+    explicit Item(Kind kind_, const QString& name_, const QString& path_,
+                  Item* parent_)
+        : kind(kind_)
+        , name(name_)
+        , path(path_)
+        , parent(parent_)
+        , fetched(false) {}
+
+    bool isExpandable() const {
+        return kind == Kind::Directory || kind == Kind::SpriteSheet;
+    }
+
+    int row() const {
+        auto&& siblings = parent->children;
+        for (std::size_t i = 0; i < siblings.size(); ++i) {
+            if (siblings[i].get() == this) {
+                return static_cast<int>(i);
+            }
+        }
+        Q_ASSERT(false);
+        return -1;
+    }
+
+    Kind kind;
+    QString name;
+
+    /// Absolute path, the sprite sheet's path for sprite frames.
+    QString path;
+
+    Item* parent;
+    std::vector<std::unique_ptr<Item>> children;
+
+    /// Whether the children were listed.
+    bool fetched;
+};
+
+Self::ResourceTreeModel(QObject* parent)
+    : Super(parent) {
+    rootItem_ = std::make_unique<Item>(Item::Kind::Directory, QString(),
+                                       QString(), nullptr);
+    rootItem_->fetched = true;
+}
+
+Self::~ResourceTreeModel() {}
+
+void Self::setDirectories(const QVector<QDir>& directories) {
+    QVector<QString> paths;
+    for (auto&& directory : directories) {
+        paths.append(directory.absolutePath());
+    }
+    QVector<QString> currentPaths;
+    for (auto&& item : rootItem_->children) {
+        currentPaths.append(item->path);
+    }
+    if (paths == currentPaths) {
+        for (auto&& item : rootItem_->children) {
+            updateItem(item.get());
+        }
+        return;
+    }
+    beginResetModel();
+    rootItem_->children.clear();
+    for (auto&& path : paths) {
+        rootItem_->children.push_back(std::make_unique<Item>(
+            Item::Kind::Directory, QFileInfo(path).fileName(), path,
+            rootItem_.get()));
+    }
+    endResetModel();
+}
+
+void Self::updatePath(const QString& path) {
+    auto item = findItem(path);
+    if (item == nullptr || not QFileInfo::exists(path)) {
+        // Added or removed, the parent directory is updated instead.
+        item = findItem(QFileInfo(path).absolutePath());
+    }
+    if (item == nullptr) {
+        return;
+    }
+    updateItem(item);
+}
+
+void Self::refresh() {
+    for (auto&& item : rootItem_->children) {
+        refreshItem(item.get());
+    }
+}
+
+QModelIndex Self::findIndex(const QString& path) const {
+    auto item = findItem(path);
+    if (item == nullptr) {
+        return QModelIndex();
+    }
+    return getIndex(item);
+}
+
+QString Self::getFilePath(const QModelIndex& index) const {
+    if (not index.isValid()) {
+        return QString();
+    }
+    return getItem(index)->path;
+}
+
+bool Self::isSpriteFrame(const QModelIndex& index) const {
+    if (not index.isValid()) {
+        return false;
+    }
+    return getItem(index)->kind == Item::Kind::SpriteFrame;
+}
+
+Self::Item* Self::getItem(const QModelIndex& index) const {
+    if (not index.isValid()) {
+        return rootItem_.get();
+    }
+    return static_cast<Item*>(index.internalPointer());
+}
+
+QModelIndex Self::getIndex(const Item* item) const {
+    if (item == rootItem_.get()) {
+        return QModelIndex();
+    }
+    return createIndex(item->row(), 0, const_cast<Item*>(item));
+}
+
+Self::Item* Self::findItem(const QString& path) const {
+    for (auto&& topItem : rootItem_->children) {
+        if (path == topItem->path) {
+            return topItem.get();
+        }
+        auto prefix = topItem->path + '/';
+        if (not path.startsWith(prefix)) {
+            continue;
+        }
+        auto components =
+            path.mid(prefix.size()).split('/', QString::SkipEmptyParts);
+        auto item = topItem.get();
+        for (auto&& component : components) {
+            if (not item->fetched) {
+                return nullptr;
+            }
+            Item* nextItem = nullptr;
+            for (auto&& child : item->children) {
+                if (child->kind != Item::Kind::SpriteFrame &&
+                    child->name == component) {
+                    nextItem = child.get();
+                    break;
+                }
+            }
+            if (nextItem == nullptr) {
+                return nullptr;
+            }
+            item = nextItem;
+        }
+        return item;
+    }
+    return nullptr;
+}
+
+std::vector<std::unique_ptr<Self::Item>> Self::listChildren(Item* item) const {
+    std::vector<std::unique_ptr<Item>> children;
+    if (item->kind == Item::Kind::Directory) {
+        QDir dir(item->path);
+        for (auto&& info : dir.entryInfoList(QDir::Filter::NoDotAndDotDot |
+                                             QDir::Filter::AllEntries)) {
+            auto kind = Item::Kind::File;
+            if (info.isDir()) {
+                kind = Item::Kind::Directory;
+            } else if (FileClassifier(info).isSpriteSheet()) {
+                kind = Item::Kind::SpriteSheet;
+            }
+            children.push_back(std::make_unique<Item>(
+                kind, info.fileName(), info.absoluteFilePath(), item));
+        }
+    }
+    if (item->kind == Item::Kind::SpriteSheet) {
+        auto&& resources = ProjectResources::getInstance();
+        for (auto&& frame : resources.getSpriteFrames(item->path)) {
+            children.push_back(std::make_unique<Item>(
+                Item::Kind::SpriteFrame, frame, item->path, item));
+        }
+    }
+    return children;
+}
+
+void Self::updateItem(Item* item) {
+    if (not item->fetched) {
+        return;
+    }
+    auto parentIndex = getIndex(item);
+    auto newChildren = listChildren(item);
+    auto&& children = item->children;
+
+    QSet<QString> names;
+    for (auto&& child : newChildren) {
+        names.insert(child->name);
+    }
+    for (auto i = static_cast<int>(children.size()) - 1; i >= 0; --i) {
+        if (names.contains(children[i]->name)) {
+            continue;
+        }
+        beginRemoveRows(parentIndex, i, i);
+        children.erase(children.begin() + i);
+        endRemoveRows();
+    }
+
+    // Both lists are sorted the same way, the remaining children are in
+    // place once the new ones are inserted.
+    for (std::size_t i = 0; i < newChildren.size(); ++i) {
+        auto row = static_cast<int>(i);
+        auto&& newChild = newChildren[i];
+        if (i < children.size() && children[i]->name == newChild->name) {
+            if (children[i]->kind == newChild->kind) {
+                if (children[i]->kind == Item::Kind::SpriteSheet) {
+                    // May have been modified.
+                    updateItem(children[i].get());
+                }
+                continue;
+            }
+            beginRemoveRows(parentIndex, row, row);
+            children.erase(children.begin() + row);
+            endRemoveRows();
+        }
+        beginInsertRows(parentIndex, row, row);
+        children.insert(children.begin() + row, std::move(newChild));
+        endInsertRows();
+    }
+}
+
+void Self::refreshItem(Item* item) {
+    updateItem(item);
+    for (auto&& child : item->children) {
+        if (child->kind == Item::Kind::Directory) {
+            refreshItem(child.get());
+        }
+    }
+}
+
+QString Self::getRelativePath(const Item* item) const {
+    QStringList components;
+    while (item->parent != rootItem_.get()) {
+        components << item->name;
+        item = item->parent;
+    }
+    std::reverse(components.begin(), components.end());
+    return components.join(QDir::separator());
+}
+
+QVariant Self::data(const QModelIndex& index, int role) const {
+    if (not index.isValid()) {
+        return QVariant();
+    }
+    if (role != Qt::ItemDataRole::DisplayRole) {
+        return QVariant();
+    }
+    return getItem(index)->name;
+}
+
+QModelIndex Self::index(int row, int column, const QModelIndex& parent) const {
+    if (not hasIndex(row, column, parent)) {
+        return QModelIndex();
+    }
+    auto parentItem = getItem(parent);
+    auto&& childItem = parentItem->children.at(static_cast<std::size_t>(row));
+    return createIndex(row, column, childItem.get());
+}
+
+QModelIndex Self::parent(const QModelIndex& index) const {
+    if (not index.isValid()) {
+        return QModelIndex();
+    }
+    return getIndex(getItem(index)->parent);
+}
+
+int Self::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) {
+        return 0;
+    }
+    return static_cast<int>(getItem(parent)->children.size());
+}
+
+int Self::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool Self::hasChildren(const QModelIndex& parent) const {
+    auto item = getItem(parent);
+    if (not item->fetched) {
+        // Assumed until listed.
+        return item->isExpandable();
+    }
+    return not item->children.empty();
+}
+
+bool Self::canFetchMore(const QModelIndex& parent) const {
+    auto item = getItem(parent);
+    return item->isExpandable() && not item->fetched;
+}
+
+void Self::fetchMore(const QModelIndex& parent) {
+    auto item = getItem(parent);
+    if (item->fetched) {
+        return;
+    }
+    auto children = listChildren(item);
+    item->fetched = true;
+    if (children.empty()) {
+        return;
+    }
+    beginInsertRows(parent, 0, static_cast<int>(children.size()) - 1);
+    item->children = std::move(children);
+    endInsertRows();
+}
+
+Qt::ItemFlags Self::flags(const QModelIndex& index) const {
+    QFlags<Qt::ItemFlag> flags;
+    if (not index.isValid()) {
+        return flags;
+    }
+    flags |= Qt::ItemFlag::ItemIsSelectable;
+    flags |= Qt::ItemFlag::ItemIsDragEnabled;
+    flags |= Qt::ItemFlag::ItemIsEnabled;
+    return flags;
+}
+
+QStringList Self::mimeTypes() const {
+    QStringList types;
+    types << "ee-editor/resources–path";
+    return types;
+}
+
+QMimeData* Self::mimeData(const QModelIndexList& indexes) const {
+    Q_ASSERT(indexes.size() > 0);
+    auto path = getRelativePath(getItem(indexes.front()));
+    auto data = new QMimeData();
+    data->setData(mimeTypes().at(0), path.toUtf8());
+    return data;
+}
+} // namespace ee
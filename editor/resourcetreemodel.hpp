@@ -0,0 +1,110 @@
+#ifndef EE_EDITOR_RESOURCE_TREE_MODEL_HPP
+#define EE_EDITOR_RESOURCE_TREE_MODEL_HPP
+
+#include <memory>
+#include <vector>
+
+#include <QAbstractItemModel>
+#include <QDir>
+#include <QVector>
+
+namespace ee {
+/// Files of the resource directories and frames of the sprite sheets.
+/// Directories and sprite sheets are only listed once expanded, changes on
+/// disk are applied to the listed items as row insertions and removals.
+class ResourceTreeModel : public QAbstractItemModel {
+private:
+    using Self = ResourceTreeModel;
+    using Super = QAbstractItemModel;
+
+public:
+    explicit ResourceTreeModel(QObject* parent = nullptr);
+
+    virtual ~ResourceTreeModel() override;
+
+    /// Sets the top-level directories, the listed items are kept if the
+    /// directories are unchanged.
+    void setDirectories(const QVector<QDir>& directories);
+
+    /// Applies the changes of the specified file or directory, which may
+    /// have been added, removed or modified. Does nothing if its directory
+    /// is not listed yet.
+    void updatePath(const QString& path);
+
+    /// Lists all the listed directories and sprite sheets again, e.g. when
+    /// changes were lost.
+    void refresh();
+
+    /// Gets the model index of the specified file or directory.
+    /// @return An invalid index if it is not listed.
+    QModelIndex findIndex(const QString& path) const;
+
+    /// Gets the absolute path of the file or directory at the specified
+    /// index, sprite frames have the path of their sprite sheet.
+    QString getFilePath(const QModelIndex& index) const;
+
+    bool isSpriteFrame(const QModelIndex& index) const;
+
+    /// @see Super.
+    virtual QVariant data(const QModelIndex& index, int role) const override;
+
+    /// @see Super.
+    virtual QModelIndex
+    index(int row, int column,
+          const QModelIndex& parent = QModelIndex()) const override;
+
+    /// @see Super.
+    virtual QModelIndex parent(const QModelIndex& index) const override;
+
+    /// @see Super.
+    virtual int
+    rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /// @see Super.
+    virtual int
+    columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /// @see Super.
+    virtual bool
+    hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+
+    /// @see Super.
+    virtual bool canFetchMore(const QModelIndex& parent) const override;
+
+    /// @see Super.
+    virtual void fetchMore(const QModelIndex& parent) override;
+
+    /// @see Super.
+    virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /// @see Super.
+    virtual QStringList mimeTypes() const override;
+
+    /// @see Super.
+    virtual QMimeData* mimeData(const QModelIndexList& indexes) const override;
+
+private:
+    struct Item;
+
+    Item* getItem(const QModelIndex& index) const;
+    QModelIndex getIndex(const Item* item) const;
+    Item* findItem(const QString& path) const;
+
+    /// Lists the children of the specified item.
+    std::vector<std::unique_ptr<Item>> listChildren(Item* item) const;
+
+    /// Replaces the rows of the specified item which are not in the listed
+    /// children, then recursively updates the listed sub-items.
+    void updateItem(Item* item);
+
+    /// Updates the specified item and its listed sub-directories.
+    void refreshItem(Item* item);
+
+    /// Path relative to the top-level directory, used for dragging.
+    QString getRelativePath(const Item* item) const;
+
+    std::unique_ptr<Item> rootItem_;
+};
+} // namespace ee
+
+#endif // EE_EDITOR_RESOURCE_TREE_MODEL_HPP
@@ -1,10 +1,15 @@
 #ifndef EE_EDITOR_MAIN_SCENE_HPP
 #define EE_EDITOR_MAIN_SCENE_HPP
 
+#include "inspectors/inspector.hpp"
+
 #include <QObject>
 
 namespace ee {
 class NodeGraph;
+class NodeGraphDiff;
+class PropertyHandler;
+class SelectionPath;
 class SelectionTree;
 
 class MainScene : public QObject {
@@ -18,12 +23,33 @@ public:
     /// @param graph The desired node graph.
     virtual void setNodeGraph(const NodeGraph& graph) = 0;
 
+    /// Incrementally updates the current node graph.
+    /// @param diff The changes from the current node graph.
+    virtual void applyDiff(const NodeGraphDiff& diff) = 0;
+
+    /// Replaces the current node graph without reloading the nodes, which
+    /// must already match it, e.g. after applyProperties.
+    /// @param graph The desired node graph.
+    virtual void updateNodeGraph(const NodeGraph& graph) = 0;
+
+    /// Applies the specified applier to the node at the specified path.
+    /// @param handler The properties of the node, receives the properties
+    /// changed by the applier.
+    /// @return Whether the applier succeeded.
+    virtual bool applyProperties(const SelectionPath& path,
+                                 const Inspector::Applier& applier,
+                                 PropertyHandler& handler) = 0;
+
     /// Sets the selection.
     /// @param selection The desired selection.
     virtual void selectTree(const SelectionTree& selection) = 0;
 
 Q_SIGNALS:
     void selectionTreeChanged(const SelectionTree& selection);
+
+    /// Occurs when the user has modified the selected nodes in the scene,
+    /// e.g. by dragging the gizmo.
+    void propertyChanged(const Inspector::Applier& applier);
 };
 } // namespace ee
 
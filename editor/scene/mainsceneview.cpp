@@ -2,6 +2,7 @@
 
 #include "config.hpp"
 #include "gizmo.hpp"
+#include "interfacesettings.hpp"
 #include "mainsceneview.hpp"
 #include "nodehighlighterlayer.hpp"
 #include "rulerview.hpp"
@@ -10,7 +11,10 @@
 #include "utils.hpp"
 
 #include <parser/graphreader.hpp>
+#include <parser/loadplan.hpp>
 #include <parser/nodegraph.hpp>
+#include <parser/nodegraphdiff.hpp>
+#include <parser/nodeinfo.hpp>
 #include <parser/nodeloader.hpp>
 #include <parser/nodeloaderlibrary.hpp>
 #include <parser/propertyhandler.hpp>
@@ -30,6 +34,26 @@
 #include <QDebug>
 
 namespace ee {
+namespace {
+/// Inserts a child before the specified index.
+void insertChild(cocos2d::Node* parent, cocos2d::Node* child,
+                 std::size_t index) {
+    // cocos2d only appends children, re-append the following siblings.
+    cocos2d::Vector<cocos2d::Node*> siblings;
+    auto&& children = parent->getChildren();
+    for (auto i = index; i < static_cast<std::size_t>(children.size()); ++i) {
+        siblings.pushBack(children.at(static_cast<ssize_t>(i)));
+    }
+    for (auto&& sibling : siblings) {
+        parent->removeChild(sibling, false);
+    }
+    parent->addChild(child);
+    for (auto&& sibling : siblings) {
+        parent->addChild(sibling);
+    }
+}
+} // namespace
+
 using Self = MainSceneView;
 
 Self* Self::create() {
@@ -57,6 +81,11 @@ bool Self::init() {
                      ->setRegion(_director->getWinSize());
     addChild(rulerView_, +1);
 
+    // Kept across graphs so that compiled load plans are reused.
+    reader_ = std::make_unique<GraphReader>();
+    reader_->setPrefabLoader(&InterfaceSettings::readPrefab);
+    rootNode_ = nullptr;
+
     originNode_ = cocos2d::Node::create();
     addChild(originNode_, +2);
 
@@ -165,14 +194,135 @@ void Self::setNodeGraph(const NodeGraph& graph) {
         rootNode_->removeFromParentAndCleanup(true);
     }
 
-    auto library = NodeLoaderLibrary();
-    library.addDefaultLoaders();
-
-    GraphReader reader(library);
-    rootNode_ = reader.readNodeGraph(graph);
+    // Prefab files may have been edited since the last full reload.
+    reader_->clearPrefabs();
+    auto prepared = reader_->prepare(graph);
+    rootNode_ = reader_->instantiate(prepared);
     originNode_->addChild(rootNode_);
 }
 
+void Self::applyDiff(const NodeGraphDiff& diff) {
+    Q_ASSERT(nodeGraph_ != nullptr);
+    Q_ASSERT(rootNode_ != nullptr);
+    diff.apply(*nodeGraph_);
+
+    using Kind = NodeGraphDiff::Kind;
+    auto&& operations = diff.getOperations();
+    for (std::size_t i = 0; i < operations.size();) {
+        auto&& operation = operations[i];
+        switch (operation.kind) {
+        case Kind::SetProperty:
+        case Kind::RemoveProperty: {
+            // Reload all the consecutive changes of a node at once so that
+            // its loader commits once.
+            std::vector<Symbol> keys;
+            std::vector<Symbol> removedKeys;
+            auto j = i;
+            for (; j < operations.size(); ++j) {
+                auto&& other = operations[j];
+                if (other.path != operation.path) {
+                    break;
+                }
+                if (other.kind == Kind::SetProperty) {
+                    keys.push_back(other.key);
+                } else if (other.kind == Kind::RemoveProperty) {
+                    keys.push_back(other.key);
+                    removedKeys.push_back(other.key);
+                } else {
+                    break;
+                }
+            }
+            reloadProperties(operation.path, keys, removedKeys);
+            i = j;
+            continue;
+        }
+        case Kind::InsertChild: {
+            auto prepared = reader_->prepare(*operation.graph);
+            auto child = reader_->instantiate(prepared);
+            insertChild(findNode(operation.path), child, operation.index);
+            break;
+        }
+        case Kind::RemoveChild: {
+            auto parent = findNode(operation.path);
+            auto child =
+                parent->getChildren().at(static_cast<ssize_t>(operation.index));
+            child->removeFromParentAndCleanup(true);
+            break;
+        }
+        case Kind::Replace:
+            Q_ASSERT(operation.path.empty());
+            setNodeGraph(*operation.graph);
+            break;
+        }
+        ++i;
+    }
+}
+
+void Self::reloadProperties(const std::vector<std::size_t>& path,
+                            const std::vector<Symbol>& keys,
+                            const std::vector<Symbol>& removedKeys) {
+    const NodeGraph* graph = nodeGraph_.get();
+    for (auto&& index : path) {
+        graph = &graph->getChild(index);
+    }
+    auto&& handler = graph->getPropertyHandler();
+    auto&& plan = reader_->getLoadPlan(handler);
+    auto node = findNode(path);
+    if (removedKeys.empty()) {
+        plan.execute(node, handler, keys);
+        return;
+    }
+    // Removed properties fall back to their default values.
+    auto properties = handler;
+    auto&& defaults = plan.getDefaults();
+    for (auto&& key : removedKeys) {
+        auto value = defaults.findProperty(key);
+        if (value != nullptr) {
+            properties.setProperty(key, *value);
+        }
+    }
+    plan.execute(node, properties, keys);
+}
+
+void Self::updateNodeGraph(const NodeGraph& graph) {
+    Q_ASSERT(nodeGraph_ != nullptr);
+    *nodeGraph_ = graph;
+}
+
+bool Self::applyProperties(const SelectionPath& path,
+                           const Inspector::Applier& applier,
+                           PropertyHandler& handler) {
+    auto node = path.find(rootNode_);
+    auto&& loader = reader_->getLoadPlan(handler).getLoader();
+    PropertyHandler before;
+    loader.storeProperties(node, before);
+    if (not applier(node)) {
+        return false;
+    }
+    PropertyHandler after;
+    loader.storeProperties(node, after);
+
+    // Only keep the changed properties, unchanged defaults are not added to
+    // the node graph.
+    auto&& keys = after.getPropertyKeys();
+    auto&& values = after.getPropertyValues();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto value = before.findProperty(keys[i]);
+        if (value == nullptr || *value != values[i]) {
+            handler.setProperty(keys[i], values[i]);
+        }
+    }
+    return true;
+}
+
+cocos2d::Node* Self::findNode(const std::vector<std::size_t>& path) const {
+    auto node = rootNode_;
+    for (auto&& index : path) {
+        node = node->getChildren().at(static_cast<ssize_t>(index));
+    }
+    return node;
+}
+
 void Self::selectTree(const SelectionTree& selection) {
     qDebug() << Q_FUNC_INFO;
     selection_ = std::make_unique<SelectionTree>(selection);
@@ -187,9 +337,8 @@ void Self::moveSelectionBy(const cocos2d::Vec2& delta) {
                                   static_cast<double>(delta.x),
                                   static_cast<double>(delta.y));
     Q_ASSERT(not selection_->isEmpty());
-    auto&& paths = selection_->getPaths();
-    for (auto&& path : paths) {
-        auto node = path.find(rootNode_);
+    // Recorded by the scene manager like any other property change.
+    Q_EMIT propertyChanged([delta](cocos2d::Node* node) {
         auto worldPosition =
             node->isIgnoreAnchorPointForPosition()
                 ? node->convertToWorldSpace(cocos2d::Point::ZERO)
@@ -199,17 +348,8 @@ void Self::moveSelectionBy(const cocos2d::Vec2& delta) {
         auto newPosition =
             node->getParent()->convertToNodeSpace(newWorldPosition);
         node->setPosition(newPosition);
-        /*
-        Q_EMIT propertyValueChanged(
-            path,
-            QString::fromStdString(NodeLoader::Property::Position.nameX()),
-            cocos2d::Value(newPosition.x));
-        Q_EMIT propertyValueChanged(
-            path,
-            QString::fromStdString(NodeLoader::Property::Position.nameY()),
-            cocos2d::Value(newPosition.y));
-            */
-    }
+        return true;
+    });
 }
 
 /*
@@ -272,12 +412,14 @@ doRecursively(cocos2d::Node* node,
 
 cocos2d::Node* findCapturedNode(cocos2d::Node* rootNode,
                                 const cocos2d::Point& position) {
-    return doRecursively(rootNode, [position](cocos2d::Node* node) {
+    auto node = doRecursively(rootNode, [position](cocos2d::Node* node) {
         auto box = cocos2d::Rect(0, 0, node->getContentSize().width,
                                  node->getContentSize().height);
         auto localPosition = node->convertToNodeSpace(position);
         return box.containsPoint(localPosition);
     });
+    // Children of prefab instances are captured as their instance.
+    return NodeInfo::getGraphNode(node);
 }
 } // namespace
 
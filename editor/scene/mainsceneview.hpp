@@ -5,8 +5,10 @@
 #include "selection/selectionpath.hpp"
 #include "selection/selectiontree.hpp"
 
+#include <parser/graphreader.hpp>
 #include <parser/nodegraph.hpp>
 #include <parser/parserfwd.hpp>
+#include <parser/symbol.hpp>
 
 #include <2d/CCLayer.h>
 #include <2d/CCScene.h>
@@ -46,6 +48,17 @@ public:
     /// @see Super.
     virtual void setNodeGraph(const NodeGraph& graph) override;
 
+    /// @see Super.
+    virtual void applyDiff(const NodeGraphDiff& diff) override;
+
+    /// @see Super.
+    virtual void updateNodeGraph(const NodeGraph& graph) override;
+
+    /// @see Super.
+    virtual bool applyProperties(const SelectionPath& path,
+                                 const Inspector::Applier& applier,
+                                 PropertyHandler& handler) override;
+
     /// @see Super.
     virtual void selectTree(const SelectionTree& selection) override;
 
@@ -83,9 +96,22 @@ private:
 
     void updateWindowSize();
 
+    /// Reloads the specified keys of the node at the specified path.
+    /// @param removedKeys Keys removed from the node graph, reset to the
+    /// default values.
+    void reloadProperties(const std::vector<std::size_t>& path,
+                          const std::vector<Symbol>& keys,
+                          const std::vector<Symbol>& removedKeys);
+
+    /// Finds the live node at the specified path.
+    cocos2d::Node* findNode(const std::vector<std::size_t>& path) const;
+
     /// Current node graph.
     std::unique_ptr<NodeGraph> nodeGraph_;
 
+    /// Builds nodes from node graphs.
+    std::unique_ptr<GraphReader> reader_;
+
     /// Current selection.
     std::unique_ptr<SelectionTree> selection_;
 
@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <utility>
+
 #include "scenemanager.hpp"
+#include "history/history.hpp"
 #include "inspectors/inspectorlist.hpp"
 #include "inspectors/inspectorloaderlibrary.hpp"
 #include "scene/mainscene.hpp"
@@ -7,8 +11,21 @@
 #include "selection/selectiontree.hpp"
 
 #include <parser/nodegraph.hpp>
+#include <parser/nodegraphdiff.hpp>
 
 namespace ee {
+namespace {
+bool hasStructuralChanges(const NodeGraphDiff& diff) {
+    using Kind = NodeGraphDiff::Kind;
+    auto&& operations = diff.getOperations();
+    return std::any_of(operations.cbegin(), operations.cend(),
+                       [](const NodeGraphDiff::Operation& operation) {
+                           return operation.kind != Kind::SetProperty &&
+                                  operation.kind != Kind::RemoveProperty;
+                       });
+}
+} // namespace
+
 using Self = SceneManager;
 
 Self::SceneManager(MainScene* mainScene, SceneTree* sceneTree,
@@ -18,14 +35,77 @@ Self::SceneManager(MainScene* mainScene, SceneTree* sceneTree,
     , inspectorList_(inspectorList) {
     inspectorLoaderLibrary_ = std::make_unique<InspectorLoaderLibrary>();
     inspectorLoaderLibrary_->addDefaultLoaders();
+    history_ = std::make_unique<History>();
 }
 
 Self::~SceneManager() {}
 
 void Self::setNodeGraph(const NodeGraph& graph) {
-    nodeGraph_ = std::make_unique<NodeGraph>(graph);
-    mainScene_->setNodeGraph(*nodeGraph_);
-    sceneTree_->setNodeGraph(*nodeGraph_);
+    history_->clear();
+    if (nodeGraph_ == nullptr) {
+        nodeGraph_ = std::make_unique<NodeGraph>(graph);
+        mainScene_->setNodeGraph(*nodeGraph_);
+        sceneTree_->setNodeGraph(*nodeGraph_);
+        return;
+    }
+    applyDiff(NodeGraphDiff::compute(*nodeGraph_, graph));
+}
+
+void Self::undo() {
+    auto diff = history_->undo();
+    if (diff != nullptr) {
+        applyDiff(*diff);
+    }
+}
+
+void Self::redo() {
+    auto diff = history_->redo();
+    if (diff != nullptr) {
+        applyDiff(*diff);
+    }
+}
+
+History& Self::getHistory() {
+    return *history_;
+}
+
+void Self::applyDiff(const NodeGraphDiff& diff) {
+    if (diff.isEmpty()) {
+        return;
+    }
+    diff.apply(*nodeGraph_);
+    if (hasStructuralChanges(diff)) {
+        // Selection paths may no longer be valid.
+        auto selection = SelectionTree::emptySelection();
+        selectionTree_ = std::make_unique<SelectionTree>(selection);
+        mainScene_->selectTree(selection);
+        sceneTree_->selectTree(selection);
+        updateInspectors(selection);
+    }
+    mainScene_->applyDiff(diff);
+    sceneTree_->applyDiff(diff);
+}
+
+void Self::applyProperties(const Inspector::Applier& applier) {
+    if (nodeGraph_ == nullptr || selectionTree_ == nullptr) {
+        return;
+    }
+    // Constant time snapshot, only the edited paths are copied.
+    auto graph = *nodeGraph_;
+    for (auto&& path : selectionTree_->getPaths()) {
+        auto&& handler = path.find(graph).getPropertyHandler();
+        mainScene_->applyProperties(path, applier, handler);
+    }
+    auto forward = NodeGraphDiff::compute(*nodeGraph_, graph);
+    if (forward.isEmpty()) {
+        return;
+    }
+    history_->push(forward, NodeGraphDiff::compute(graph, *nodeGraph_));
+
+    // The live nodes are already up to date, only the snapshots are replaced.
+    // The scene tree does not show properties.
+    *nodeGraph_ = graph;
+    mainScene_->updateNodeGraph(graph);
 }
 
 void Self::connect() {
@@ -35,6 +115,7 @@ void Self::connect() {
         sceneTree_, &SceneTree::selectionTreeChanged,
         [this](const SelectionTree& selectionTree) {
             selectionTree_ = std::make_unique<SelectionTree>(selectionTree);
+            history_->seal();
             mainScene_->selectTree(selectionTree);
             updateInspectors(selectionTree);
         });
@@ -43,6 +124,7 @@ void Self::connect() {
         mainScene_, &MainScene::selectionTreeChanged,
         [this](const SelectionTree& selectionTree) {
             selectionTree_ = std::make_unique<SelectionTree>(selectionTree);
+            history_->seal();
             sceneTree_->selectTree(selectionTree);
             updateInspectors(selectionTree);
         });
@@ -50,7 +132,13 @@ void Self::connect() {
     connections_ << QObject::connect(
         inspectorList_, &InspectorList::propertyChanged,
         [this](const Inspector::Applier& applier) { //
-            //
+            applyProperties(applier);
+        });
+
+    connections_ << QObject::connect(
+        mainScene_, &MainScene::propertyChanged,
+        [this](const Inspector::Applier& applier) { //
+            applyProperties(applier);
         });
 }
 
@@ -68,7 +156,7 @@ void Self::updateInspectors(const SelectionTree& selectionTree) {
     } else {
         QVector<QString> names;
         for (auto&& path : selectionTree.getPaths()) {
-            auto&& graph = path.find(*nodeGraph_);
+            auto&& graph = path.find(std::as_const(*nodeGraph_));
             auto name = QString::fromStdString(graph.getBaseClass());
             names.append(name);
         }
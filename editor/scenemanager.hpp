@@ -3,8 +3,12 @@
 
 #include <QList>
 
+#include "inspectors/inspector.hpp"
+
 namespace ee {
+class History;
 class NodeGraph;
+class NodeGraphDiff;
 class SelectionTree;
 class MainScene;
 class SceneTree;
@@ -22,18 +26,37 @@ public:
 
     ~SceneManager();
 
+    /// Sets the node graph, only the differences from the current node
+    /// graph are applied to the scene and the scene tree.
+    /// Clears the history.
     void setNodeGraph(const NodeGraph& graph);
 
+    /// Reverts the latest recorded change.
+    void undo();
+
+    /// Reapplies the latest reverted change.
+    void redo();
+
+    History& getHistory();
+
     void connect();
     void disconnect();
 
 protected:
     void updateInspectors(const SelectionTree& selectionTree);
 
+    /// Applies the specified diff to the node graph and the views.
+    void applyDiff(const NodeGraphDiff& diff);
+
+    /// Applies the specified applier to the selected nodes and records the
+    /// changed properties.
+    void applyProperties(const Inspector::Applier& applier);
+
 private:
     std::unique_ptr<NodeGraph> nodeGraph_;
     std::unique_ptr<SelectionTree> selectionTree_;
     std::unique_ptr<InspectorLoaderLibrary> inspectorLoaderLibrary_;
+    std::unique_ptr<History> history_;
     MainScene* mainScene_;
     SceneTree* sceneTree_;
     InspectorList* inspectorList_;
@@ -5,6 +5,7 @@
 
 namespace ee {
 class NodeGraph;
+class NodeGraphDiff;
 class SelectionTree;
 
 class SceneTree : public QTreeView {
@@ -23,6 +24,10 @@ public:
     /// @param graph The desired node graph.
     virtual void setNodeGraph(const NodeGraph& graph) = 0;
 
+    /// Incrementally updates the current node graph.
+    /// @param diff The changes from the current node graph.
+    virtual void applyDiff(const NodeGraphDiff& diff) = 0;
+
     /// Manually selects nodes in the scene tree.
     virtual void selectTree(const SelectionTree& selectionTree) = 0;
 
@@ -44,6 +44,16 @@ void Self::addChild(std::unique_ptr<Self> child) {
     children_.push_back(std::move(child));
 }
 
+void Self::insertChild(int row, std::unique_ptr<Self> child) {
+    Q_ASSERT(0 <= row && row <= childCount());
+    children_.insert(children_.begin() + row, std::move(child));
+}
+
+void Self::removeChild(int row) {
+    Q_ASSERT(0 <= row && row < childCount());
+    children_.erase(children_.begin() + row);
+}
+
 int Self::columnCount() const {
     return 1;
 }
@@ -37,6 +37,12 @@ public:
     /// Adds the specified child to this item.
     void addChild(std::unique_ptr<Self> child);
 
+    /// Inserts the specified child before the specified row.
+    void insertChild(int row, std::unique_ptr<Self> child);
+
+    /// Removes the child at the specified row.
+    void removeChild(int row);
+
     int columnCount() const;
     QVariant data(int column) const;
 
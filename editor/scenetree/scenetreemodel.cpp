@@ -4,6 +4,7 @@
 #include "scenetreemodel.hpp"
 
 #include <parser/nodegraph.hpp>
+#include <parser/nodegraphdiff.hpp>
 
 namespace ee {
 using Self = SceneTreeModel;
@@ -20,6 +21,50 @@ void Self::setNodeGraph(const NodeGraph& graph) {
     rootItem_->addChild(std::move(node));
 }
 
+void Self::applyDiff(const NodeGraphDiff& diff) {
+    using Kind = NodeGraphDiff::Kind;
+    for (auto&& operation : diff.getOperations()) {
+        switch (operation.kind) {
+        case Kind::SetProperty:
+        case Kind::RemoveProperty:
+            break;
+        case Kind::InsertChild: {
+            auto parentIndex = getIndex(operation.path);
+            auto parentItem = getTreeItem(parentIndex);
+            auto row = static_cast<int>(operation.index);
+            auto childItem = SceneTreeItem::createChildItem(parentItem);
+            setupTree(childItem.get(), *operation.graph);
+            beginInsertRows(parentIndex, row, row);
+            parentItem->insertChild(row, std::move(childItem));
+            endInsertRows();
+            break;
+        }
+        case Kind::RemoveChild: {
+            auto parentIndex = getIndex(operation.path);
+            auto row = static_cast<int>(operation.index);
+            beginRemoveRows(parentIndex, row, row);
+            getTreeItem(parentIndex)->removeChild(row);
+            endRemoveRows();
+            break;
+        }
+        case Kind::Replace:
+            Q_ASSERT(operation.path.empty());
+            beginResetModel();
+            setNodeGraph(*operation.graph);
+            endResetModel();
+            break;
+        }
+    }
+}
+
+QModelIndex Self::getIndex(const std::vector<std::size_t>& path) const {
+    auto modelIndex = rootIndex();
+    for (auto&& row : path) {
+        modelIndex = index(static_cast<int>(row), 0, modelIndex);
+    }
+    return modelIndex;
+}
+
 void Self::setupTree(SceneTreeItem* item, const NodeGraph& graph) {
     for (auto&& child : graph.getChildren()) {
         auto childItem = SceneTreeItem::createChildItem(item);
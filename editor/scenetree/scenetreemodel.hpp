@@ -7,6 +7,7 @@
 
 namespace ee {
 class NodeGraph;
+class NodeGraphDiff;
 class SceneTreeItem;
 
 class SceneTreeModel : public QAbstractItemModel {
@@ -23,6 +24,10 @@ public:
     /// Sets the node graph reference.
     void setNodeGraph(const NodeGraph& graph);
 
+    /// Applies the structural operations of the specified diff, property
+    /// operations do not affect the model.
+    void applyDiff(const NodeGraphDiff& diff);
+
     QModelIndex rootIndex() const;
 
     /// @see Super.
@@ -59,6 +64,9 @@ protected:
     /// Constructs the scene tree item with the corresponding node graph.
     void setupTree(SceneTreeItem* item, const NodeGraph& graph);
 
+    /// Gets the model index of the node at the specified path.
+    QModelIndex getIndex(const std::vector<std::size_t>& path) const;
+
     /// Gets the tree item for the specified model index.
     SceneTreeItem* getTreeItem(const QModelIndex& index) const;
 
@@ -30,6 +30,10 @@ void Self::setNodeGraph(const NodeGraph& graph) {
     setModel(treeModel_.get());
 }
 
+void Self::applyDiff(const NodeGraphDiff& diff) {
+    treeModel_->applyDiff(diff);
+}
+
 SelectionTree Self::getCurrentSelection() const {
     auto selection = SelectionTree::emptySelection();
     auto modelIndices = selectedIndexes();
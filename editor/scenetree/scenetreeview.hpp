@@ -23,6 +23,9 @@ public:
     /// @see Super.
     virtual void setNodeGraph(const NodeGraph& graph) override;
 
+    /// @see Super.
+    virtual void applyDiff(const NodeGraphDiff& diff) override;
+
     /// @see Super.
     virtual void selectTree(const SelectionTree& selectionTree) override;
 
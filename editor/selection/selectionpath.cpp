@@ -4,6 +4,7 @@
 #include "selectionpath.hpp"
 
 #include <parser/nodegraph.hpp>
+#include <parser/nodeinfo.hpp>
 
 #include <2d/CCNode.h>
 
@@ -37,11 +38,12 @@ Self Self::fromIndex(const QModelIndex& index, const QModelIndex& ancestor) {
 }
 
 Self Self::fromNode(const cocos2d::Node* node, const cocos2d::Node* ancestor) {
-    if (node == ancestor) {
+    // Children of prefab instances are not in the node graph.
+    auto currentNode = NodeInfo::getGraphNode(node);
+    if (currentNode == ancestor) {
         return selectRoot();
     }
     QVector<int> indices;
-    auto currentNode = node;
     while (currentNode != ancestor) {
         auto&& parent = currentNode->getParent();
         auto&& children = parent->getChildren();
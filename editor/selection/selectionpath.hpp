@@ -32,6 +32,7 @@ public:
                           const QModelIndex& ancestor = QModelIndex());
 
     /// Creates a selection from the specified node and its ancestor.
+    /// Children of prefab instances select their instance.
     static Self fromNode(const cocos2d::Node* node,
                          const cocos2d::Node* ancestor);
 
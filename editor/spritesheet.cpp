@@ -1,24 +1,19 @@
-#include "spritesheet.hpp"
-#include "utils.hpp"
+#include <algorithm>
 
-#include <qtplist/plistparser.h>
+#include "spritesheet.hpp"
 
-#include <QBuffer>
-#include <QJsonObject>
+#include <platform/qt/CCPlistParser_Qt.hpp>
 
 namespace ee {
 using Self = SpriteSheet;
 
-Self::SpriteSheet(const QString& content) {
-    auto array = content.toUtf8();
-    QBuffer buffer(&array);
-    auto variant = PListParser::parsePList(&buffer);
-    auto json = QJsonValue::fromVariant(variant);
-
-    auto dict = json.toObject();
-    auto frames = dict.value("frames").toObject();
-    for (auto&& frame : frames.keys()) {
-        frames_.append(frame);
+Self::SpriteSheet(const QByteArray& content) {
+    auto names = cocos2d::PlistParser::parseFrameNames(
+        content.constData(), static_cast<std::size_t>(content.size()));
+    std::sort(names.begin(), names.end());
+    frames_.reserve(static_cast<int>(names.size()));
+    for (auto&& name : names) {
+        frames_.append(QString::fromStdString(name));
     }
 }
 
@@ -1,6 +1,7 @@
 #ifndef EE_EDITOR_SPRITE_SHEET_HPP
 #define EE_EDITOR_SPRITE_SHEET_HPP
 
+#include <QByteArray>
 #include <QString>
 #include <QVector>
 
@@ -10,8 +11,10 @@ private:
     using Self = SpriteSheet;
 
 public:
-    explicit SpriteSheet(const QString& content);
+    /// Reads the frame names of the specified property list.
+    explicit SpriteSheet(const QByteArray& content);
 
+    /// Gets the frame names, sorted.
     const QVector<QString>& getFrames() const;
 
 private:
@@ -74,6 +74,9 @@ QJsonValue convertToJson(const Value& value) {
         }
         return dict;
     }
+    if (value.isPacked()) {
+        return convertToJson(Value(value.toTagged()));
+    }
     Q_ASSERT(false);
     return QJsonValue::Null;
 }
@@ -98,7 +101,7 @@ Value convertToValue(const QJsonValue& json) {
         for (auto v : json.toArray()) {
             array.push_back(convertToValue(v));
         }
-        return Value(array);
+        return Value(std::move(array));
     }
     if (json.isObject()) {
         ValueMap dict;
@@ -107,7 +110,11 @@ Value convertToValue(const QJsonValue& json) {
             dict.emplace(iter.key().toStdString(),
                          convertToValue(iter.value()));
         }
-        return Value(dict);
+        auto packed = Value::fromTagged(dict);
+        if (packed.has_value()) {
+            return std::move(packed.value());
+        }
+        return Value(std::move(dict));
     }
     Q_ASSERT(false);
     return Value::Null;
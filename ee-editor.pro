@@ -17,13 +17,22 @@ SUBDIRS = \
     qtplist \
     cocos2d \
     parser \
+    benchmark \
+    test \
+    compiler \
     editor
 
 qtplist.subdir = libraries/qtplist
 cocos2d.subdir = libraries/cocos2d
 parser.subdir = libraries/parser
+benchmark.subdir = libraries/parser/benchmark
+test.subdir = libraries/parser/test
+compiler.subdir = libraries/parser/compiler
 editor.subdir = editor
 
 cocos2d.depends = qtplist
 parser.depends = cocos2d
+benchmark.depends = cocos2d parser
+test.depends = cocos2d parser
+compiler.depends = cocos2d parser
 editor.depends = cocos2d parser
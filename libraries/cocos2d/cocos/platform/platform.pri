@@ -12,6 +12,7 @@ SOURCES += \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCFileUtils_Qt.cpp \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCGLView_Qt.cpp \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCOpenGLWidget_Qt.cpp \
+    $$COCOS2DX_ROOT/cocos/platform/qt/CCPlistParser_Qt.cpp \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCUserDefault_Qt.cpp
 
 HEADERS += \
@@ -34,5 +35,6 @@ HEADERS += \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCFileUtils_Qt.hpp \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCGLView_Qt.hpp \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCOpenGLWidget_Qt.hpp \
+    $$COCOS2DX_ROOT/cocos/platform/qt/CCPlistParser_Qt.hpp \
     $$COCOS2DX_ROOT/cocos/platform/qt/CCUserDefault_Qt.hpp \
     $$COCOS2DX_ROOT/cocos/platform/win32/CCStdC-win32.h
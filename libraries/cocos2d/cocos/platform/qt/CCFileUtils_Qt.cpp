@@ -1,13 +1,15 @@
 #include <ciso646>
 
 #include "platform/qt/CCFileUtils_Qt.hpp"
+#include "platform/qt/CCPlistParser_Qt.hpp"
 
-#include <qtplist/plistparser.h>
 #include <qtplist/plistserializer.h>
 
 #include <QApplication>
 #include <QDir>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QStandardPaths>
 
 NS_CC_BEGIN
@@ -22,41 +24,6 @@ FileUtils* FileUtils::getInstance() {
 }
 
 namespace {
-cocos2d::Value convertToValue(const QJsonValue& json) {
-    if (json.isBool()) {
-        return cocos2d::Value(json.toBool());
-    }
-    if (json.isDouble()) {
-        auto v = json.toDouble();
-        constexpr auto eps = std::numeric_limits<double>::epsilon();
-        if (std::abs(int(v) - v) < eps) {
-            return cocos2d::Value(json.toInt());
-        }
-        return cocos2d::Value(static_cast<float>(json.toDouble()));
-    }
-    if (json.isString()) {
-        return cocos2d::Value(json.toString().toStdString());
-    }
-    if (json.isArray()) {
-        cocos2d::ValueVector array;
-        for (auto v : json.toArray()) {
-            array.push_back(convertToValue(v));
-        }
-        return cocos2d::Value(array);
-    }
-    if (json.isObject()) {
-        cocos2d::ValueMap dict;
-        auto obj = json.toObject();
-        for (auto iter = obj.begin(); iter != obj.end(); ++iter) {
-            dict.emplace(iter.key().toStdString(),
-                         convertToValue(iter.value()));
-        }
-        return cocos2d::Value(dict);
-    }
-    Q_ASSERT(false);
-    return cocos2d::Value::Null;
-}
-
 QJsonValue convertToJson(const cocos2d::Value& value) {
     if (value.getType() == cocos2d::Value::Type::BOOLEAN) {
         return value.asBool();
@@ -128,22 +95,28 @@ ValueMap Self::getValueMapFromFile(const std::string& filename) {
 }
 
 ValueMap Self::getValueMapFromData(const char* fileData, int fileSize) {
-    return getValueFromData(fileData, fileSize).asValueMap();
+    auto value = getValueFromData(fileData, fileSize);
+    if (value.getType() != Value::Type::MAP) {
+        return ValueMap();
+    }
+    return std::move(value.asValueMap());
 }
 
 ValueVector Self::getValueVectorFromFile(const std::string& filename) {
     Data data(getDataFromFile(filename));
-    return getValueFromData(reinterpret_cast<char*>(data.getBytes()),
-                            static_cast<int>(data.getSize()))
-        .asValueVector();
+    auto value = getValueFromData(reinterpret_cast<char*>(data.getBytes()),
+                                  static_cast<int>(data.getSize()));
+    if (value.getType() != Value::Type::VECTOR) {
+        return ValueVector();
+    }
+    return std::move(value.asValueVector());
 }
 
 Value Self::getValueFromData(const char* data, int size) {
-    QByteArray array(data, size);
-    QBuffer buffer(&array);
-    auto variant = PListParser::parsePList(&buffer);
-    auto json = QJsonValue::fromVariant(variant);
-    return convertToValue(json);
+    if (data == nullptr || size <= 0) {
+        return Value::Null;
+    }
+    return PlistParser::parse(data, static_cast<std::size_t>(size));
 }
 
 bool Self::writeToFile(const ValueMap& dict, const std::string& fullPath) {
@@ -0,0 +1,276 @@
+#include <ciso646>
+#include <cstdlib>
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+#include "platform/qt/CCPlistParser_Qt.hpp"
+
+#include "base/ccMacros.h"
+
+#include <rapidxml/rapidxml_sax3.hpp>
+
+NS_CC_BEGIN
+namespace {
+enum class Element {
+    Plist,
+    Dict,
+    Array,
+    Key,
+    String,
+    Integer,
+    Real,
+    True,
+    False,
+    Date,
+    Data,
+    Unknown,
+};
+
+template <std::size_t N>
+bool equals(const char* name, std::size_t size, const char (&literal)[N]) {
+    return size == N - 1 && std::memcmp(name, literal, size) == 0;
+}
+
+Element classify(const char* name, std::size_t size) {
+    if (equals(name, size, "key")) {
+        return Element::Key;
+    }
+    if (equals(name, size, "string")) {
+        return Element::String;
+    }
+    if (equals(name, size, "dict")) {
+        return Element::Dict;
+    }
+    if (equals(name, size, "real")) {
+        return Element::Real;
+    }
+    if (equals(name, size, "integer")) {
+        return Element::Integer;
+    }
+    if (equals(name, size, "true")) {
+        return Element::True;
+    }
+    if (equals(name, size, "false")) {
+        return Element::False;
+    }
+    if (equals(name, size, "array")) {
+        return Element::Array;
+    }
+    if (equals(name, size, "plist")) {
+        return Element::Plist;
+    }
+    if (equals(name, size, "date")) {
+        return Element::Date;
+    }
+    if (equals(name, size, "data")) {
+        return Element::Data;
+    }
+    return Element::Unknown;
+}
+
+/// Common handling of the element names and text, attributes are ignored.
+class Handler : public rapidxml::xml_sax3_handler {
+public:
+    virtual void xmlSAX3StartElement(char* name, std::size_t size) override {
+        auto element = classify(name, size);
+        text_.clear();
+        startElement(element);
+    }
+
+    virtual void xmlSAX3Attr(const char* name, std::size_t nameSize,
+                             const char* value,
+                             std::size_t valueSize) override {
+        CC_UNUSED_PARAM(name);
+        CC_UNUSED_PARAM(nameSize);
+        CC_UNUSED_PARAM(value);
+        CC_UNUSED_PARAM(valueSize);
+    }
+
+    virtual void xmlSAX3EndAttr() override {}
+
+    virtual void xmlSAX3EndElement(const char* name,
+                                   std::size_t size) override {
+        endElement(classify(name, size));
+    }
+
+    virtual void xmlSAX3Text(const char* text, std::size_t size) override {
+        text_.append(text, size);
+    }
+
+protected:
+    virtual void startElement(Element element) = 0;
+    virtual void endElement(Element element) = 0;
+
+    /// Text of the current element.
+    std::string text_;
+};
+
+/// Builds the values as the elements are read.
+class ValueBuilder : public Handler {
+public:
+    ValueBuilder() {
+        // The application locale may use decimal commas.
+        stream_.imbue(std::locale::classic());
+    }
+
+    Value& getResult() {
+        return result_;
+    }
+
+protected:
+    virtual void startElement(Element element) override {
+        if (element == Element::Dict) {
+            containers_.push_back(&insert(Value(ValueMap())));
+        } else if (element == Element::Array) {
+            containers_.push_back(&insert(Value(ValueVector())));
+        }
+    }
+
+    virtual void endElement(Element element) override {
+        switch (element) {
+        case Element::Dict:
+        case Element::Array:
+            if (not containers_.empty()) {
+                containers_.pop_back();
+            }
+            break;
+        case Element::Key:
+            key_ = std::move(text_);
+            break;
+        case Element::String:
+        case Element::Date:
+        case Element::Data:
+            insert(Value(std::move(text_)));
+            break;
+        case Element::Integer:
+            insert(Value(
+                static_cast<int>(std::strtoll(text_.c_str(), nullptr, 10))));
+            break;
+        case Element::Real:
+            insert(Value(parseReal(text_)));
+            break;
+        case Element::True:
+            insert(Value(true));
+            break;
+        case Element::False:
+            insert(Value(false));
+            break;
+        case Element::Plist:
+        case Element::Unknown:
+            break;
+        }
+    }
+
+private:
+    float parseReal(const std::string& text) {
+        stream_.clear();
+        stream_.str(text);
+        float value = 0;
+        stream_ >> value;
+        return value;
+    }
+
+    /// Adds the specified value to the current container.
+    /// Containers are stable while open since values are only ever added to
+    /// the innermost one.
+    Value& insert(Value&& value) {
+        if (containers_.empty()) {
+            result_ = std::move(value);
+            return result_;
+        }
+        auto&& container = *containers_.back();
+        if (container.getType() == Value::Type::MAP) {
+            auto&& slot = container.asValueMap()[key_];
+            slot = std::move(value);
+            return slot;
+        }
+        auto&& array = container.asValueVector();
+        array.push_back(std::move(value));
+        return array.back();
+    }
+
+    Value result_;
+    std::istringstream stream_;
+    std::vector<Value*> containers_;
+    std::string key_;
+};
+
+/// Collects the keys of the top-level frames dictionary.
+class FrameNameCollector : public Handler {
+public:
+    std::vector<std::string>& getResult() {
+        return names_;
+    }
+
+protected:
+    virtual void startElement(Element element) override {
+        if (element != Element::Dict && element != Element::Array) {
+            return;
+        }
+        ++depth_;
+        if (depth_ == 2 && element == Element::Dict && rootKey_ == "frames") {
+            inFrames_ = true;
+        }
+    }
+
+    virtual void endElement(Element element) override {
+        if (element == Element::Dict || element == Element::Array) {
+            if (depth_ == 2) {
+                inFrames_ = false;
+            }
+            --depth_;
+            return;
+        }
+        if (element != Element::Key) {
+            return;
+        }
+        if (depth_ == 1) {
+            rootKey_ = std::move(text_);
+        } else if (depth_ == 2 && inFrames_) {
+            names_.push_back(std::move(text_));
+        }
+    }
+
+private:
+    /// Number of open containers.
+    int depth_ = 0;
+    bool inFrames_ = false;
+    std::string rootKey_;
+    std::vector<std::string> names_;
+};
+
+/// Runs the handler over a copy of the data, rapidxml parses in place.
+bool parseWith(const char* data, std::size_t size, Handler& handler) {
+    std::vector<char> buffer(data, data + size);
+    buffer.push_back('\0');
+    rapidxml::xml_sax3_parser<> parser(&handler);
+    try {
+        parser.parse<>(buffer.data(), static_cast<int>(size));
+    } catch (rapidxml::parse_error& e) {
+        CCLOG("PlistParser: %s", e.what());
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+using Self = PlistParser;
+
+Value Self::parse(const char* data, std::size_t size) {
+    ValueBuilder builder;
+    if (not parseWith(data, size, builder)) {
+        return Value::Null;
+    }
+    return std::move(builder.getResult());
+}
+
+std::vector<std::string> Self::parseFrameNames(const char* data,
+                                               std::size_t size) {
+    FrameNameCollector collector;
+    if (not parseWith(data, size, collector)) {
+        return {};
+    }
+    return std::move(collector.getResult());
+}
+NS_CC_END
@@ -0,0 +1,31 @@
+#ifndef EE_EDITOR_CC_PLIST_PARSER_QT_HPP
+#define EE_EDITOR_CC_PLIST_PARSER_QT_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "base/CCValue.h"
+
+NS_CC_BEGIN
+/// Parses XML property lists in a single streaming pass.
+/// Integers are read as int and reals as float, dates and data are kept as
+/// their text.
+class PlistParser {
+private:
+    using Self = PlistParser;
+
+public:
+    /// Parses the specified property list.
+    /// @return Null if the property list is malformed.
+    static Value parse(const char* data, std::size_t size);
+
+    /// Gets the keys of the top-level frames dictionary of a sprite sheet,
+    /// in document order, without building the frame values.
+    /// @return Empty if the property list is malformed.
+    static std::vector<std::string> parseFrameNames(const char* data,
+                                                    std::size_t size);
+};
+NS_CC_END
+
+#endif // EE_EDITOR_CC_PLIST_PARSER_QT_HPP
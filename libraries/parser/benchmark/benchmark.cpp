@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <ciso646>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include "benchmark.hpp"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QSysInfo>
+
+namespace ee {
+namespace key {
+constexpr auto context = "context";
+constexpr auto benchmarks = "benchmarks";
+constexpr auto date = "date";
+constexpr auto build_type = "build_type";
+constexpr auto compiler = "compiler";
+constexpr auto cpu_architecture = "cpu_architecture";
+constexpr auto os = "os";
+constexpr auto num_cpus = "num_cpus";
+constexpr auto name = "name";
+constexpr auto iterations = "iterations";
+constexpr auto total_time_ms = "total_time_ms";
+constexpr auto time_per_iteration_ns = "time_per_iteration_ns";
+constexpr auto items_per_iteration = "items_per_iteration";
+constexpr auto items_per_second = "items_per_second";
+constexpr auto peak_memory_bytes = "peak_memory_bytes";
+} // namespace key
+
+namespace defaults {
+constexpr auto minimum_time = 200.0;
+} // namespace defaults
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double getElapsedMilliseconds(Clock::time_point start) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    return std::chrono::duration_cast<Milliseconds>(Clock::now() - start)
+        .count();
+}
+
+/// Gets the peak resident memory of the process in bytes.
+std::size_t getPeakMemory() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stoul(line.substr(6)) * 1024;
+        }
+    }
+#endif // __linux__
+    return 0;
+}
+
+/// Resets the peak resident memory to the current one.
+/// @return Whether the platform supports it.
+bool resetPeakMemory() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    return static_cast<bool>(clearRefs);
+#else  // __linux__
+    return false;
+#endif // __linux__
+}
+
+std::string getCompiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+} // namespace
+
+using Self = Benchmark;
+
+Self::Benchmark()
+    : minimumTime_(defaults::minimum_time) {}
+
+Self::~Benchmark() {}
+
+Self& Self::add(const std::string& name, Function function,
+                std::size_t items) {
+    cases_.push_back(Case{name, std::move(function), items});
+    return *this;
+}
+
+Self& Self::setMinimumTime(double milliseconds) {
+    minimumTime_ = milliseconds;
+    return *this;
+}
+
+std::vector<Self::Result> Self::run(const std::string& filter) const {
+    std::vector<Result> results;
+    for (auto&& item : cases_) {
+        if (item.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::fprintf(stderr, "%-48s", item.name.c_str());
+        std::fflush(stderr);
+        auto result = runCase(item);
+        std::fprintf(stderr, "%14.0f ns %10zu iterations\n",
+                     result.timePerIteration, result.iterations);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+Self::Result Self::runCase(const Case& item) const {
+    // Warm up, also builds the lazily prepared fixtures.
+    item.function(1);
+
+    auto canMeasureMemory = resetPeakMemory();
+    auto baseMemory = getPeakMemory();
+
+    std::size_t iterations = 1;
+    double elapsed = 0;
+    while (true) {
+        auto start = Clock::now();
+        item.function(iterations);
+        elapsed = getElapsedMilliseconds(start);
+        if (elapsed >= minimumTime_) {
+            break;
+        }
+        // Aim slightly above the minimum time, grow by at most 10x.
+        auto estimate = elapsed > 0
+                            ? minimumTime_ * 1.2 / elapsed * iterations
+                            : iterations * 10.0;
+        auto next = static_cast<std::size_t>(estimate);
+        iterations = std::min(std::max(next, iterations + 1), iterations * 10);
+    }
+
+    Result result;
+    result.name = item.name;
+    result.iterations = iterations;
+    result.totalTime = elapsed;
+    result.timePerIteration = elapsed * 1e6 / iterations;
+    result.itemsPerIteration = item.items;
+    result.peakMemory = 0;
+    if (canMeasureMemory) {
+        auto peakMemory = getPeakMemory();
+        if (peakMemory > baseMemory) {
+            result.peakMemory = peakMemory - baseMemory;
+        }
+    }
+    return result;
+}
+
+std::string Self::toJson(const std::vector<Result>& results) {
+    QJsonObject context;
+    context[key::date] =
+        QDateTime::currentDateTimeUtc().toString(Qt::DateFormat::ISODate);
+#ifdef NDEBUG
+    context[key::build_type] = "release";
+#else  // NDEBUG
+    context[key::build_type] = "debug";
+#endif // NDEBUG
+    context[key::compiler] = QString::fromStdString(getCompiler());
+    context[key::cpu_architecture] = QSysInfo::currentCpuArchitecture();
+    context[key::os] = QSysInfo::prettyProductName();
+    context[key::num_cpus] =
+        static_cast<int>(std::thread::hardware_concurrency());
+
+    QJsonArray benchmarks;
+    for (auto&& result : results) {
+        QJsonObject obj;
+        obj[key::name] = QString::fromStdString(result.name);
+        obj[key::iterations] = static_cast<double>(result.iterations);
+        obj[key::total_time_ms] = result.totalTime;
+        obj[key::time_per_iteration_ns] = result.timePerIteration;
+        obj[key::items_per_iteration] =
+            static_cast<double>(result.itemsPerIteration);
+        obj[key::items_per_second] =
+            result.itemsPerIteration * 1e9 / result.timePerIteration;
+        obj[key::peak_memory_bytes] = static_cast<double>(result.peakMemory);
+        benchmarks.append(obj);
+    }
+
+    QJsonObject json;
+    json[key::context] = context;
+    json[key::benchmarks] = benchmarks;
+    return QJsonDocument(json).toJson().toStdString();
+}
+} // namespace ee
@@ -0,0 +1,89 @@
+#ifndef EE_BENCHMARK_BENCHMARK_HPP
+#define EE_BENCHMARK_BENCHMARK_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ee {
+/// Prevents the compiler from optimizing away the computation of a value.
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/// Registry of benchmark cases, runs them and reports the results.
+class Benchmark final {
+private:
+    using Self = Benchmark;
+
+public:
+    /// Runs the measured operation the specified number of times.
+    /// Inputs should be prepared outside of this function, typically lazily
+    /// in a shared fixture, so that only the operation is timed.
+    using Function = std::function<void(std::size_t iterations)>;
+
+    struct Result {
+        std::string name;
+        std::size_t iterations;
+
+        /// Wall time of all iterations, in milliseconds.
+        double totalTime;
+
+        /// Wall time per iteration, in nanoseconds.
+        double timePerIteration;
+
+        /// Items processed per iteration, e.g. the number of nodes.
+        std::size_t itemsPerIteration;
+
+        /// Peak resident memory growth during the run in bytes, zero when
+        /// the platform does not report it.
+        std::size_t peakMemory;
+    };
+
+    Benchmark();
+    ~Benchmark();
+
+    /// Registers a benchmark case.
+    /// @param name Unique name, groups are separated by slashes.
+    /// @param items Items processed by a single iteration.
+    Self& add(const std::string& name, Function function,
+              std::size_t items = 1);
+
+    /// Sets the minimum measured time of each case, in milliseconds.
+    /// Defaults to 200 ms, single iterations longer than that run once.
+    Self& setMinimumTime(double milliseconds);
+
+    /// Runs the cases whose name contains the specified filter.
+    std::vector<Result> run(const std::string& filter) const;
+
+    /// Formats the results as JSON, along with information about the build.
+    static std::string toJson(const std::vector<Result>& results);
+
+private:
+    struct Case {
+        std::string name;
+        Function function;
+        std::size_t items;
+    };
+
+    Result runCase(const Case& item) const;
+
+    std::vector<Case> cases_;
+    double minimumTime_;
+};
+
+void addValueBenchmarks(Benchmark& benchmark);
+void addPropertyBenchmarks(Benchmark& benchmark);
+void addGraphBenchmarks(Benchmark& benchmark);
+void addJsonBenchmarks(Benchmark& benchmark);
+void addPlistBenchmarks(Benchmark& benchmark);
+} // namespace ee
+
+#endif // EE_BENCHMARK_BENCHMARK_HPP
@@ -0,0 +1,231 @@
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+
+#include "fixtures.hpp"
+
+#include <parser/binarygraph.hpp>
+#include <parser/propertyhandler.hpp>
+
+#include <base/ccTypes.h>
+#include <math/CCGeometry.h>
+#include <math/Vec2.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace ee {
+namespace key {
+constexpr auto node_graph = "node_graph";
+} // namespace key
+
+namespace {
+/// Number of children of each inner node.
+constexpr std::size_t fan_out = 8;
+
+void setNodeProperties(NodeGraph& graph, std::size_t index) {
+    auto i = static_cast<int>(index);
+    auto f = static_cast<float>(index);
+    graph.setBaseClass("_Node");
+    graph.setDisplayName("node_" + std::to_string(index));
+    auto&& handler = graph.getPropertyHandler();
+    handler.setProperty("name", std::string("node_") + std::to_string(index));
+    handler.setProperty("position", cocos2d::Point(f * 0.5f, f * 0.25f));
+    handler.setProperty("content_size", cocos2d::Size(64.0f, 32.5f));
+    handler.setProperty("anchor_point", cocos2d::Point(0.5f, 0.5f));
+    handler.setProperty("color", cocos2d::Color3B(
+                                     static_cast<GLubyte>(i % 256), 128, 255));
+    handler.setProperty("opacity", 255 - i % 64);
+    handler.setProperty("rotation", f * 0.125f);
+    handler.setProperty("scale_x", 1.0f);
+    handler.setProperty("scale_y", 1.5f);
+    handler.setProperty("tag", i);
+    handler.setProperty("local_z_order", i % 16);
+    handler.setProperty("visible", index % 7 != 0);
+}
+
+template <class T, class Factory>
+const T& getShared(std::map<std::size_t, std::unique_ptr<T>>& cache,
+                   std::size_t nodeCount, Factory&& factory) {
+    auto&& entry = cache[nodeCount];
+    if (entry == nullptr) {
+        entry = std::make_unique<T>(factory());
+    }
+    return *entry;
+}
+} // namespace
+
+const std::vector<std::size_t> GraphSizes = {1000, 10000, 100000};
+
+NodeGraph makeNodeGraph(std::size_t nodeCount) {
+    // Build the graph breadth first, so that every inner node except the last
+    // has fan_out children.
+    std::vector<NodeGraph> nodes(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        setNodeProperties(nodes[i], i);
+    }
+    // Children are added bottom up because they are copied.
+    for (std::size_t i = nodeCount; i-- > 1;) {
+        auto parent = (i - 1) / fan_out;
+        auto&& children = nodes[parent].getChildren();
+        children.insert(children.begin(), nodes[i]);
+    }
+    return nodeCount == 0 ? NodeGraph() : nodes.front();
+}
+
+const NodeGraph& getNodeGraph(std::size_t nodeCount) {
+    static std::map<std::size_t, std::unique_ptr<NodeGraph>> cache;
+    return getShared(cache, nodeCount,
+                     [nodeCount] { return makeNodeGraph(nodeCount); });
+}
+
+const ValueMap& getNodeGraphDictionary(std::size_t nodeCount) {
+    static std::map<std::size_t, std::unique_ptr<ValueMap>> cache;
+    return getShared(cache, nodeCount, [nodeCount] {
+        return getNodeGraph(nodeCount).toDict();
+    });
+}
+
+const std::vector<char>& getBinaryGraph(std::size_t nodeCount) {
+    static std::map<std::size_t, std::unique_ptr<std::vector<char>>> cache;
+    return getShared(cache, nodeCount, [nodeCount] {
+        return BinaryGraph::encode(getNodeGraph(nodeCount));
+    });
+}
+
+const std::string& getInterfaceJson(std::size_t nodeCount) {
+    static std::map<std::size_t, std::unique_ptr<std::string>> cache;
+    return getShared(cache, nodeCount, [nodeCount] {
+        QJsonObject json;
+        auto&& dict = getNodeGraphDictionary(nodeCount);
+        json[key::node_graph] = convertToJson(Value(dict));
+        return QJsonDocument(json).toJson().toStdString();
+    });
+}
+
+const std::vector<std::size_t> SheetSizes = {300, 3000};
+
+const std::string& getSpriteSheetPlist(std::size_t frameCount) {
+    static std::map<std::size_t, std::unique_ptr<std::string>> cache;
+    return getShared(cache, frameCount, [frameCount] {
+        std::string text =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" "
+            "\"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+            "<plist version=\"1.0\">\n"
+            "<dict>\n"
+            "<key>frames</key>\n"
+            "<dict>\n";
+        for (std::size_t i = 0; i < frameCount; ++i) {
+            auto x = std::to_string(i % 64 * 32);
+            auto y = std::to_string(i / 64 * 32);
+            text += "<key>sprites/frame_" + std::to_string(i) + ".png</key>\n"
+                    "<dict>\n"
+                    "<key>aliases</key>\n"
+                    "<array/>\n"
+                    "<key>spriteOffset</key>\n"
+                    "<string>{0,-1}</string>\n"
+                    "<key>spriteSize</key>\n"
+                    "<string>{30,30}</string>\n"
+                    "<key>spriteSourceSize</key>\n"
+                    "<string>{32,32}</string>\n"
+                    "<key>textureRect</key>\n"
+                    "<string>{{" + x + "," + y + "},{30,30}}</string>\n"
+                    "<key>textureRotated</key>\n";
+            text += i % 3 == 0 ? "<true/>\n" : "<false/>\n";
+            text += "</dict>\n";
+        }
+        text += "</dict>\n"
+                "<key>metadata</key>\n"
+                "<dict>\n"
+                "<key>format</key>\n"
+                "<integer>3</integer>\n"
+                "<key>pixelFormat</key>\n"
+                "<string>RGBA8888</string>\n"
+                "<key>premultiplyAlpha</key>\n"
+                "<false/>\n"
+                "<key>size</key>\n"
+                "<string>{2048,2048}</string>\n"
+                "<key>textureFileName</key>\n"
+                "<string>sheet.png</string>\n"
+                "</dict>\n"
+                "</dict>\n"
+                "</plist>\n";
+        return text;
+    });
+}
+
+QJsonValue convertToJson(const Value& value) {
+    if (value.isBool()) {
+        return value.getBool().value();
+    }
+    if (value.isInt()) {
+        return value.getInt().value();
+    }
+    if (value.isFloat()) {
+        return static_cast<double>(value.getFloat().value());
+    }
+    if (value.isString()) {
+        return QString::fromStdString(value.asString());
+    }
+    if (value.isList()) {
+        QJsonArray array;
+        for (auto&& v : value.asList()) {
+            array.append(convertToJson(v));
+        }
+        return array;
+    }
+    if (value.isMap()) {
+        QJsonObject dict;
+        for (auto&& v : value.asMap()) {
+            dict.insert(QString::fromStdString(v.first),
+                        convertToJson(v.second));
+        }
+        return dict;
+    }
+    if (value.isPacked()) {
+        return convertToJson(Value(value.toTagged()));
+    }
+    return QJsonValue::Null;
+}
+
+Value convertToValue(const QJsonValue& json) {
+    if (json.isBool()) {
+        return Value(json.toBool());
+    }
+    if (json.isDouble()) {
+        auto v = json.toDouble();
+        constexpr auto eps = std::numeric_limits<double>::epsilon();
+        if (std::abs(int(v) - v) < eps) {
+            return Value(json.toInt());
+        }
+        return Value(static_cast<float>(json.toDouble()));
+    }
+    if (json.isString()) {
+        return Value(json.toString().toStdString());
+    }
+    if (json.isArray()) {
+        ValueList array;
+        for (auto v : json.toArray()) {
+            array.push_back(convertToValue(v));
+        }
+        return Value(std::move(array));
+    }
+    if (json.isObject()) {
+        ValueMap dict;
+        auto obj = json.toObject();
+        for (auto iter = obj.begin(); iter != obj.end(); ++iter) {
+            dict.emplace(iter.key().toStdString(),
+                         convertToValue(iter.value()));
+        }
+        auto packed = Value::fromTagged(dict);
+        if (packed.has_value()) {
+            return std::move(packed.value());
+        }
+        return Value(std::move(dict));
+    }
+    return Value::Null;
+}
+} // namespace ee
@@ -0,0 +1,46 @@
+#ifndef EE_BENCHMARK_FIXTURES_HPP
+#define EE_BENCHMARK_FIXTURES_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <parser/nodegraph.hpp>
+
+#include <QJsonValue>
+
+namespace ee {
+/// Node counts of the generated graphs.
+extern const std::vector<std::size_t> GraphSizes;
+
+/// Builds a node graph with the specified number of nodes, each with the
+/// properties commonly found in interfaces.
+NodeGraph makeNodeGraph(std::size_t nodeCount);
+
+/// Gets a shared node graph with the specified number of nodes, built on
+/// first use.
+const NodeGraph& getNodeGraph(std::size_t nodeCount);
+
+/// Gets the dictionary of the shared node graph.
+const ValueMap& getNodeGraphDictionary(std::size_t nodeCount);
+
+/// Gets the shared node graph in the binary format.
+const std::vector<char>& getBinaryGraph(std::size_t nodeCount);
+
+/// Gets the shared node graph as the text of an interface file.
+const std::string& getInterfaceJson(std::size_t nodeCount);
+
+/// Frame counts of the generated sprite sheets, the largest matches the
+/// biggest sheets of the projects.
+extern const std::vector<std::size_t> SheetSizes;
+
+/// Gets a shared sprite sheet property list with the specified number of
+/// frames, in the format written by TexturePacker.
+const std::string& getSpriteSheetPlist(std::size_t frameCount);
+
+/// Same conversions as the editor's, used as the QJson baseline.
+QJsonValue convertToJson(const Value& value);
+Value convertToValue(const QJsonValue& json);
+} // namespace ee
+
+#endif // EE_BENCHMARK_FIXTURES_HPP
@@ -0,0 +1,117 @@
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+
+#include <parser/binarygraph.hpp>
+#include <parser/graphreader.hpp>
+#include <parser/nodeloaderlibrary.hpp>
+
+#include <2d/CCNode.h>
+#include <base/CCAutoreleasePool.h>
+
+namespace ee {
+namespace {
+const GraphReader& getGraphReader() {
+    static auto reader = [] {
+        NodeLoaderLibrary library;
+        library.addDefaultLoaders();
+        return GraphReader(library);
+    }();
+    return reader;
+}
+
+/// Releases the nodes created by the readers along with their infos, there
+/// is no main loop to drain the autorelease pool.
+void releaseNodes() {
+    cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
+}
+
+void addNodeGraphBenchmarks(Benchmark& benchmark, std::size_t nodeCount) {
+    auto suffix = "/" + std::to_string(nodeCount);
+    benchmark.add("node_graph/from_dict" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& dict = getNodeGraphDictionary(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          NodeGraph graph(dict);
+                          doNotOptimize(graph);
+                      }
+                  },
+                  nodeCount);
+    benchmark.add("node_graph/to_dict" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& graph = getNodeGraph(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto dict = graph.toDict();
+                          doNotOptimize(dict);
+                      }
+                  },
+                  nodeCount);
+    benchmark.add("binary_graph/encode" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& graph = getNodeGraph(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto buffer = BinaryGraph::encode(graph);
+                          doNotOptimize(buffer);
+                      }
+                  },
+                  nodeCount);
+    benchmark.add("binary_graph/to_node_graph" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& buffer = getBinaryGraph(nodeCount);
+                      BinaryGraph binaryGraph(buffer.data(), buffer.size());
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto graph = binaryGraph.toNodeGraph();
+                          doNotOptimize(graph);
+                      }
+                  },
+                  nodeCount);
+}
+
+void addReaderBenchmarks(Benchmark& benchmark, std::size_t nodeCount) {
+    auto suffix = "/" + std::to_string(nodeCount);
+    benchmark.add("graph_reader/read_node_graph" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& reader = getGraphReader();
+                      auto&& graph = getNodeGraph(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto node = reader.readNodeGraph(graph);
+                          doNotOptimize(node);
+                          releaseNodes();
+                      }
+                  },
+                  nodeCount);
+    benchmark.add("graph_reader/read_binary_graph" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& buffer = getBinaryGraph(nodeCount);
+                      auto&& reader = getGraphReader();
+                      BinaryGraph binaryGraph(buffer.data(), buffer.size());
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto node = reader.readBinaryGraph(binaryGraph);
+                          doNotOptimize(node);
+                          releaseNodes();
+                      }
+                  },
+                  nodeCount);
+    benchmark.add("graph_reader/prepare_instantiate" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& reader = getGraphReader();
+                      auto&& graph = getNodeGraph(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto prepared = reader.prepare(graph);
+                          auto node = reader.instantiate(prepared);
+                          doNotOptimize(node);
+                          releaseNodes();
+                      }
+                  },
+                  nodeCount);
+}
+} // namespace
+
+void addGraphBenchmarks(Benchmark& benchmark) {
+    for (auto&& nodeCount : GraphSizes) {
+        addNodeGraphBenchmarks(benchmark, nodeCount);
+    }
+    for (auto&& nodeCount : GraphSizes) {
+        addReaderBenchmarks(benchmark, nodeCount);
+    }
+}
+} // namespace ee
@@ -0,0 +1,52 @@
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+
+#include <parser/jsongraphreader.hpp>
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace ee {
+namespace key {
+constexpr auto node_graph = "node_graph";
+} // namespace key
+
+namespace {
+void addReadBenchmarks(Benchmark& benchmark, std::size_t nodeCount) {
+    auto suffix = "/" + std::to_string(nodeCount);
+    // The path used before JsonGraphReader: QJson document, conversion to a
+    // value tree, then the node graph.
+    benchmark.add("json/qjson_document" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& text = getInterfaceJson(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto bytes = QByteArray::fromRawData(
+                              text.data(), static_cast<int>(text.size()));
+                          auto doc = QJsonDocument::fromJson(bytes);
+                          auto obj = doc.object().value(key::node_graph);
+                          auto dict = convertToValue(obj).asMap();
+                          NodeGraph graph(dict);
+                          doNotOptimize(graph);
+                      }
+                  },
+                  nodeCount);
+    benchmark.add("json/json_graph_reader" + suffix,
+                  [nodeCount](std::size_t iterations) {
+                      auto&& text = getInterfaceJson(nodeCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto graph = JsonGraphReader::read(
+                              text.data(), text.size(), key::node_graph);
+                          doNotOptimize(graph);
+                      }
+                  },
+                  nodeCount);
+}
+} // namespace
+
+void addJsonBenchmarks(Benchmark& benchmark) {
+    for (auto&& nodeCount : GraphSizes) {
+        addReadBenchmarks(benchmark, nodeCount);
+    }
+}
+} // namespace ee
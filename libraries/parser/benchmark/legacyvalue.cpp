@@ -0,0 +1,204 @@
+#include <ciso646>
+
+#include "legacyvalue.hpp"
+
+#include <parser/value.hpp>
+
+namespace ee {
+using Self = LegacyValue;
+
+static_assert(sizeof(LegacyValue) == sizeof(Value),
+              "Both layouts are expected to be the same size");
+
+Self Self::fromValue(const Value& value) {
+    switch (value.getType()) {
+    case Value::Type::None:
+        return Self();
+    case Value::Type::Bool:
+        return Self(value.getBool().value());
+    case Value::Type::Int:
+        return Self(value.getInt().value());
+    case Value::Type::Float:
+        return Self(value.getFloat().value());
+    case Value::Type::String:
+        return Self(value.asString());
+    case Value::Type::List: {
+        List list;
+        list.reserve(value.asList().size());
+        for (auto&& elt : value.asList()) {
+            list.push_back(fromValue(elt));
+        }
+        return Self(std::move(list));
+    }
+    case Value::Type::Map: {
+        Map dict;
+        for (auto&& elt : value.asMap()) {
+            dict.emplace(elt.first, fromValue(elt.second));
+        }
+        return Self(std::move(dict));
+    }
+    default:
+        return fromValue(Value(value.toTagged()));
+    }
+}
+
+Self::LegacyValue()
+    : type_(Type::None) {}
+
+Self::LegacyValue(bool value)
+    : type_(Type::Bool) {
+    field_.b = value;
+}
+
+Self::LegacyValue(int value)
+    : type_(Type::Int) {
+    field_.i = value;
+}
+
+Self::LegacyValue(float value)
+    : type_(Type::Float) {
+    field_.f = value;
+}
+
+Self::LegacyValue(const std::string& value)
+    : type_(Type::String) {
+    new (&field_.s) std::unique_ptr<std::string>(new std::string(value));
+}
+
+Self::LegacyValue(const List& value)
+    : type_(Type::List) {
+    new (&field_.l) std::unique_ptr<List>(new List(value));
+}
+
+Self::LegacyValue(List&& value)
+    : type_(Type::List) {
+    new (&field_.l) std::unique_ptr<List>(new List(std::move(value)));
+}
+
+Self::LegacyValue(const Map& value)
+    : type_(Type::Map) {
+    new (&field_.m) std::unique_ptr<Map>(new Map(value));
+}
+
+Self::LegacyValue(Map&& value)
+    : type_(Type::Map) {
+    new (&field_.m) std::unique_ptr<Map>(new Map(std::move(value)));
+}
+
+Self::LegacyValue(const Self& other)
+    : type_(Type::None) {
+    *this = other;
+}
+
+Self::LegacyValue(Self&& other) noexcept
+    : type_(Type::None) {
+    *this = std::move(other);
+}
+
+Self::~LegacyValue() {
+    clear();
+}
+
+Self& Self::operator=(const Self& other) {
+    if (this == &other) {
+        return *this;
+    }
+    // Copy before clearing, other may be owned by this.
+    switch (other.type_) {
+    case Type::String:
+        *this = Self(*other.field_.s);
+        break;
+    case Type::List:
+        *this = Self(*other.field_.l);
+        break;
+    case Type::Map:
+        *this = Self(*other.field_.m);
+        break;
+    default:
+        clear();
+        type_ = other.type_;
+        field_.i = other.field_.i;
+        break;
+    }
+    return *this;
+}
+
+Self& Self::operator=(Self&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    // Steal into a local first, other may be owned by this.
+    Self value;
+    value.steal(other);
+    clear();
+    steal(value);
+    return *this;
+}
+
+bool Self::operator==(const Self& other) const {
+    if (type_ != other.type_) {
+        return false;
+    }
+    switch (type_) {
+    case Type::None:
+        return true;
+    case Type::Bool:
+        return field_.b == other.field_.b;
+    case Type::Int:
+        return field_.i == other.field_.i;
+    case Type::Float:
+        return field_.f == other.field_.f;
+    case Type::String:
+        return *field_.s == *other.field_.s;
+    case Type::List:
+        return *field_.l == *other.field_.l;
+    case Type::Map:
+        return *field_.m == *other.field_.m;
+    }
+    return false;
+}
+
+bool Self::operator!=(const Self& other) const {
+    return not(*this == other);
+}
+
+Self::Type Self::getType() const {
+    return type_;
+}
+
+void Self::clear() {
+    switch (type_) {
+    case Type::String:
+        field_.s.~unique_ptr();
+        break;
+    case Type::List:
+        field_.l.~unique_ptr();
+        break;
+    case Type::Map:
+        field_.m.~unique_ptr();
+        break;
+    default:
+        break;
+    }
+    type_ = Type::None;
+}
+
+void Self::steal(Self& other) {
+    switch (other.type_) {
+    case Type::String:
+        new (&field_.s) auto(std::move(other.field_.s));
+        break;
+    case Type::List:
+        new (&field_.l) auto(std::move(other.field_.l));
+        break;
+    case Type::Map:
+        new (&field_.m) auto(std::move(other.field_.m));
+        break;
+    default:
+        field_.i = other.field_.i;
+        break;
+    }
+    type_ = other.type_;
+    other.clear();
+}
+} // namespace ee
@@ -0,0 +1,82 @@
+#ifndef EE_BENCHMARK_LEGACY_VALUE_HPP
+#define EE_BENCHMARK_LEGACY_VALUE_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <parser/parserfwd.hpp>
+
+namespace ee {
+/// Value layout used before packed types and interned strings: 16 bytes,
+/// every string and container owned through a unique pointer and deep copied.
+/// Kept only as the baseline of the value benchmarks.
+class LegacyValue final {
+private:
+    using Self = LegacyValue;
+
+public:
+    using List = std::vector<LegacyValue>;
+    using Map = std::map<std::string, LegacyValue>;
+
+    enum class Type {
+        None,
+        Bool,
+        Int,
+        Float,
+        String,
+        List,
+        Map,
+    };
+
+    /// Converts the specified value, packed values become tagged maps as
+    /// they used to be stored.
+    static Self fromValue(const Value& value);
+
+    LegacyValue();
+    explicit LegacyValue(bool value);
+    explicit LegacyValue(int value);
+    explicit LegacyValue(float value);
+    explicit LegacyValue(const std::string& value);
+    explicit LegacyValue(const List& value);
+    explicit LegacyValue(List&& value);
+    explicit LegacyValue(const Map& value);
+    explicit LegacyValue(Map&& value);
+
+    LegacyValue(const Self& other);
+    LegacyValue(Self&& other) noexcept;
+
+    ~LegacyValue();
+
+    Self& operator=(const Self& other);
+    Self& operator=(Self&& other) noexcept;
+
+    bool operator==(const Self& other) const;
+    bool operator!=(const Self& other) const;
+
+    Type getType() const;
+
+    void clear();
+
+private:
+    /// Takes the content of other, this must be empty.
+    void steal(Self& other);
+
+    Type type_;
+
+    union Field {
+        bool b;
+        int i;
+        float f;
+        std::unique_ptr<std::string> s;
+        std::unique_ptr<List> l;
+        std::unique_ptr<Map> m;
+
+        Field() {}
+        ~Field() {}
+    } field_;
+};
+} // namespace ee
+
+#endif // EE_BENCHMARK_LEGACY_VALUE_HPP
@@ -0,0 +1,52 @@
+#include <ciso646>
+#include <cstdio>
+#include <fstream>
+
+#include "benchmark.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("parser-benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks the parser library.");
+    parser.addHelpOption();
+    QCommandLineOption filterOption(
+        "filter", "Runs only the benchmarks whose name contains <filter>.",
+        "filter");
+    QCommandLineOption minimumTimeOption(
+        "min-time", "Minimum measured time of each benchmark in ms.", "ms",
+        "200");
+    QCommandLineOption outputOption(
+        "output", "Writes the JSON results to <file> instead of stdout.",
+        "file");
+    parser.addOption(filterOption);
+    parser.addOption(minimumTimeOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    ee::Benchmark benchmark;
+    benchmark.setMinimumTime(parser.value(minimumTimeOption).toDouble());
+    ee::addValueBenchmarks(benchmark);
+    ee::addPropertyBenchmarks(benchmark);
+    ee::addGraphBenchmarks(benchmark);
+    ee::addJsonBenchmarks(benchmark);
+    ee::addPlistBenchmarks(benchmark);
+
+    auto results = benchmark.run(parser.value(filterOption).toStdString());
+    auto json = ee::Benchmark::toJson(results);
+    if (parser.isSet(outputOption)) {
+        std::ofstream file(parser.value(outputOption).toStdString());
+        file << json;
+        if (not file) {
+            std::fprintf(stderr, "Could not write the results\n");
+            return 1;
+        }
+    } else {
+        std::fputs(json.c_str(), stdout);
+    }
+    return 0;
+}
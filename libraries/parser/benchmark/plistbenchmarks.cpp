@@ -0,0 +1,58 @@
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+
+#include <platform/qt/CCPlistParser_Qt.hpp>
+
+#include <qtplist/plistparser.h>
+
+#include <QBuffer>
+
+namespace ee {
+namespace {
+void addReadBenchmarks(Benchmark& benchmark, std::size_t frameCount) {
+    auto suffix = "/" + std::to_string(frameCount);
+    // The path used before PlistParser: qtplist variant tree, conversion to
+    // QJson, then to a value tree.
+    benchmark.add("plist/qtplist" + suffix,
+                  [frameCount](std::size_t iterations) {
+                      auto&& text = getSpriteSheetPlist(frameCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto bytes = QByteArray::fromRawData(
+                              text.data(), static_cast<int>(text.size()));
+                          QBuffer buffer(&bytes);
+                          auto variant = PListParser::parsePList(&buffer);
+                          auto json = QJsonValue::fromVariant(variant);
+                          auto value = convertToValue(json);
+                          doNotOptimize(value);
+                      }
+                  },
+                  frameCount);
+    benchmark.add("plist/plist_parser" + suffix,
+                  [frameCount](std::size_t iterations) {
+                      auto&& text = getSpriteSheetPlist(frameCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto value = cocos2d::PlistParser::parse(
+                              text.data(), text.size());
+                          doNotOptimize(value);
+                      }
+                  },
+                  frameCount);
+    benchmark.add("plist/frame_names" + suffix,
+                  [frameCount](std::size_t iterations) {
+                      auto&& text = getSpriteSheetPlist(frameCount);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto names = cocos2d::PlistParser::parseFrameNames(
+                              text.data(), text.size());
+                          doNotOptimize(names);
+                      }
+                  },
+                  frameCount);
+}
+} // namespace
+
+void addPlistBenchmarks(Benchmark& benchmark) {
+    for (auto&& frameCount : SheetSizes) {
+        addReadBenchmarks(benchmark, frameCount);
+    }
+}
+} // namespace ee
@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+
+#include <parser/propertyhandler.hpp>
+
+#include <base/ccTypes.h>
+#include <math/CCGeometry.h>
+#include <math/Vec2.h>
+
+namespace ee {
+namespace {
+/// Registers get and set benchmarks for a property type.
+/// @param type Name of the type in the benchmark names.
+template <class T>
+void addTraitsBenchmarks(Benchmark& benchmark, const std::string& type,
+                         const T& value) {
+    // Surround the property with others so that lookups are realistic.
+    auto makeHandler = [value] {
+        PropertyHandler handler;
+        handler.setProperty("anchor_point", cocos2d::Point(0.5f, 0.5f));
+        handler.setProperty("content_size", cocos2d::Size(64.0f, 32.0f));
+        handler.setProperty("name", std::string("node"));
+        handler.setProperty("opacity", 255);
+        handler.setProperty("rotation", 90.0f);
+        handler.setProperty("visible", true);
+        handler.setProperty("value", value);
+        return handler;
+    };
+    benchmark.add("property_traits/get/" + type,
+                  [makeHandler](std::size_t iterations) {
+                      PropertyHandler handler = makeHandler();
+                      Symbol name("value");
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto result = handler.getProperty<T>(name);
+                          doNotOptimize(result);
+                      }
+                  });
+    benchmark.add("property_traits/set/" + type,
+                  [makeHandler, value](std::size_t iterations) {
+                      PropertyHandler handler = makeHandler();
+                      Symbol name("value");
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          handler.setProperty(name, value);
+                          doNotOptimize(handler);
+                      }
+                  });
+}
+} // namespace
+
+void addPropertyBenchmarks(Benchmark& benchmark) {
+    addTraitsBenchmarks(benchmark, "bool", true);
+    addTraitsBenchmarks(benchmark, "int", 42);
+    addTraitsBenchmarks(benchmark, "float", 0.5f);
+    addTraitsBenchmarks(benchmark, "string",
+                        std::string("images/button_normal.png"));
+    addTraitsBenchmarks(benchmark, "point", cocos2d::Point(12.5f, -3.0f));
+    addTraitsBenchmarks(benchmark, "size", cocos2d::Size(128.0f, 64.0f));
+    addTraitsBenchmarks(benchmark, "color3b", cocos2d::Color3B(255, 128, 0));
+    addTraitsBenchmarks(benchmark, "rect",
+                        cocos2d::Rect(1.0f, 2.0f, 300.0f, 200.0f));
+    addTraitsBenchmarks(benchmark, "blend_func",
+                        cocos2d::BlendFunc::ALPHA_PREMULTIPLIED);
+}
+} // namespace ee
@@ -0,0 +1,198 @@
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+#include "legacyvalue.hpp"
+
+#include <parser/value.hpp>
+
+#include <base/CCValue.h>
+
+namespace ee {
+namespace {
+constexpr auto short_string = "texture.png";
+constexpr auto long_string = "images/interface/common/buttons/button_normal.png";
+
+/// Dictionary of a mid-sized graph.
+constexpr std::size_t document_nodes = 1000;
+
+/// Same dictionary in the layout used before packed types and interned
+/// strings, the baseline of the legacy cases.
+const LegacyValue& getLegacyDocument() {
+    static auto document =
+        LegacyValue::fromValue(Value(getNodeGraphDictionary(document_nodes)));
+    return document;
+}
+
+void addConstructionBenchmarks(Benchmark& benchmark) {
+    benchmark.add("value/construct/int", [](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value value(static_cast<int>(i));
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/construct/float", [](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value value(static_cast<float>(i));
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/construct/short_string", [](std::size_t iterations) {
+        std::string str = short_string;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value value(str);
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/construct/long_string", [](std::size_t iterations) {
+        std::string str = long_string;
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value value(str);
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/construct/map", [](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            ValueMap dict;
+            dict.emplace("position_x", Value(1.0f));
+            dict.emplace("position_y", Value(2.0f));
+            dict.emplace("texture", Value(std::string(short_string)));
+            dict.emplace("visible", Value(true));
+            Value value(std::move(dict));
+            doNotOptimize(value);
+        }
+    });
+}
+
+void addCopyBenchmarks(Benchmark& benchmark) {
+    benchmark.add("value/copy/short_string", [](std::size_t iterations) {
+        Value source{std::string(short_string)};
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value value(source);
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/copy/long_string", [](std::size_t iterations) {
+        Value source{std::string(long_string)};
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value value(source);
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/copy/document",
+                  [](std::size_t iterations) {
+                      auto&& dict = getNodeGraphDictionary(document_nodes);
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          ValueMap copy(dict);
+                          doNotOptimize(copy);
+                      }
+                  },
+                  document_nodes);
+    benchmark.add("value/move/document", [](std::size_t iterations) {
+        Value value(getNodeGraphDictionary(document_nodes));
+        for (std::size_t i = 0; i < iterations; ++i) {
+            Value other(std::move(value));
+            value = std::move(other);
+            doNotOptimize(value);
+        }
+    });
+}
+
+void addCompareBenchmarks(Benchmark& benchmark) {
+    benchmark.add("value/compare/string", [](std::size_t iterations) {
+        Value lhs{std::string(long_string)};
+        Value rhs{std::string(long_string)};
+        for (std::size_t i = 0; i < iterations; ++i) {
+            auto equal = lhs == rhs;
+            doNotOptimize(equal);
+        }
+    });
+    benchmark.add("value/compare/document",
+                  [](std::size_t iterations) {
+                      Value lhs(getNodeGraphDictionary(document_nodes));
+                      Value rhs(getNodeGraphDictionary(document_nodes));
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto equal = lhs == rhs;
+                          doNotOptimize(equal);
+                      }
+                  },
+                  document_nodes);
+}
+
+void addConversionBenchmarks(Benchmark& benchmark) {
+    benchmark.add("value/to_value/document",
+                  [](std::size_t iterations) {
+                      Value value(getNodeGraphDictionary(document_nodes));
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto result = value.toValue();
+                          doNotOptimize(result);
+                      }
+                  },
+                  document_nodes);
+    benchmark.add("value/from_value/document",
+                  [](std::size_t iterations) {
+                      static auto source =
+                          Value(getNodeGraphDictionary(document_nodes))
+                              .toValue();
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto result = Value::fromValue(source);
+                          doNotOptimize(result);
+                      }
+                  },
+                  document_nodes);
+}
+
+/// Same operations on the previous layout, to compare old and new.
+void addLegacyBenchmarks(Benchmark& benchmark) {
+    benchmark.add("value/legacy/construct/short_string",
+                  [](std::size_t iterations) {
+                      std::string str = short_string;
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          LegacyValue value(str);
+                          doNotOptimize(value);
+                      }
+                  });
+    benchmark.add("value/legacy/copy/short_string",
+                  [](std::size_t iterations) {
+                      LegacyValue source{std::string(short_string)};
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          LegacyValue value(source);
+                          doNotOptimize(value);
+                      }
+                  });
+    benchmark.add("value/legacy/copy/document",
+                  [](std::size_t iterations) {
+                      auto&& document = getLegacyDocument();
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          LegacyValue copy(document);
+                          doNotOptimize(copy);
+                      }
+                  },
+                  document_nodes);
+    benchmark.add("value/legacy/move/document", [](std::size_t iterations) {
+        LegacyValue value(getLegacyDocument());
+        for (std::size_t i = 0; i < iterations; ++i) {
+            LegacyValue other(std::move(value));
+            value = std::move(other);
+            doNotOptimize(value);
+        }
+    });
+    benchmark.add("value/legacy/compare/document",
+                  [](std::size_t iterations) {
+                      LegacyValue lhs(getLegacyDocument());
+                      LegacyValue rhs(getLegacyDocument());
+                      for (std::size_t i = 0; i < iterations; ++i) {
+                          auto equal = lhs == rhs;
+                          doNotOptimize(equal);
+                      }
+                  },
+                  document_nodes);
+}
+} // namespace
+
+void addValueBenchmarks(Benchmark& benchmark) {
+    addConstructionBenchmarks(benchmark);
+    addCopyBenchmarks(benchmark);
+    addCompareBenchmarks(benchmark);
+    addConversionBenchmarks(benchmark);
+    addLegacyBenchmarks(benchmark);
+}
+} // namespace ee
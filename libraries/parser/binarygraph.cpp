@@ -0,0 +1,629 @@
+#include <ciso646>
+#include <cstring>
+#include <unordered_map>
+
+#include "binarygraph.hpp"
+#include "nodegraph.hpp"
+#include "propertyhandler.hpp"
+#include "stringpool.hpp"
+#include "value.hpp"
+
+#include <base/ccTypes.h>
+#include <math/CCGeometry.h>
+#include <math/Vec2.h>
+
+namespace ee {
+namespace {
+constexpr char magic[] = {'E', 'E', 'G', 'B'};
+
+constexpr std::size_t header_size = 32;
+constexpr std::size_t string_record_size = 8;
+constexpr std::size_t node_record_size = 16;
+constexpr std::size_t entry_record_size = 8;
+constexpr std::size_t value_record_size = 12;
+
+/// Value type tags, stable across format versions.
+enum ValueTag : std::uint32_t {
+    None = 0,
+    Bool = 1,
+    Int = 2,
+    Float = 3,
+    String = 4,
+    List = 5,
+    Map = 6,
+    Vec2 = 7,
+    Size = 8,
+    Color = 9,
+    Rect = 10,
+    Blend = 11,
+};
+
+constexpr std::uint32_t rect_word_count = 4;
+
+struct NodeRecord {
+    std::uint32_t firstEntry;
+    std::uint32_t entryCount;
+    std::uint32_t firstChild;
+    std::uint32_t childCount;
+};
+
+struct EntryRecord {
+    std::uint32_t key;
+    std::uint32_t value;
+};
+
+struct ValueRecord {
+    std::uint32_t tag;
+    std::uint32_t payload;
+    std::uint32_t count;
+};
+
+void writeU32(std::vector<char>& buffer, std::uint32_t value) {
+    buffer.push_back(static_cast<char>(value & 0xff));
+    buffer.push_back(static_cast<char>((value >> 8) & 0xff));
+    buffer.push_back(static_cast<char>((value >> 16) & 0xff));
+    buffer.push_back(static_cast<char>((value >> 24) & 0xff));
+}
+
+std::uint32_t floatToBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float bitsToFloat(std::uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+class Encoder {
+public:
+    std::vector<char> encode(const NodeGraph& graph) {
+        nodes_.emplace_back();
+        encodeNode(graph, 0);
+
+        std::vector<char> buffer;
+        buffer.insert(buffer.end(), std::begin(magic), std::end(magic));
+        writeU32(buffer, BinaryGraph::Version);
+        writeU32(buffer, static_cast<std::uint32_t>(strings_.size()));
+        writeU32(buffer, 0); // Patched below.
+        writeU32(buffer, static_cast<std::uint32_t>(nodes_.size()));
+        writeU32(buffer, static_cast<std::uint32_t>(entries_.size()));
+        writeU32(buffer, static_cast<std::uint32_t>(values_.size()));
+        writeU32(buffer, static_cast<std::uint32_t>(words_.size()));
+
+        std::uint32_t offset = 0;
+        for (auto&& str : strings_) {
+            writeU32(buffer, offset);
+            writeU32(buffer, static_cast<std::uint32_t>(str.size()));
+            offset += static_cast<std::uint32_t>(str.size());
+        }
+        auto stringDataSize = (offset + 3) / 4 * 4;
+        for (auto&& str : strings_) {
+            buffer.insert(buffer.end(), str.cbegin(), str.cend());
+        }
+        buffer.resize(buffer.size() + (stringDataSize - offset), '\0');
+
+        auto patched = std::vector<char>();
+        writeU32(patched, stringDataSize);
+        std::copy(patched.cbegin(), patched.cend(), buffer.begin() + 12);
+
+        for (auto&& node : nodes_) {
+            writeU32(buffer, node.firstEntry);
+            writeU32(buffer, node.entryCount);
+            writeU32(buffer, node.firstChild);
+            writeU32(buffer, node.childCount);
+        }
+        for (auto&& entry : entries_) {
+            writeU32(buffer, entry.key);
+            writeU32(buffer, entry.value);
+        }
+        for (auto&& value : values_) {
+            writeU32(buffer, value.tag);
+            writeU32(buffer, value.payload);
+            writeU32(buffer, value.count);
+        }
+        for (auto&& word : words_) {
+            writeU32(buffer, word);
+        }
+        return buffer;
+    }
+
+private:
+    std::uint32_t addString(const std::string& str) {
+        auto iter = stringIndices_.find(str);
+        if (iter != stringIndices_.cend()) {
+            return iter->second;
+        }
+        auto index = static_cast<std::uint32_t>(strings_.size());
+        strings_.push_back(str);
+        stringIndices_.emplace(str, index);
+        return index;
+    }
+
+    void encodeNode(const NodeGraph& graph, std::uint32_t index) {
+        auto&& properties = graph.getPropertyHandler().getProperties();
+        auto firstEntry = encodeEntries(properties);
+
+        auto&& children = graph.getChildren();
+        auto firstChild = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.resize(nodes_.size() + children.size());
+
+        // Reference may be invalidated by the resize above.
+        auto&& node = nodes_[index];
+        node.firstEntry = firstEntry;
+        node.entryCount = static_cast<std::uint32_t>(properties.size());
+        node.firstChild = children.empty() ? 0 : firstChild;
+        node.childCount = static_cast<std::uint32_t>(children.size());
+
+        for (std::size_t i = 0; i < children.size(); ++i) {
+            encodeNode(children[i],
+                       firstChild + static_cast<std::uint32_t>(i));
+        }
+    }
+
+    std::uint32_t encodeEntries(const ValueMap& dict) {
+        auto firstEntry = static_cast<std::uint32_t>(entries_.size());
+        entries_.resize(entries_.size() + dict.size());
+        auto entryIndex = firstEntry;
+        for (auto&& elt : dict) {
+            auto valueIndex = static_cast<std::uint32_t>(values_.size());
+            values_.emplace_back();
+            entries_[entryIndex].key = addString(elt.first);
+            entries_[entryIndex].value = valueIndex;
+            encodeValue(elt.second, valueIndex);
+            ++entryIndex;
+        }
+        return firstEntry;
+    }
+
+    void encodeValue(const Value& value, std::uint32_t index) {
+        ValueRecord record{ValueTag::None, 0, 0};
+        switch (value.getType()) {
+        case Value::Type::None:
+            break;
+        case Value::Type::Bool:
+            record.tag = ValueTag::Bool;
+            record.payload = value.getBool().value() ? 1 : 0;
+            break;
+        case Value::Type::Int:
+            record.tag = ValueTag::Int;
+            record.payload = static_cast<std::uint32_t>(value.getInt().value());
+            break;
+        case Value::Type::Float:
+            record.tag = ValueTag::Float;
+            record.payload = floatToBits(value.getFloat().value());
+            break;
+        case Value::Type::String:
+            record.tag = ValueTag::String;
+            record.payload = addString(value.asString());
+            break;
+        case Value::Type::List: {
+            auto&& list = value.asList();
+            auto first = static_cast<std::uint32_t>(values_.size());
+            values_.resize(values_.size() + list.size());
+            for (std::size_t i = 0; i < list.size(); ++i) {
+                encodeValue(list[i], first + static_cast<std::uint32_t>(i));
+            }
+            record.tag = ValueTag::List;
+            record.payload = list.empty() ? 0 : first;
+            record.count = static_cast<std::uint32_t>(list.size());
+            break;
+        }
+        case Value::Type::Map: {
+            auto&& dict = value.asMap();
+            record.tag = ValueTag::Map;
+            record.payload = encodeEntries(dict);
+            record.count = static_cast<std::uint32_t>(dict.size());
+            break;
+        }
+        case Value::Type::Vec2: {
+            auto point = value.getVec2().value();
+            record.tag = ValueTag::Vec2;
+            record.payload = floatToBits(point.x);
+            record.count = floatToBits(point.y);
+            break;
+        }
+        case Value::Type::Size: {
+            auto size = value.getSize().value();
+            record.tag = ValueTag::Size;
+            record.payload = floatToBits(size.width);
+            record.count = floatToBits(size.height);
+            break;
+        }
+        case Value::Type::Color: {
+            auto color = value.getColor().value();
+            record.tag = ValueTag::Color;
+            record.payload = static_cast<std::uint32_t>(color.r) |
+                             (static_cast<std::uint32_t>(color.g) << 8) |
+                             (static_cast<std::uint32_t>(color.b) << 16);
+            break;
+        }
+        case Value::Type::Rect: {
+            auto rect = value.getRect().value();
+            record.tag = ValueTag::Rect;
+            record.payload = static_cast<std::uint32_t>(words_.size());
+            record.count = rect_word_count;
+            words_.push_back(floatToBits(rect.origin.x));
+            words_.push_back(floatToBits(rect.origin.y));
+            words_.push_back(floatToBits(rect.size.width));
+            words_.push_back(floatToBits(rect.size.height));
+            break;
+        }
+        case Value::Type::Blend: {
+            auto blend = value.getBlend().value();
+            record.tag = ValueTag::Blend;
+            record.payload = blend.src;
+            record.count = blend.dst;
+            break;
+        }
+        }
+        values_[index] = record;
+    }
+
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, std::uint32_t> stringIndices_;
+    std::vector<NodeRecord> nodes_;
+    std::vector<EntryRecord> entries_;
+    std::vector<ValueRecord> values_;
+    std::vector<std::uint32_t> words_;
+};
+} // namespace
+
+using Self = BinaryGraph;
+
+const std::uint32_t Self::Version = 2;
+const std::uint32_t Self::PackedVersion = 2;
+
+bool Self::isBinary(const void* data, std::size_t size) {
+    return size >= sizeof(magic) &&
+           std::memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+std::vector<char> Self::encode(const NodeGraph& graph) {
+    return Encoder().encode(graph);
+}
+
+Self::BinaryGraph(const void* data, std::size_t size)
+    : data_(static_cast<const char*>(data))
+    , size_(size)
+    , version_(0)
+    , stringCount_(0)
+    , nodeCount_(0)
+    , entryCount_(0)
+    , valueCount_(0)
+    , wordCount_(0)
+    , stringRecordOffset_(0)
+    , stringDataOffset_(0)
+    , nodeOffset_(0)
+    , entryOffset_(0)
+    , valueOffset_(0)
+    , wordOffset_(0)
+    , valid_(false) {
+    if (not isBinary(data, size) || size < header_size) {
+        return;
+    }
+    version_ = readU32(4);
+    stringCount_ = readU32(8);
+    auto stringDataSize = readU32(12);
+    nodeCount_ = readU32(16);
+    entryCount_ = readU32(20);
+    valueCount_ = readU32(24);
+    wordCount_ = readU32(28);
+
+    // 64-bit arithmetic, counts are at most 2^32 - 1.
+    std::uint64_t offset = header_size;
+    stringRecordOffset_ = static_cast<std::size_t>(offset);
+    offset += std::uint64_t(stringCount_) * string_record_size;
+    stringDataOffset_ = static_cast<std::size_t>(offset);
+    offset += stringDataSize;
+    nodeOffset_ = static_cast<std::size_t>(offset);
+    offset += std::uint64_t(nodeCount_) * node_record_size;
+    entryOffset_ = static_cast<std::size_t>(offset);
+    offset += std::uint64_t(entryCount_) * entry_record_size;
+    valueOffset_ = static_cast<std::size_t>(offset);
+    offset += std::uint64_t(valueCount_) * value_record_size;
+    wordOffset_ = static_cast<std::size_t>(offset);
+    offset += std::uint64_t(wordCount_) * 4;
+    if (offset > size) {
+        return;
+    }
+    valid_ = validate();
+}
+
+bool Self::validate() const {
+    // Older versions are a subset of the current one, their properties are
+    // migrated by the reader.
+    if (version_ == 0 || version_ > Version) {
+        return false;
+    }
+    if (nodeCount_ == 0) {
+        return false;
+    }
+    auto stringDataSize = nodeOffset_ - stringDataOffset_;
+    for (std::uint32_t i = 0; i < stringCount_; ++i) {
+        auto record = stringRecordOffset_ + i * string_record_size;
+        std::uint64_t offset = readU32(record);
+        std::uint64_t length = readU32(record + 4);
+        if (offset + length > stringDataSize) {
+            return false;
+        }
+    }
+    // Children and nested values must come after their parent, which
+    // guarantees that walking the graph terminates.
+    for (std::uint32_t i = 0; i < nodeCount_; ++i) {
+        auto record = nodeOffset_ + i * node_record_size;
+        std::uint64_t firstEntry = readU32(record);
+        std::uint64_t entryCount = readU32(record + 4);
+        std::uint64_t firstChild = readU32(record + 8);
+        std::uint64_t childCount = readU32(record + 12);
+        if (firstEntry + entryCount > entryCount_) {
+            return false;
+        }
+        if (childCount > 0 &&
+            (firstChild <= i || firstChild + childCount > nodeCount_)) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < entryCount_; ++i) {
+        auto record = entryOffset_ + i * entry_record_size;
+        if (readU32(record) >= stringCount_) {
+            return false;
+        }
+        if (readU32(record + 4) >= valueCount_) {
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < valueCount_; ++i) {
+        auto record = valueOffset_ + i * value_record_size;
+        auto tag = readU32(record);
+        std::uint64_t payload = readU32(record + 4);
+        std::uint64_t count = readU32(record + 8);
+        switch (tag) {
+        case ValueTag::None:
+        case ValueTag::Bool:
+        case ValueTag::Int:
+        case ValueTag::Float:
+        case ValueTag::Vec2:
+        case ValueTag::Size:
+        case ValueTag::Color:
+        case ValueTag::Blend:
+            break;
+        case ValueTag::Rect:
+            if (count != rect_word_count || payload + count > wordCount_) {
+                return false;
+            }
+            break;
+        case ValueTag::String:
+            if (payload >= stringCount_) {
+                return false;
+            }
+            break;
+        case ValueTag::List:
+            if (count > 0 && (payload <= i || payload + count > valueCount_)) {
+                return false;
+            }
+            break;
+        case ValueTag::Map:
+            if (payload + count > entryCount_) {
+                return false;
+            }
+            for (std::uint64_t j = payload; j < payload + count; ++j) {
+                auto entry = entryOffset_ + j * entry_record_size;
+                if (readU32(entry + 4) <= i) {
+                    return false;
+                }
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Self::isValid() const {
+    return valid_;
+}
+
+std::uint32_t Self::getVersion() const {
+    return version_;
+}
+
+Self::Node Self::getRoot() const {
+    return Node(this, 0);
+}
+
+NodeGraph Self::toNodeGraph() const {
+    StringPool pool;
+    return toNodeGraph(pool);
+}
+
+NodeGraph Self::toNodeGraph(StringPool& pool) const {
+    NodeGraph graph;
+    readNode(getRoot(), graph, pool);
+    return graph;
+}
+
+void Self::readNode(const Node& node, NodeGraph& graph,
+                    StringPool& pool) const {
+    node.readProperties(graph.getPropertyHandler(), pool);
+    auto&& children = graph.getChildren();
+    auto childCount = node.getChildCount();
+    children.resize(childCount);
+    for (std::size_t i = 0; i < childCount; ++i) {
+        readNode(node.getChild(i), children[i], pool);
+    }
+}
+
+std::uint32_t Self::readU32(std::size_t offset) const {
+    auto p = reinterpret_cast<const unsigned char*>(data_ + offset);
+    return static_cast<std::uint32_t>(p[0]) |
+           (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) |
+           (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+std::string Self::getString(std::uint32_t index) const {
+    auto record = stringRecordOffset_ + index * string_record_size;
+    auto offset = readU32(record);
+    auto length = readU32(record + 4);
+    return std::string(data_ + stringDataOffset_ + offset, length);
+}
+
+bool Self::compareString(std::uint32_t index, const std::string& str) const {
+    auto record = stringRecordOffset_ + index * string_record_size;
+    auto offset = readU32(record);
+    auto length = readU32(record + 4);
+    return length == str.size() &&
+           std::memcmp(data_ + stringDataOffset_ + offset, str.data(),
+                       length) == 0;
+}
+
+Value Self::getValue(std::uint32_t index) const {
+    auto record = valueOffset_ + index * value_record_size;
+    auto tag = readU32(record);
+    auto payload = readU32(record + 4);
+    auto count = readU32(record + 8);
+    switch (tag) {
+    case ValueTag::Bool:
+        return Value(payload != 0);
+    case ValueTag::Int:
+        return Value(static_cast<int>(payload));
+    case ValueTag::Float:
+        return Value(bitsToFloat(payload));
+    case ValueTag::String:
+        return Value(getString(payload));
+    case ValueTag::List: {
+        ValueList list;
+        list.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            list.push_back(getValue(payload + i));
+        }
+        return Value(std::move(list));
+    }
+    case ValueTag::Map:
+        return Value(getMap(payload, count));
+    case ValueTag::Vec2:
+        return Value(cocos2d::Vec2(bitsToFloat(payload), bitsToFloat(count)));
+    case ValueTag::Size:
+        return Value(cocos2d::Size(bitsToFloat(payload), bitsToFloat(count)));
+    case ValueTag::Color:
+        return Value(cocos2d::Color3B(
+            static_cast<GLubyte>(payload & 0xff),
+            static_cast<GLubyte>((payload >> 8) & 0xff),
+            static_cast<GLubyte>((payload >> 16) & 0xff)));
+    case ValueTag::Rect: {
+        auto word = wordOffset_ + payload * 4;
+        return Value(cocos2d::Rect(
+            bitsToFloat(readU32(word)), bitsToFloat(readU32(word + 4)),
+            bitsToFloat(readU32(word + 8)), bitsToFloat(readU32(word + 12))));
+    }
+    case ValueTag::Blend: {
+        cocos2d::BlendFunc blend;
+        blend.src = static_cast<GLenum>(payload);
+        blend.dst = static_cast<GLenum>(count);
+        return Value(blend);
+    }
+    default:
+        return Value::Null;
+    }
+}
+
+Value Self::getValue(std::uint32_t index, StringPool& pool) const {
+    auto record = valueOffset_ + index * value_record_size;
+    if (readU32(record) != ValueTag::String) {
+        return getValue(index);
+    }
+    // Intern straight from the string table without a temporary copy.
+    auto stringRecord =
+        stringRecordOffset_ + readU32(record + 4) * string_record_size;
+    auto offset = readU32(stringRecord);
+    auto length = readU32(stringRecord + 4);
+    return pool.intern(data_ + stringDataOffset_ + offset, length);
+}
+
+ValueMap Self::getMap(std::uint32_t firstEntry, std::uint32_t count) const {
+    ValueMap dict;
+    for (std::uint32_t i = firstEntry; i < firstEntry + count; ++i) {
+        auto record = entryOffset_ + i * entry_record_size;
+        dict.emplace_hint(dict.cend(), getString(readU32(record)),
+                          getValue(readU32(record + 4)));
+    }
+    return dict;
+}
+
+using NodeSelf = BinaryGraph::Node;
+
+NodeSelf::Node(const BinaryGraph* graph, std::uint32_t index)
+    : graph_(graph)
+    , index_(index) {}
+
+std::size_t NodeSelf::getPropertyCount() const {
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    return graph_->readU32(record + 4);
+}
+
+std::string NodeSelf::getPropertyName(std::size_t index) const {
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    auto entry =
+        graph_->entryOffset_ + (graph_->readU32(record) + index) * entry_record_size;
+    return graph_->getString(graph_->readU32(entry));
+}
+
+Value NodeSelf::getPropertyValue(std::size_t index) const {
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    auto entry =
+        graph_->entryOffset_ + (graph_->readU32(record) + index) * entry_record_size;
+    return graph_->getValue(graph_->readU32(entry + 4));
+}
+
+std::string NodeSelf::getStringProperty(const std::string& name) const {
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    auto firstEntry = graph_->readU32(record);
+    auto entryCount = graph_->readU32(record + 4);
+    for (std::uint32_t i = firstEntry; i < firstEntry + entryCount; ++i) {
+        auto entry = graph_->entryOffset_ + i * entry_record_size;
+        if (not graph_->compareString(graph_->readU32(entry), name)) {
+            continue;
+        }
+        auto value = graph_->getValue(graph_->readU32(entry + 4));
+        return value.getString().value_or("");
+    }
+    return "";
+}
+
+void NodeSelf::readProperties(PropertyHandler& handler) const {
+    handler.clearProperties();
+    auto count = getPropertyCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        handler.setProperty(getPropertyName(i), getPropertyValue(i));
+    }
+}
+
+void NodeSelf::readProperties(PropertyHandler& handler,
+                              StringPool& pool) const {
+    handler.clearProperties();
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    auto firstEntry = graph_->readU32(record);
+    auto count = getPropertyCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto entry =
+            graph_->entryOffset_ + (firstEntry + i) * entry_record_size;
+        auto value = graph_->getValue(graph_->readU32(entry + 4), pool);
+        handler.setProperty(getPropertyName(i), std::move(value));
+    }
+}
+
+std::size_t NodeSelf::getChildCount() const {
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    return graph_->readU32(record + 12);
+}
+
+NodeSelf NodeSelf::getChild(std::size_t index) const {
+    auto record = graph_->nodeOffset_ + index_ * node_record_size;
+    auto firstChild = graph_->readU32(record + 8);
+    return Node(graph_, firstChild + static_cast<std::uint32_t>(index));
+}
+} // namespace ee
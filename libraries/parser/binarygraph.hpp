@@ -0,0 +1,144 @@
+#ifndef EE_PARSER_BINARY_GRAPH_HPP
+#define EE_PARSER_BINARY_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "parserfwd.hpp"
+
+namespace ee {
+class NodeGraph;
+class PropertyHandler;
+class StringPool;
+
+/// Read-only view of a node graph encoded in the binary interface format.
+///
+/// Layout (all integers are little-endian 32-bit):
+/// - Header: magic "EEGB", version, string count, string data size, node
+///   count, entry count, value count, word count (reserved before version
+///   2).
+/// - String table: (offset, length) records followed by the string data.
+/// - Nodes: (first entry, entry count, first child, child count). Node 0 is
+///   the root and the children of a node are stored contiguously.
+/// - Entries: (key string, value) records used by node properties and maps.
+/// - Values: (type, payload, count) records. Points, sizes, colors and
+///   blend functions are stored inline in the payload and count.
+/// - Words: 32-bit words of values too large to be inline, e.g. rects.
+///
+/// The view does not own its data so it can be walked directly on a
+/// memory-mapped file.
+class BinaryGraph final {
+private:
+    using Self = BinaryGraph;
+
+public:
+    /// Current format version.
+    static const std::uint32_t Version;
+
+    /// First version storing vector-valued properties as packed values,
+    /// older versions store them per component, e.g. position_x.
+    static const std::uint32_t PackedVersion;
+
+    /// A node in the binary graph.
+    class Node final {
+    public:
+        /// Gets the number of properties of this node.
+        std::size_t getPropertyCount() const;
+
+        /// Gets the name of the property at the specified index.
+        std::string getPropertyName(std::size_t index) const;
+
+        /// Decodes the value of the property at the specified index.
+        Value getPropertyValue(std::size_t index) const;
+
+        /// Finds a string property, returns an empty string if absent.
+        std::string getStringProperty(const std::string& name) const;
+
+        /// Decodes all properties of this node into the specified handler.
+        void readProperties(PropertyHandler& handler) const;
+
+        /// Decodes all properties of this node, string properties are
+        /// interned in the specified pool.
+        void readProperties(PropertyHandler& handler, StringPool& pool) const;
+
+        /// Gets the number of children of this node.
+        std::size_t getChildCount() const;
+
+        /// Gets the child at the specified index.
+        Node getChild(std::size_t index) const;
+
+    private:
+        friend BinaryGraph;
+
+        explicit Node(const BinaryGraph* graph, std::uint32_t index);
+
+        const BinaryGraph* graph_;
+        std::uint32_t index_;
+    };
+
+    /// Checks whether the specified data starts with the binary magic.
+    static bool isBinary(const void* data, std::size_t size);
+
+    /// Encodes the specified node graph.
+    static std::vector<char> encode(const NodeGraph& graph);
+
+    /// Constructs a view over the specified data.
+    /// The data must outlive this view.
+    explicit BinaryGraph(const void* data, std::size_t size);
+
+    /// Checks whether the data is a well-formed binary graph.
+    bool isValid() const;
+
+    /// Gets the format version of the data.
+    std::uint32_t getVersion() const;
+
+    /// Gets the root node, the graph must be valid.
+    Node getRoot() const;
+
+    /// Decodes the whole graph.
+    NodeGraph toNodeGraph() const;
+
+    /// Decodes the whole graph, string properties are interned in the
+    /// specified pool.
+    NodeGraph toNodeGraph(StringPool& pool) const;
+
+private:
+    bool validate() const;
+
+    std::uint32_t readU32(std::size_t offset) const;
+
+    std::string getString(std::uint32_t index) const;
+    bool compareString(std::uint32_t index, const std::string& str) const;
+
+    Value getValue(std::uint32_t index) const;
+
+    /// Decodes the specified value, interning it if it is a string.
+    Value getValue(std::uint32_t index, StringPool& pool) const;
+    ValueMap getMap(std::uint32_t firstEntry, std::uint32_t count) const;
+
+    void readNode(const Node& node, NodeGraph& graph, StringPool& pool) const;
+
+    const char* data_;
+    std::size_t size_;
+
+    std::uint32_t version_;
+    std::uint32_t stringCount_;
+    std::uint32_t nodeCount_;
+    std::uint32_t entryCount_;
+    std::uint32_t valueCount_;
+    std::uint32_t wordCount_;
+
+    std::size_t stringRecordOffset_;
+    std::size_t stringDataOffset_;
+    std::size_t nodeOffset_;
+    std::size_t entryOffset_;
+    std::size_t valueOffset_;
+    std::size_t wordOffset_;
+
+    bool valid_;
+};
+} // namespace ee
+
+#endif // EE_PARSER_BINARY_GRAPH_HPP
@@ -0,0 +1,486 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ciso646>
+#include <thread>
+
+#include "interfacecompiler.hpp"
+
+#include <parser/binarygraph.hpp>
+#include <parser/graphreader.hpp>
+#include <parser/jsongraphreader.hpp>
+#include <parser/jsongraphwriter.hpp>
+#include <parser/loadplan.hpp>
+#include <parser/nodegraph.hpp>
+#include <parser/nodeloaderlibrary.hpp>
+
+#include <xxhash/xxhash.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+namespace ee {
+namespace key {
+constexpr auto node_graph = "node_graph";
+constexpr auto base_class = "base_class";
+constexpr auto custom_class = "custom_class";
+constexpr auto display_name = "display_name";
+constexpr auto prefab = "prefab";
+
+constexpr auto version = "version";
+constexpr auto binary_version = "binary_version";
+constexpr auto files = "files";
+constexpr auto size = "size";
+constexpr auto modified = "modified";
+constexpr auto hash = "hash";
+
+constexpr auto path = "path";
+constexpr auto output = "output";
+constexpr auto status = "status";
+constexpr auto nodes = "nodes";
+constexpr auto messages = "messages";
+constexpr auto strings = "strings";
+constexpr auto requested = "requested";
+constexpr auto distinct = "distinct";
+constexpr auto requested_bytes = "requested_bytes";
+constexpr auto pooled_bytes = "pooled_bytes";
+constexpr auto read_ms = "read_ms";
+constexpr auto validate_ms = "validate_ms";
+constexpr auto write_ms = "write_ms";
+constexpr auto total_ms = "total_ms";
+constexpr auto summary = "summary";
+} // namespace key
+
+namespace {
+constexpr auto manifest_name = ".interface-manifest";
+constexpr auto manifest_version = 1;
+constexpr auto input_pattern = "*.eeei";
+
+using Clock = std::chrono::steady_clock;
+
+double getElapsedMilliseconds(Clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+std::uint32_t computeHash(const char* data, std::size_t size) {
+    return XXH32(data, static_cast<int>(size), 0);
+}
+
+QJsonObject convertToJson(const StringPool::Stats& stats) {
+    QJsonObject obj;
+    obj[key::requested] = static_cast<double>(stats.requestCount);
+    obj[key::distinct] = static_cast<double>(stats.stringCount);
+    obj[key::requested_bytes] = static_cast<double>(stats.requestedBytes);
+    obj[key::pooled_bytes] = static_cast<double>(stats.pooledBytes);
+    return obj;
+}
+
+QString removeSuffix(const QString& path) {
+    auto index = path.lastIndexOf('.');
+    if (index > path.lastIndexOf('/')) {
+        return path.left(index);
+    }
+    return path;
+}
+
+/// Properties handled by the reader rather than by the loaders.
+bool isMetaKey(const std::string& name) {
+    return name == key::base_class || name == key::custom_class ||
+           name == key::display_name || name == key::prefab;
+}
+
+/// Writes the specified data atomically.
+bool writeFile(const QString& path, const char* data, std::size_t size) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (not file.open(QIODevice::OpenModeFlag::WriteOnly)) {
+        return false;
+    }
+    file.write(data, static_cast<qint64>(size));
+    return file.commit();
+}
+} // namespace
+
+using Self = InterfaceCompiler;
+
+const QString Self::OutputSuffix = ".eeib";
+
+std::vector<Self::Input> Self::collectInputs(const QStringList& paths) {
+    std::vector<Input> inputs;
+    for (auto&& path : paths) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDir directory(info.absoluteFilePath());
+            QDirIterator iter(directory.absolutePath(), {input_pattern},
+                              QDir::Filter::Files,
+                              QDirIterator::IteratorFlag::Subdirectories);
+            while (iter.hasNext()) {
+                auto filePath = iter.next();
+                inputs.push_back(
+                    Input{filePath,
+                          removeSuffix(directory.relativeFilePath(filePath))});
+            }
+        } else {
+            inputs.push_back(
+                Input{info.absoluteFilePath(), info.completeBaseName()});
+        }
+    }
+    std::sort(inputs.begin(), inputs.end(),
+              [](const Input& lhs, const Input& rhs) {
+                  return lhs.path < rhs.path;
+              });
+    return inputs;
+}
+
+const char* Self::getStatusName(Status status) {
+    switch (status) {
+    case Status::Compiled:
+        return "compiled";
+    case Status::Checked:
+        return "checked";
+    case Status::Skipped:
+        return "skipped";
+    case Status::Failed:
+        return "failed";
+    }
+    return "";
+}
+
+std::string Self::toJson(const std::vector<Result>& results) {
+    QJsonArray files;
+    QJsonObject summary;
+    StringPool::Stats strings = {};
+    for (auto&& result : results) {
+        QJsonArray messages;
+        for (auto&& message : result.messages) {
+            messages.append(QString::fromStdString(message));
+        }
+        QJsonObject obj;
+        obj[key::path] = result.path;
+        obj[key::output] = result.outputPath;
+        obj[key::status] = getStatusName(result.status);
+        obj[key::nodes] = static_cast<double>(result.nodeCount);
+        obj[key::read_ms] = result.readTime;
+        obj[key::validate_ms] = result.validateTime;
+        obj[key::write_ms] = result.writeTime;
+        obj[key::total_ms] =
+            result.readTime + result.validateTime + result.writeTime;
+        obj[key::strings] = convertToJson(result.strings);
+        obj[key::messages] = messages;
+        files.append(obj);
+
+        auto name = getStatusName(result.status);
+        summary[name] = summary.value(name).toInt() + 1;
+        strings.requestCount += result.strings.requestCount;
+        strings.stringCount += result.strings.stringCount;
+        strings.requestedBytes += result.strings.requestedBytes;
+        strings.pooledBytes += result.strings.pooledBytes;
+    }
+    summary[key::strings] = convertToJson(strings);
+
+    QJsonObject json;
+    json[key::files] = files;
+    json[key::summary] = summary;
+    return QJsonDocument(json).toJson().toStdString();
+}
+
+Self::InterfaceCompiler()
+    : library_(std::make_unique<NodeLoaderLibrary>())
+    , outputDirectory_(".")
+    , jobCount_(std::max(1u, std::thread::hardware_concurrency()))
+    , checkOnly_(false)
+    , normalize_(false)
+    , force_(false) {
+    library_->addDefaultLoaders();
+    reader_ = std::make_unique<GraphReader>(*library_);
+}
+
+Self::~InterfaceCompiler() {}
+
+void Self::setOutputDirectory(const QString& directory) {
+    outputDirectory_ = directory;
+}
+
+void Self::setJobCount(std::size_t count) {
+    jobCount_ = std::max<std::size_t>(1, count);
+}
+
+void Self::setCheckOnly(bool enabled) {
+    checkOnly_ = enabled;
+}
+
+void Self::setNormalize(bool enabled) {
+    normalize_ = enabled;
+}
+
+void Self::setForce(bool enabled) {
+    force_ = enabled;
+}
+
+std::vector<Self::Result>
+Self::compile(const std::vector<Input>& inputs) const {
+    auto manifest = checkOnly_ ? Manifest() : readManifest();
+    std::vector<Entry> entries(inputs.size());
+    std::vector<char> hasEntries(inputs.size());
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        auto iter = manifest.find(inputs[i].name.toStdString());
+        if (iter != manifest.cend()) {
+            entries[i] = iter->second;
+            hasEntries[i] = 1;
+        }
+    }
+
+    // Files are independent, hand them out one at a time so that a few
+    // large files do not leave the other threads idle.
+    std::vector<Result> results(inputs.size());
+    std::atomic<std::size_t> next(0);
+    auto worker = [&] {
+        for (auto i = next++; i < inputs.size(); i = next++) {
+            results[i] = process(inputs[i], entries[i], hasEntries[i] != 0);
+        }
+    };
+    auto workerCount = std::min(jobCount_, inputs.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < workerCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    if (not checkOnly_) {
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            auto name = inputs[i].name.toStdString();
+            if (results[i].status == Status::Failed) {
+                manifest.erase(name);
+            } else {
+                manifest[name] = entries[i];
+            }
+        }
+        if (not writeManifest(manifest)) {
+            qWarning() << "Could't write the manifest, the next compilation "
+                          "will not skip unchanged files";
+        }
+    }
+    return results;
+}
+
+QString Self::getManifestPath() const {
+    return QDir(outputDirectory_).filePath(manifest_name);
+}
+
+Self::Manifest Self::readManifest() const {
+    Manifest manifest;
+    QFile file(getManifestPath());
+    if (not file.open(QIODevice::OpenModeFlag::ReadOnly)) {
+        return manifest;
+    }
+    auto json = QJsonDocument::fromJson(file.readAll()).object();
+    if (json.value(key::version).toInt() != manifest_version ||
+        json.value(key::binary_version).toDouble() != BinaryGraph::Version) {
+        // Outputs of other format versions must be compiled again.
+        return manifest;
+    }
+    auto files = json.value(key::files).toObject();
+    for (auto iter = files.begin(); iter != files.end(); ++iter) {
+        auto obj = iter.value().toObject();
+        Entry entry;
+        entry.size = static_cast<std::int64_t>(obj.value(key::size).toDouble());
+        entry.modified =
+            static_cast<std::int64_t>(obj.value(key::modified).toDouble());
+        entry.hash =
+            static_cast<std::uint32_t>(obj.value(key::hash).toDouble());
+        manifest.emplace(iter.key().toStdString(), entry);
+    }
+    return manifest;
+}
+
+bool Self::writeManifest(const Manifest& manifest) const {
+    QJsonObject files;
+    for (auto&& elt : manifest) {
+        QJsonObject obj;
+        obj[key::size] = static_cast<double>(elt.second.size);
+        obj[key::modified] = static_cast<double>(elt.second.modified);
+        obj[key::hash] = static_cast<double>(elt.second.hash);
+        files[QString::fromStdString(elt.first)] = obj;
+    }
+    QJsonObject json;
+    json[key::version] = manifest_version;
+    json[key::binary_version] = static_cast<double>(BinaryGraph::Version);
+    json[key::files] = files;
+    auto data = QJsonDocument(json).toJson();
+    return writeFile(getManifestPath(), data.constData(),
+                     static_cast<std::size_t>(data.size()));
+}
+
+Self::Result Self::process(const Input& input, Entry& entry,
+                           bool hasEntry) const {
+    Result result;
+    result.path = input.path;
+    result.status = Status::Failed;
+    result.nodeCount = 0;
+    result.strings = {};
+    result.readTime = 0;
+    result.validateTime = 0;
+    result.writeTime = 0;
+    if (not checkOnly_) {
+        result.outputPath =
+            QDir(outputDirectory_).filePath(input.name + OutputSuffix);
+    }
+
+    auto start = Clock::now();
+    QFileInfo info(input.path);
+    auto size = static_cast<std::int64_t>(info.size());
+    auto modified =
+        static_cast<std::int64_t>(info.lastModified().toMSecsSinceEpoch());
+    auto canSkip = hasEntry && not force_ && not checkOnly_ &&
+                   QFileInfo::exists(result.outputPath);
+    if (canSkip && entry.size == size && entry.modified == modified) {
+        result.status = Status::Skipped;
+        result.readTime = getElapsedMilliseconds(start);
+        return result;
+    }
+
+    QFile file(input.path);
+    if (not file.open(QIODevice::OpenModeFlag::ReadOnly)) {
+        result.messages.push_back("could not open the file");
+        return result;
+    }
+    auto data = file.readAll();
+    auto bytes = data.constData();
+    auto byteCount = static_cast<std::size_t>(data.size());
+    auto hash = computeHash(bytes, byteCount);
+    if (canSkip && entry.hash == hash) {
+        // Touched but not modified.
+        entry.size = size;
+        entry.modified = modified;
+        result.status = Status::Skipped;
+        result.readTime = getElapsedMilliseconds(start);
+        return result;
+    }
+
+    std::optional<NodeGraph> graph;
+    StringPool pool;
+    auto isBinary = BinaryGraph::isBinary(bytes, byteCount);
+    if (isBinary) {
+        BinaryGraph binaryGraph(bytes, byteCount);
+        if (binaryGraph.isValid()) {
+            graph = binaryGraph.toNodeGraph(pool);
+        }
+    } else {
+        graph =
+            JsonGraphReader::read(bytes, byteCount, key::node_graph, pool);
+    }
+    result.strings = pool.getStats();
+    if (graph.has_value()) {
+        // Compiled files only contain packed properties.
+        reader_->migrateProperties(graph.value());
+    }
+    result.readTime = getElapsedMilliseconds(start);
+    if (not graph.has_value()) {
+        result.messages.push_back("malformed interface file");
+        return result;
+    }
+
+    start = Clock::now();
+    auto isValid = validate(graph.value(), result.messages, result.nodeCount);
+    result.validateTime = getElapsedMilliseconds(start);
+    if (not isValid) {
+        return result;
+    }
+    if (checkOnly_) {
+        result.status = Status::Checked;
+        return result;
+    }
+
+    start = Clock::now();
+    if (normalize_ && not isBinary) {
+        auto text = JsonGraphWriter::write(graph.value(), key::node_graph);
+        if (text.size() != byteCount ||
+            not std::equal(text.cbegin(), text.cend(), bytes)) {
+            if (not writeFile(input.path, text.data(), text.size())) {
+                result.messages.push_back("could not normalize the file");
+                return result;
+            }
+            info.refresh();
+            size = static_cast<std::int64_t>(info.size());
+            modified = static_cast<std::int64_t>(
+                info.lastModified().toMSecsSinceEpoch());
+            hash = computeHash(text.data(), text.size());
+        }
+    }
+    auto buffer = BinaryGraph::encode(graph.value());
+    if (not writeFile(result.outputPath, buffer.data(), buffer.size())) {
+        result.messages.push_back("could not write the output file");
+        return result;
+    }
+    result.writeTime = getElapsedMilliseconds(start);
+
+    entry.size = size;
+    entry.modified = modified;
+    entry.hash = hash;
+    result.status = Status::Compiled;
+    return result;
+}
+
+bool Self::validate(const NodeGraph& graph,
+                    std::vector<std::string>& messages,
+                    std::size_t& nodeCount) const {
+    auto isValid = true;
+
+    // Nodes are named by their index path from the root, e.g. /0/2.
+    std::vector<std::pair<const NodeGraph*, std::string>> stack;
+    stack.emplace_back(&graph, "/");
+    while (not stack.empty()) {
+        auto elt = std::move(stack.back());
+        stack.pop_back();
+        ++nodeCount;
+
+        auto&& node = *elt.first;
+        auto&& name = elt.second;
+        auto&& handler = node.getPropertyHandler();
+        auto baseClass = handler.findProperty(key::base_class);
+        if (baseClass == nullptr && node.isPrefabInstance()) {
+            // The class comes from the prefab.
+        } else if (baseClass == nullptr || not baseClass->isString()) {
+            messages.push_back("node " + name + ": missing base_class");
+            isValid = false;
+        } else if (not library_->hasLoader(baseClass->asString())) {
+            messages.push_back("node " + name + ": unknown class " +
+                               baseClass->asString());
+            isValid = false;
+        } else {
+            auto&& plan = library_->getPlan(baseClass->asString());
+            for (auto&& key : handler.getPropertyKeys()) {
+                if (not isMetaKey(key.getName()) && not plan.hasKey(key)) {
+                    messages.push_back("node " + name +
+                                       ": unused property " + key.getName());
+                }
+            }
+        }
+        auto prefab = handler.findProperty(key::prefab);
+        if (prefab != nullptr && not prefab->isString()) {
+            messages.push_back("node " + name + ": prefab is not a path");
+            isValid = false;
+        }
+
+        auto&& children = node.getChildren();
+        for (auto i = children.size(); i > 0; --i) {
+            auto separator = name.size() > 1 ? "/" : "";
+            stack.emplace_back(&children[i - 1],
+                               name + separator + std::to_string(i - 1));
+        }
+    }
+    return isValid;
+}
+} // namespace ee
@@ -0,0 +1,130 @@
+#ifndef EE_COMPILER_INTERFACE_COMPILER_HPP
+#define EE_COMPILER_INTERFACE_COMPILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <parser/stringpool.hpp>
+
+#include <QString>
+#include <QStringList>
+
+namespace ee {
+class GraphReader;
+class NodeGraph;
+class NodeLoaderLibrary;
+
+/// Validates interface files and compiles them to the binary format.
+/// Files are processed in parallel, unchanged files are skipped using a
+/// manifest kept in the output directory.
+class InterfaceCompiler final {
+private:
+    using Self = InterfaceCompiler;
+
+public:
+    /// Extension of the compiled files.
+    static const QString OutputSuffix;
+
+    enum class Status {
+        Compiled, ///< Written to the output directory.
+        Checked,  ///< Valid, nothing was written.
+        Skipped,  ///< Unchanged since the last compilation.
+        Failed    ///< Unreadable or invalid.
+    };
+
+    struct Input {
+        /// Absolute path of the interface file.
+        QString path;
+
+        /// Path of the output relative to the output directory, without the
+        /// extension.
+        QString name;
+    };
+
+    struct Result {
+        QString path;
+        QString outputPath;
+        Status status;
+
+        /// Errors when failed, warnings otherwise.
+        std::vector<std::string> messages;
+
+        std::size_t nodeCount;
+
+        /// Strings interned while reading the file.
+        StringPool::Stats strings;
+
+        /// Times spent in each step, in milliseconds.
+        double readTime;
+        double validateTime;
+        double writeTime;
+    };
+
+    /// Collects the interface files in the specified files and directories,
+    /// directories are searched recursively.
+    static std::vector<Input> collectInputs(const QStringList& paths);
+
+    static const char* getStatusName(Status status);
+
+    /// Builds the JSON timing report.
+    static std::string toJson(const std::vector<Result>& results);
+
+    InterfaceCompiler();
+    ~InterfaceCompiler();
+
+    void setOutputDirectory(const QString& directory);
+
+    /// Sets the number of files processed concurrently.
+    void setJobCount(std::size_t count);
+
+    /// Only validates the inputs, nothing is written.
+    void setCheckOnly(bool enabled);
+
+    /// Rewrites JSON inputs in the canonical form before compiling them.
+    void setNormalize(bool enabled);
+
+    /// Compiles unchanged inputs as well.
+    void setForce(bool enabled);
+
+    /// Processes the specified inputs.
+    /// @return The results, in the same order as the inputs.
+    std::vector<Result> compile(const std::vector<Input>& inputs) const;
+
+private:
+    /// What the previous compilation knew about an input.
+    struct Entry {
+        std::int64_t size;
+        std::int64_t modified;
+        std::uint32_t hash;
+    };
+
+    using Manifest = std::unordered_map<std::string, Entry>;
+
+    QString getManifestPath() const;
+    Manifest readManifest() const;
+    bool writeManifest(const Manifest& manifest) const;
+
+    /// Processes a single input.
+    /// @param entry The manifest entry of the input, updated on success.
+    Result process(const Input& input, Entry& entry, bool hasEntry) const;
+
+    /// Checks the classes and properties of every node.
+    /// @return Whether the graph is valid.
+    bool validate(const NodeGraph& graph, std::vector<std::string>& messages,
+                  std::size_t& nodeCount) const;
+
+    std::unique_ptr<NodeLoaderLibrary> library_;
+    std::unique_ptr<GraphReader> reader_;
+    QString outputDirectory_;
+    std::size_t jobCount_;
+    bool checkOnly_;
+    bool normalize_;
+    bool force_;
+};
+} // namespace ee
+
+#endif // EE_COMPILER_INTERFACE_COMPILER_HPP
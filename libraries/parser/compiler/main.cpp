@@ -0,0 +1,99 @@
+#include <chrono>
+#include <ciso646>
+#include <cstdio>
+#include <fstream>
+
+#include "interfacecompiler.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("interface-compiler");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Validates interface files and compiles them to the binary format.");
+    parser.addHelpOption();
+    parser.addPositionalArgument(
+        "inputs", "Interface files or directories searched recursively.",
+        "inputs...");
+    QCommandLineOption outputOption(
+        {"o", "output"}, "Writes the compiled files to <directory>.",
+        "directory", "generated");
+    QCommandLineOption jobsOption(
+        {"j", "jobs"}, "Processes <count> files concurrently.", "count",
+        "0");
+    QCommandLineOption checkOption("check",
+                                   "Only validates the files, writes nothing.");
+    QCommandLineOption normalizeOption(
+        "normalize", "Rewrites the files in the canonical form.");
+    QCommandLineOption forceOption("force",
+                                   "Compiles unchanged files as well.");
+    QCommandLineOption reportOption(
+        "report", "Writes the JSON timing report to <file>.", "file");
+    parser.addOption(outputOption);
+    parser.addOption(jobsOption);
+    parser.addOption(checkOption);
+    parser.addOption(normalizeOption);
+    parser.addOption(forceOption);
+    parser.addOption(reportOption);
+    parser.process(app);
+
+    auto inputs =
+        ee::InterfaceCompiler::collectInputs(parser.positionalArguments());
+    if (inputs.empty()) {
+        std::fprintf(stderr, "No interface files found\n");
+        return 1;
+    }
+
+    ee::InterfaceCompiler compiler;
+    compiler.setOutputDirectory(parser.value(outputOption));
+    auto jobCount = parser.value(jobsOption).toUInt();
+    if (jobCount > 0) {
+        compiler.setJobCount(jobCount);
+    }
+    compiler.setCheckOnly(parser.isSet(checkOption));
+    compiler.setNormalize(parser.isSet(normalizeOption));
+    compiler.setForce(parser.isSet(forceOption));
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = compiler.compile(inputs);
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::printf("%-9s %9s %9s %9s %8s  %s\n", "status", "read", "validate",
+                "write", "nodes", "file");
+    std::size_t failedCount = 0;
+    std::size_t requestedBytes = 0;
+    std::size_t pooledBytes = 0;
+    for (auto&& result : results) {
+        std::printf("%-9s %9.2f %9.2f %9.2f %8zu  %s\n",
+                    ee::InterfaceCompiler::getStatusName(result.status),
+                    result.readTime, result.validateTime, result.writeTime,
+                    result.nodeCount, qPrintable(result.path));
+        for (auto&& message : result.messages) {
+            std::printf("          %s\n", message.c_str());
+        }
+        if (result.status == ee::InterfaceCompiler::Status::Failed) {
+            ++failedCount;
+        }
+        requestedBytes += result.strings.requestedBytes;
+        pooledBytes += result.strings.pooledBytes;
+    }
+    std::printf("%zu files, %zu failed, %.2f ms\n", results.size(),
+                failedCount, elapsed.count());
+    std::printf("interned strings: %zu bytes as copies, %zu bytes pooled\n",
+                requestedBytes, pooledBytes);
+
+    if (parser.isSet(reportOption)) {
+        std::ofstream file(parser.value(reportOption).toStdString());
+        file << ee::InterfaceCompiler::toJson(results);
+        if (not file) {
+            std::fprintf(stderr, "Could not write the report\n");
+            return 1;
+        }
+    }
+    return failedCount == 0 ? 0 : 1;
+}
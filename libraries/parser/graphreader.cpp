@@ -1,47 +1,653 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ciso646>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "binarygraph.hpp"
 #include "graphreader.hpp"
+#include "loadplan.hpp"
 #include "nodegraph.hpp"
 #include "nodeinfo.hpp"
 #include "nodeloader.hpp"
 #include "propertyhandler.hpp"
 
 #include <2d/CCNode.h>
+#include <base/CCDirector.h>
+#include <platform/CCFileUtils.h>
+#include <platform/CCImage.h>
+#include <renderer/CCTextureCache.h>
 
 namespace ee {
+namespace key {
+constexpr auto base_class = "base_class";
+constexpr auto custom_class = "custom_class";
+constexpr auto prefab = "prefab";
+} // namespace key
+
+namespace {
+/// Resolves the loader name of a node without copying strings.
+/// @return nullptr if the node has no class, e.g. a prefab instance.
+const std::string* findClassName(const PropertyHandler& handler) {
+    static const Symbol baseClass(key::base_class);
+    static const Symbol customClass(key::custom_class);
+    auto custom = handler.findProperty(customClass);
+    if (custom != nullptr && custom->isString() &&
+        not custom->asString().empty()) {
+        return &custom->asString();
+    }
+    auto base = handler.findProperty(baseClass);
+    if (base == nullptr || not base->isString()) {
+        return nullptr;
+    }
+    return &base->asString();
+}
+
+/// Nodes without a class, e.g. instances of a prefab that could not be
+/// loaded, are read as plain nodes.
+const std::string& getClassName(const PropertyHandler& handler) {
+    auto name = findClassName(handler);
+    return name == nullptr ? NodeLoader::Name : *name;
+}
+
+/// Overrides the properties of the target with the specified ones.
+void mergeProperties(PropertyHandler& target,
+                     const PropertyHandler& overrides) {
+    auto&& keys = overrides.getPropertyKeys();
+    auto&& values = overrides.getPropertyValues();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        target.setProperty(keys[i], values[i]);
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+double getElapsedMilliseconds(Clock::time_point start) {
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+/// Flattens a tree in pre-order, only the structure is visited.
+template <class Tree, class GetChildCount, class GetChild>
+void flatten(const Tree& root, GetChildCount&& getChildCount,
+             GetChild&& getChild, std::vector<Tree>& nodes,
+             std::vector<std::size_t>& parents) {
+    std::vector<std::pair<Tree, std::size_t>> stack;
+    stack.emplace_back(root, PreparedGraph::NoParent);
+    while (not stack.empty()) {
+        auto elt = stack.back();
+        stack.pop_back();
+        auto index = nodes.size();
+        nodes.push_back(elt.first);
+        parents.push_back(elt.second);
+        auto childCount = getChildCount(elt.first);
+        // Push in reverse so that children are visited in order.
+        for (auto i = childCount; i > 0; --i) {
+            stack.emplace_back(getChild(elt.first, i - 1), index);
+        }
+    }
+}
+} // namespace
+
 using Self = GraphReader;
 
-Self::GraphReader() {
+/// Worker threads kept for the lifetime of the reader, so that a prepare does
+/// not pay for creating and joining threads in each of its phases.
+class Self::WorkerPool final {
+public:
+    using Function = std::function<void(std::size_t index)>;
+
+    /// @param threadCount The number of threads, the calling thread included.
+    explicit WorkerPool(std::size_t threadCount) {
+        for (std::size_t i = 1; i < threadCount; ++i) {
+            threads_.emplace_back([this] { work(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto&& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    /// Calls f(i) for every i in [0, count) and waits for all calls.
+    /// Nested or concurrent runs are executed on the calling thread only.
+    void run(std::size_t count, const Function& f) {
+        std::unique_lock<std::mutex> runLock(runMutex_, std::try_to_lock);
+        if (not runLock.owns_lock() || threads_.empty() || count < 2) {
+            for (std::size_t i = 0; i < count; ++i) {
+                f(i);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            function_ = &f;
+            count_ = count;
+            next_ = 0;
+            pendingThreads_ = threads_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        process(f, count);
+
+        // Every worker takes part in every run, even when there is nothing
+        // left, so that none of them sees the function after it is gone.
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pendingThreads_ == 0; });
+        function_ = nullptr;
+    }
+
+private:
+    void process(const Function& f, std::size_t count) {
+        for (auto i = next_++; i < count; i = next_++) {
+            f(i);
+        }
+    }
+
+    void work() {
+        std::size_t generation = 0;
+        while (true) {
+            const Function* f;
+            std::size_t count;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] {
+                    return stopping_ || generation_ != generation;
+                });
+                if (stopping_) {
+                    return;
+                }
+                generation = generation_;
+                f = function_;
+                count = count_;
+            }
+            process(*f, count);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --pendingThreads_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+
+    /// Held for the duration of a run.
+    std::mutex runMutex_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const Function* function_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::size_t pendingThreads_ = 0;
+    std::size_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+Self::GraphReader()
+    : threadCount_(std::max(1u, std::thread::hardware_concurrency())) {
     loaderLibrary_.addDefaultLoaders();
 }
 
 Self::GraphReader(const NodeLoaderLibrary& library)
-    : loaderLibrary_(library) {}
+    : loaderLibrary_(library)
+    , threadCount_(std::max(1u, std::thread::hardware_concurrency())) {}
 
 Self::~GraphReader() {}
 
+Self::WorkerPool& Self::getWorkerPool() const {
+    if (workerPool_ == nullptr) {
+        workerPool_ = std::make_unique<WorkerPool>(threadCount_);
+    }
+    return *workerPool_;
+}
+
 cocos2d::Node* Self::readDictionary(const ValueMap& dict) const {
     return readNodeGraph(NodeGraph(dict));
 }
 
 cocos2d::Node* Self::readNodeGraph(const NodeGraph& graph) const {
-    auto&& loader = getNodeLoader(graph);
-    auto node = loader->createNode();
-    node->setUserObject(NodeInfo::create());
-    auto&& propertyHandler = graph.getPropertyHandler();
-    loader->loadProperties(node, propertyHandler);
+    const Prototype* prototype = nullptr;
+    auto node = createNode(graph.getPropertyHandler(), prototype);
     for (auto&& child : graph.getChildren()) {
         auto childNode = readNodeGraph(child);
         node->addChild(childNode);
     }
+    if (prototype != nullptr) {
+        addPrototypeChildren(node, *prototype);
+    }
+    return node;
+}
+
+cocos2d::Node* Self::readBinaryGraph(const BinaryGraph& graph) const {
+    // Reuse a single handler for all nodes to avoid reallocating it.
+    PropertyHandler propertyHandler;
+    auto migrate = graph.getVersion() < BinaryGraph::PackedVersion;
+    return readBinaryNode(graph.getRoot(), propertyHandler, migrate);
+}
+
+cocos2d::Node* Self::readBinaryNode(const BinaryGraph::Node& graphNode,
+                                    PropertyHandler& propertyHandler,
+                                    bool migrate) const {
+    graphNode.readProperties(propertyHandler);
+    if (migrate) {
+        migrateProperties(propertyHandler);
+    }
+    const Prototype* prototype = nullptr;
+    auto node = createNode(propertyHandler, prototype);
+    auto childCount = graphNode.getChildCount();
+    for (std::size_t i = 0; i < childCount; ++i) {
+        auto childNode =
+            readBinaryNode(graphNode.getChild(i), propertyHandler, migrate);
+        node->addChild(childNode);
+    }
+    if (prototype != nullptr) {
+        addPrototypeChildren(node, *prototype);
+    }
     return node;
 }
 
+cocos2d::Node* Self::createNode(const PropertyHandler& propertyHandler,
+                                const Prototype*& prototype) const {
+    prototype = getPrototype(propertyHandler);
+    if (prototype == nullptr) {
+        auto&& plan = getLoadPlan(propertyHandler);
+        auto node = plan.createNode();
+        NodeInfo::attach(node);
+        plan.execute(node, propertyHandler);
+        return node;
+    }
+    // Instance properties override the ones of the prefab's root.
+    auto properties = prototype->front().properties;
+    mergeProperties(properties, propertyHandler);
+    auto&& plan = getLoadPlan(properties);
+    auto node = plan.createNode();
+    NodeInfo::attach(node);
+    plan.execute(node, properties);
+    return node;
+}
+
+void Self::addPrototypeChildren(cocos2d::Node* node,
+                                const Prototype& prototype) const {
+    std::vector<cocos2d::Node*> nodes;
+    nodes.reserve(prototype.size());
+    nodes.push_back(node);
+    for (std::size_t i = 1; i < prototype.size(); ++i) {
+        auto&& instruction = prototype[i];
+        auto child = instruction.plan->createNode();
+        NodeInfo::attach(child).setFromPrefab(true);
+        instruction.plan->execute(child, instruction.properties);
+        nodes[instruction.parent]->addChild(child);
+        nodes.push_back(child);
+    }
+}
+
+void Self::setThreadCount(std::size_t count) {
+    auto threadCount = std::max<std::size_t>(1, count);
+    if (threadCount != threadCount_) {
+        threadCount_ = threadCount;
+        workerPool_.reset();
+    }
+}
+
+std::size_t Self::getThreadCount() const {
+    return threadCount_;
+}
+
+PreparedGraph Self::prepare(const NodeGraph& graph) const {
+    auto start = Clock::now();
+    PreparedGraph result;
+    result.instructions_ = makeInstructions(graph);
+    finishPrepare(result);
+    result.prepareTime_ = getElapsedMilliseconds(start);
+    return result;
+}
+
+PreparedGraph Self::prepare(const BinaryGraph& graph) const {
+    auto start = Clock::now();
+    std::vector<BinaryGraph::Node> nodes;
+    std::vector<std::size_t> parents;
+    flatten(graph.getRoot(),
+            [](const BinaryGraph::Node& node) { return node.getChildCount(); },
+            [](const BinaryGraph::Node& node, std::size_t index) {
+                return node.getChild(index);
+            },
+            nodes, parents);
+
+    PreparedGraph result;
+    auto&& instructions = result.instructions_;
+    instructions.resize(nodes.size());
+    getWorkerPool().run(nodes.size(), [&](std::size_t i) {
+        auto&& instruction = instructions[i];
+        instruction.parent = parents[i];
+        nodes[i].readProperties(instruction.properties);
+    });
+    if (graph.getVersion() < BinaryGraph::PackedVersion) {
+        // Resolving a plan may load a prefab, which is not thread-safe, so
+        // plans are resolved here and only the conversion is parallel.
+        static const Symbol baseClass(key::base_class);
+        std::vector<const LoadPlan*> plans(instructions.size());
+        for (std::size_t i = 0; i < instructions.size(); ++i) {
+            auto&& properties = instructions[i].properties;
+            // Same rule as migrateProperties.
+            if (properties.hasProperty(baseClass)) {
+                plans[i] = &getLoadPlan(properties);
+            }
+        }
+        getWorkerPool().run(instructions.size(), [&](std::size_t i) {
+            if (plans[i] != nullptr) {
+                plans[i]->migrate(instructions[i].properties);
+            }
+        });
+    }
+    expandPrefabs(instructions);
+    finishPrepare(result);
+    result.prepareTime_ = getElapsedMilliseconds(start);
+    return result;
+}
+
+std::vector<Self::Instruction>
+Self::makeInstructions(const NodeGraph& graph) const {
+    std::vector<const NodeGraph*> nodes;
+    std::vector<std::size_t> parents;
+    flatten(&graph,
+            [](const NodeGraph* node) { return node->getChildren().size(); },
+            [](const NodeGraph* node, std::size_t index) {
+                return &node->getChild(index);
+            },
+            nodes, parents);
+
+    std::vector<Instruction> instructions(nodes.size());
+    getWorkerPool().run(nodes.size(), [&](std::size_t i) {
+        auto&& instruction = instructions[i];
+        instruction.parent = parents[i];
+        instruction.properties = nodes[i]->getPropertyHandler();
+    });
+    expandPrefabs(instructions);
+    return instructions;
+}
+
+const Self::Prototype*
+Self::getPrototype(const PropertyHandler& propertyHandler) const {
+    static const Symbol prefab(key::prefab);
+    if (not prefabLoader_) {
+        return nullptr;
+    }
+    auto value = propertyHandler.findProperty(prefab);
+    if (value == nullptr || not value->isString() ||
+        value->asString().empty()) {
+        return nullptr;
+    }
+    auto&& path = value->asString();
+    auto iter = prototypes_.find(path);
+    if (iter != prototypes_.cend()) {
+        return iter->second.get();
+    }
+    if (loadingPrefabs_.count(path) != 0) {
+        CCLOG("GraphReader: prefab %s contains itself", path.c_str());
+        return nullptr;
+    }
+    loadingPrefabs_.insert(path);
+    std::shared_ptr<Prototype> prototype;
+    auto graph = prefabLoader_(path);
+    if (graph.has_value()) {
+        prototype = std::make_shared<Prototype>(makeInstructions(*graph));
+        for (auto&& instruction : *prototype) {
+            instruction.plan =
+                &loaderLibrary_.getPlan(getClassName(instruction.properties));
+        }
+    } else {
+        CCLOG("GraphReader: could not load prefab %s", path.c_str());
+    }
+    loadingPrefabs_.erase(path);
+
+    // Failures are cached as well, so that a missing prefab is not loaded
+    // again for every instance.
+    prototypes_[path] = prototype;
+    return prototype.get();
+}
+
+void Self::expandPrefabs(std::vector<Instruction>& instructions) const {
+    auto count = instructions.size();
+    std::vector<const Prototype*> prototypes(count);
+    auto hasInstances = false;
+    for (std::size_t i = 0; i < count; ++i) {
+        prototypes[i] = getPrototype(instructions[i].properties);
+        hasInstances = hasInstances || prototypes[i] != nullptr;
+    }
+    if (not hasInstances) {
+        return;
+    }
+
+    // The subtree of an instruction ends before ends[i], in pre-order.
+    std::vector<std::size_t> ends(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        ends[i] = i + 1;
+    }
+    for (auto i = count; i-- > 1;) {
+        auto&& end = ends[instructions[i].parent];
+        end = std::max(end, ends[i]);
+    }
+
+    std::vector<Instruction> result;
+    std::vector<std::size_t> indices(count);
+
+    // Instances whose prototype children are appended once their own
+    // subtree ends, innermost last.
+    std::vector<std::size_t> pending;
+    auto appendPending = [&](std::size_t position) {
+        while (not pending.empty() && ends[pending.back()] <= position) {
+            auto instance = pending.back();
+            pending.pop_back();
+            auto&& prototype = *prototypes[instance];
+            auto base = result.size();
+            for (std::size_t j = 1; j < prototype.size(); ++j) {
+                auto instruction = prototype[j];
+                instruction.fromPrefab = true;
+                instruction.parent = instruction.parent == 0
+                                         ? indices[instance]
+                                         : base + instruction.parent - 1;
+                result.push_back(std::move(instruction));
+            }
+        }
+    };
+    for (std::size_t i = 0; i < count; ++i) {
+        appendPending(i);
+        auto&& instruction = instructions[i];
+        if (instruction.parent != PreparedGraph::NoParent) {
+            instruction.parent = indices[instruction.parent];
+        }
+        if (prototypes[i] != nullptr) {
+            // Instance properties override the ones of the prefab's root.
+            auto properties = prototypes[i]->front().properties;
+            mergeProperties(properties, instruction.properties);
+            instruction.properties = std::move(properties);
+            pending.push_back(i);
+        }
+        indices[i] = result.size();
+        result.push_back(std::move(instruction));
+    }
+    appendPending(count);
+    instructions = std::move(result);
+}
+
+std::vector<std::string>
+Self::getUncachedTextures(const NodeGraph& graph) const {
+    auto instructions = makeInstructions(graph);
+    resolvePlans(instructions);
+    return findUncachedTextures(instructions);
+}
+
+void Self::resolvePlans(std::vector<Instruction>& instructions) const {
+    getWorkerPool().run(instructions.size(), [&](std::size_t i) {
+        // Prefabs are already expanded.
+        auto&& instruction = instructions[i];
+        instruction.plan =
+            &loaderLibrary_.getPlan(getClassName(instruction.properties));
+    });
+}
+
+std::vector<std::string> Self::findUncachedTextures(
+    const std::vector<Instruction>& instructions) const {
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    auto textureCache = cocos2d::Director::getInstance()->getTextureCache();
+    std::unordered_set<std::string> paths;
+    for (auto&& instruction : instructions) {
+        for (auto&& key : instruction.plan->getTextureKeys()) {
+            auto value = instruction.properties.findProperty(key);
+            if (value == nullptr || not value->isString() ||
+                value->asString().empty()) {
+                continue;
+            }
+            auto path = fileUtils->fullPathForFilename(value->asString());
+            if (path.empty() ||
+                textureCache->getTextureForKey(path) != nullptr) {
+                continue;
+            }
+            paths.insert(path);
+        }
+    }
+    return std::vector<std::string>(paths.cbegin(), paths.cend());
+}
+
+void Self::finishPrepare(PreparedGraph& graph) const {
+    auto&& instructions = graph.instructions_;
+    resolvePlans(instructions);
+
+    // File utils and the texture cache are not thread-safe, resolve paths
+    // here and only decode on the workers.
+    auto&& textures = graph.textures_;
+    for (auto&& path : findUncachedTextures(instructions)) {
+        textures.emplace_back(path, nullptr);
+    }
+    auto fileUtils = cocos2d::FileUtils::getInstance();
+    getWorkerPool().run(textures.size(), [&](std::size_t i) {
+        auto&& texture = textures[i];
+        auto data = fileUtils->getDataFromFile(texture.first);
+        auto image = new cocos2d::Image();
+        if (data.isNull() ||
+            not image->initWithImageData(data.getBytes(), data.getSize())) {
+            image->release();
+            return;
+        }
+        texture.second = image;
+    });
+    textures.erase(std::remove_if(textures.begin(), textures.end(),
+                                  [](const std::pair<std::string,
+                                                     cocos2d::Image*>& elt) {
+                                      return elt.second == nullptr;
+                                  }),
+                   textures.end());
+    graph.decodedTextureCount_ = textures.size();
+}
+
+cocos2d::Node* Self::instantiate(PreparedGraph& graph) const {
+    auto start = Clock::now();
+    auto textureCache = cocos2d::Director::getInstance()->getTextureCache();
+    for (auto&& texture : graph.textures_) {
+        textureCache->addImage(texture.second, texture.first);
+    }
+    graph.releaseTextures();
+
+    auto&& instructions = graph.getInstructions();
+    std::vector<cocos2d::Node*> nodes;
+    nodes.reserve(instructions.size());
+    for (auto&& instruction : instructions) {
+        auto node = instruction.plan->createNode();
+        NodeInfo::attach(node).setFromPrefab(instruction.fromPrefab);
+        instruction.plan->execute(node, instruction.properties);
+        if (instruction.parent != PreparedGraph::NoParent) {
+            nodes[instruction.parent]->addChild(node);
+        }
+        nodes.push_back(node);
+    }
+    graph.instantiateTime_ = getElapsedMilliseconds(start);
+    CCLOG("GraphReader: prepared %zu nodes and %zu textures in %.2f ms "
+          "(%zu threads), instantiated in %.2f ms",
+          instructions.size(), graph.getDecodedTextureCount(),
+          graph.getPrepareTime(), threadCount_, graph.getInstantiateTime());
+    return nodes.empty() ? nullptr : nodes.front();
+}
+
+void Self::setPrefabLoader(const PrefabLoader& loader) {
+    prefabLoader_ = loader;
+    clearPrefabs();
+}
+
+void Self::removePrefab(const std::string& path) {
+    prototypes_.erase(path);
+}
+
+void Self::clearPrefabs() {
+    prototypes_.clear();
+}
+
+void Self::migrateProperties(NodeGraph& graph) const {
+    migrateProperties(graph.getPropertyHandler());
+    for (auto&& child : graph.getChildren()) {
+        migrateProperties(child);
+    }
+}
+
+void Self::migrateProperties(PropertyHandler& propertyHandler) const {
+    static const Symbol baseClass(key::base_class);
+    // Prefab instances may leave their class to the prefab.
+    if (not propertyHandler.hasProperty(baseClass)) {
+        return;
+    }
+    getLoadPlan(propertyHandler).migrate(propertyHandler);
+}
+
+void Self::addDefaultProperties(NodeGraph& graph) const {
+    // Defaults would hide the properties of the prefab.
+    if (not graph.isPrefabInstance()) {
+        auto&& propertyHandler = graph.getPropertyHandler();
+        auto&& defaults = getLoadPlan(propertyHandler).getDefaults();
+        auto&& keys = defaults.getPropertyKeys();
+        auto&& values = defaults.getPropertyValues();
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (not propertyHandler.hasProperty(keys[i])) {
+                propertyHandler.setProperty(keys[i], values[i]);
+            }
+        }
+    }
+    for (auto&& child : graph.getChildren()) {
+        addDefaultProperties(child);
+    }
+}
 
 const NodeLoaderPtr& Self::getNodeLoader(const NodeGraph& graph) const {
-    auto baseClass = graph.getBaseClass();
-    auto customClass = graph.getCustomClass();
-    auto className = (customClass.empty() ? baseClass : customClass);
-    auto&& loader = loaderLibrary_.getLoader(className);
-    return loader;
+    auto&& className = getInstanceClassName(graph.getPropertyHandler());
+    return loaderLibrary_.getLoader(className);
+}
+
+const LoadPlan& Self::getLoadPlan(const PropertyHandler& handler) const {
+    return loaderLibrary_.getPlan(getInstanceClassName(handler));
+}
+
+const std::string&
+Self::getInstanceClassName(const PropertyHandler& handler) const {
+    auto name = findClassName(handler);
+    if (name != nullptr) {
+        return *name;
+    }
+    // Instances may leave their class to the prefab's root.
+    auto prototype = getPrototype(handler);
+    if (prototype != nullptr) {
+        return getClassName(prototype->front().properties);
+    }
+    return NodeLoader::Name;
 }
 
 const NodeLoaderLibrary& Self::getNodeLoaderLibrary() const {
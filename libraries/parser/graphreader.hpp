@@ -2,22 +2,38 @@
 #define EE_PARSER_GRAPH_READER_HPP
 
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
+#include "binarygraph.hpp"
+#include "optional.hpp"
 #include "nodeloaderlibrary.hpp"
 #include "parserfwd.hpp"
+#include "preparedgraph.hpp"
 
 namespace cocos2d {
 class Node;
 } // namespace cocos2d
 
 namespace ee {
+class LoadPlan;
 class NodeGraph;
 class NodeLoaderLibrary;
 
 /// Build node graph.
 class GraphReader final {
+private:
+    using Self = GraphReader;
+
 public:
+    /// Loads the node graph of the interface at the specified path.
+    /// @return std::nullopt if the interface could not be loaded.
+    using PrefabLoader =
+        std::function<std::optional<NodeGraph>(const std::string& path)>;
+
     /// Constructs an empty graph reader (no loader library).
     GraphReader();
 
@@ -30,12 +46,123 @@ public:
     cocos2d::Node* readDictionary(const ValueMap& dict) const;
     cocos2d::Node* readNodeGraph(const NodeGraph& graph) const;
 
+    /// Builds the node graph directly from the binary format without
+    /// decoding it to an intermediate node graph.
+    /// @param graph The binary graph, must be valid.
+    cocos2d::Node* readBinaryGraph(const BinaryGraph& graph) const;
+
+    /// Sets the number of threads used by prepare, including the calling
+    /// thread. Defaults to the hardware concurrency.
+    void setThreadCount(std::size_t count);
+    std::size_t getThreadCount() const;
+
+    /// First phase of the two-phase reader: decodes properties, resolves
+    /// load plans and pre-decodes textures on worker threads.
+    /// Must be called from the cocos2d thread.
+    PreparedGraph prepare(const NodeGraph& graph) const;
+    PreparedGraph prepare(const BinaryGraph& graph) const;
+
+    /// Second phase of the two-phase reader: uploads the textures and
+    /// creates the nodes. Must be called from the cocos2d thread.
+    /// @return The root node, nullptr if the prepared graph is empty.
+    cocos2d::Node* instantiate(PreparedGraph& graph) const;
+
+    /// Gets the resolved paths of the textures referenced by the specified
+    /// graph that are not in the texture cache yet, e.g. to decode them
+    /// ahead of prepare. Must be called from the cocos2d thread.
+    std::vector<std::string> getUncachedTextures(const NodeGraph& graph) const;
+
+    /// Sets the loader of prefabs, prefab instances are read as plain nodes
+    /// when there is no loader.
+    void setPrefabLoader(const PrefabLoader& loader);
+
+    /// Discards the prototype of the specified prefab, e.g. when its file
+    /// changed.
+    void removePrefab(const std::string& path);
+
+    /// Discards all prefab prototypes.
+    void clearPrefabs();
+
+    /// Recursively converts the properties written by older versions, e.g.
+    /// the per-component position_x and position_y, to their current form.
+    void migrateProperties(NodeGraph& graph) const;
+
+    /// Recursively adds the properties of default nodes that are missing
+    /// from the specified graph, prefab instances only keep their overrides.
+    void addDefaultProperties(NodeGraph& graph) const;
+
+    /// Gets the compiled load plan for the class of the specified node.
+    /// Prefab instances without a class use the class of the prefab's root,
+    /// nodes without any class are read as plain nodes.
+    const LoadPlan& getLoadPlan(const PropertyHandler& handler) const;
+
     const NodeLoaderPtr& getNodeLoader(const NodeGraph& graph) const;
     const NodeLoaderLibrary& getNodeLoaderLibrary() const;
 
 protected:
 private:
+    using Instruction = PreparedGraph::Instruction;
+
+    class WorkerPool;
+
+    /// Decoded nodes of a prefab, shared by all its instances.
+    using Prototype = std::vector<Instruction>;
+
+    /// @param migrate Whether the graph was written by an older version.
+    cocos2d::Node* readBinaryNode(const BinaryGraph::Node& graphNode,
+                                  PropertyHandler& propertyHandler,
+                                  bool migrate) const;
+
+    void migrateProperties(PropertyHandler& propertyHandler) const;
+
+    /// Creates a node, or the root of a prefab instance.
+    /// @param prototype Set to the prototype of the instance, if any.
+    cocos2d::Node* createNode(const PropertyHandler& propertyHandler,
+                              const Prototype*& prototype) const;
+
+    /// Creates the children of a prefab instance.
+    void addPrototypeChildren(cocos2d::Node* node,
+                              const Prototype& prototype) const;
+
+    /// Resolves the class of a node, the prefab may be loaded.
+    const std::string&
+    getInstanceClassName(const PropertyHandler& handler) const;
+
+    /// Decodes the nodes of a graph, prefab instances are expanded.
+    std::vector<Instruction> makeInstructions(const NodeGraph& graph) const;
+
+    /// Gets the prototype of a prefab instance.
+    /// @return nullptr if the node is not an instance, or if the prefab could
+    /// not be loaded.
+    const Prototype* getPrototype(const PropertyHandler& propertyHandler) const;
+
+    /// Splices the nodes of the prototypes into the instructions.
+    void expandPrefabs(std::vector<Instruction>& instructions) const;
+
+    /// Resolves the load plan of every instruction.
+    void resolvePlans(std::vector<Instruction>& instructions) const;
+
+    /// Finds the textures of the instructions not yet cached, the load plans
+    /// must be resolved.
+    std::vector<std::string>
+    findUncachedTextures(const std::vector<Instruction>& instructions) const;
+
+    /// Resolves load plans, then finds and decodes textures not yet cached.
+    void finishPrepare(PreparedGraph& graph) const;
+
+    /// Gets the worker threads, created on first use.
+    WorkerPool& getWorkerPool() const;
+
     NodeLoaderLibrary loaderLibrary_;
+    std::size_t threadCount_;
+    mutable std::unique_ptr<WorkerPool> workerPool_;
+
+    PrefabLoader prefabLoader_;
+    mutable std::unordered_map<std::string, std::shared_ptr<const Prototype>>
+        prototypes_;
+
+    /// Prefabs being loaded, detects instances that contain themselves.
+    mutable std::unordered_set<std::string> loadingPrefabs_;
 };
 } // namespace ee
 
@@ -0,0 +1,290 @@
+#include <ciso646>
+#include <limits>
+#include <vector>
+
+#include "jsongraphreader.hpp"
+#include "stringpool.hpp"
+
+#include <json/memorystream.h>
+#include <json/reader.h>
+
+namespace ee {
+namespace key {
+constexpr auto children = "children";
+constexpr auto properties = "properties";
+} // namespace key
+
+namespace {
+/// Receives the parser events and builds the node graph.
+class Handler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+public:
+    explicit Handler(const std::string& rootKey, StringPool& pool)
+        : rootKey_(rootKey)
+        , pool_(pool)
+        , skipDepth_(0)
+        , found_(false) {}
+
+    std::optional<NodeGraph> takeGraph() {
+        if (not found_) {
+            return std::nullopt;
+        }
+        return std::move(graph_);
+    }
+
+    bool Null() { return addValue(Value()); }
+    bool Bool(bool value) { return addValue(Value(value)); }
+    bool Int(int value) { return addValue(Value(value)); }
+
+    bool Uint(unsigned value) {
+        if (value <= static_cast<unsigned>(std::numeric_limits<int>::max())) {
+            return addValue(Value(static_cast<int>(value)));
+        }
+        return addValue(Value(static_cast<float>(value)));
+    }
+
+    bool Int64(std::int64_t value) {
+        return addValue(Value(static_cast<float>(value)));
+    }
+
+    bool Uint64(std::uint64_t value) {
+        return addValue(Value(static_cast<float>(value)));
+    }
+
+    bool Double(double value) {
+        return addValue(Value(static_cast<float>(value)));
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool copy) {
+        (void)copy;
+        if (skipDepth_ == 0 && not frames_.empty() &&
+            frames_.back().state == State::Properties) {
+            // Property strings, e.g. class names and texture paths, repeat
+            // across nodes.
+            return addValue(pool_.intern(str, length));
+        }
+        return addValue(Value(std::string(str, length)));
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+        (void)copy;
+        if (skipDepth_ == 0) {
+            key_.assign(str, length);
+        }
+        return true;
+    }
+
+    bool StartObject() {
+        if (skipDepth_ > 0) {
+            ++skipDepth_;
+            return true;
+        }
+        if (frames_.empty()) {
+            if (rootKey_.empty()) {
+                pushNode(&graph_);
+            } else {
+                frames_.push_back(Frame{State::Root, nullptr});
+            }
+            return true;
+        }
+        auto&& frame = frames_.back();
+        switch (frame.state) {
+        case State::Root:
+            if (key_ == rootKey_ && not found_) {
+                pushNode(&graph_);
+            } else {
+                skipDepth_ = 1;
+            }
+            return true;
+        case State::Node:
+            if (key_ == key::properties) {
+                properties_.clear();
+                frames_.push_back(Frame{State::Properties, frame.node});
+            } else {
+                skipDepth_ = 1;
+            }
+            return true;
+        case State::Children: {
+            auto&& children = frame.node->getChildren();
+            children.emplace_back();
+            pushNode(&children.back());
+            return true;
+        }
+        case State::Properties:
+        case State::Value:
+            pushValue(Value(ValueMap()));
+            return true;
+        }
+        return false;
+    }
+
+    bool EndObject(rapidjson::SizeType memberCount) {
+        (void)memberCount;
+        return end();
+    }
+
+    bool StartArray() {
+        if (skipDepth_ > 0) {
+            ++skipDepth_;
+            return true;
+        }
+        if (frames_.empty()) {
+            return false;
+        }
+        auto&& frame = frames_.back();
+        switch (frame.state) {
+        case State::Node:
+            if (key_ == key::children) {
+                frames_.push_back(Frame{State::Children, frame.node});
+            } else {
+                skipDepth_ = 1;
+            }
+            return true;
+        case State::Root:
+        case State::Children:
+            skipDepth_ = 1;
+            return true;
+        case State::Properties:
+        case State::Value:
+            pushValue(Value(ValueList()));
+            return true;
+        }
+        return false;
+    }
+
+    bool EndArray(rapidjson::SizeType elementCount) {
+        (void)elementCount;
+        return end();
+    }
+
+private:
+    enum class State {
+        /// Top-level object containing the node graph.
+        Root,
+
+        /// Node object.
+        Node,
+
+        /// Properties of a node.
+        Properties,
+
+        /// Children array of a node.
+        Children,
+
+        /// List or map inside a property value.
+        Value,
+    };
+
+    struct Frame {
+        State state;
+        NodeGraph* node;
+    };
+
+    void pushNode(NodeGraph* node) {
+        found_ = true;
+        frames_.push_back(Frame{State::Node, node});
+    }
+
+    void pushValue(Value&& value) {
+        // The key is overwritten by nested members, keep it.
+        values_.emplace_back(key_, std::move(value));
+        frames_.push_back(Frame{State::Value, frames_.back().node});
+    }
+
+    bool end() {
+        if (skipDepth_ > 0) {
+            --skipDepth_;
+            return true;
+        }
+        auto frame = frames_.back();
+        frames_.pop_back();
+        if (frame.state == State::Properties) {
+            flushProperties(*frame.node);
+            return true;
+        }
+        if (frame.state != State::Value) {
+            return true;
+        }
+        auto elt = std::move(values_.back());
+        values_.pop_back();
+        key_ = std::move(elt.first);
+        if (elt.second.isMap()) {
+            // Packed values are written in their tagged form.
+            auto packed = Value::fromTagged(elt.second.asMap());
+            if (packed.has_value()) {
+                return addValue(std::move(packed.value()));
+            }
+        }
+        return addValue(std::move(elt.second));
+    }
+
+    bool addValue(Value&& value) {
+        if (skipDepth_ > 0 || frames_.empty()) {
+            return true;
+        }
+        auto&& frame = frames_.back();
+        switch (frame.state) {
+        case State::Properties:
+            properties_.emplace_back(Symbol(key_), std::move(value));
+            return true;
+        case State::Value: {
+            auto&& container = values_.back().second;
+            if (container.isList()) {
+                container.asList().push_back(std::move(value));
+            } else {
+                container.asMap()[key_] = std::move(value);
+            }
+            return true;
+        }
+        case State::Root:
+        case State::Node:
+        case State::Children:
+            // Unknown members are ignored.
+            return true;
+        }
+        return false;
+    }
+
+    /// Sets the buffered properties at once to allocate them only once.
+    void flushProperties(NodeGraph& node) {
+        auto&& handler = node.getPropertyHandler();
+        handler.reserve(handler.getPropertyCount() + properties_.size());
+        for (auto&& elt : properties_) {
+            handler.setProperty(elt.first, std::move(elt.second));
+        }
+        properties_.clear();
+    }
+
+    std::string rootKey_;
+    StringPool& pool_;
+    NodeGraph graph_;
+    std::vector<Frame> frames_;
+    std::vector<std::pair<std::string, Value>> values_;
+
+    /// Properties of the current node, reused across nodes.
+    std::vector<std::pair<Symbol, Value>> properties_;
+    std::string key_;
+    std::size_t skipDepth_;
+    bool found_;
+};
+} // namespace
+
+using Self = JsonGraphReader;
+
+std::optional<NodeGraph> Self::read(const char* data, std::size_t size,
+                                    const std::string& key) {
+    StringPool pool;
+    return read(data, size, key, pool);
+}
+
+std::optional<NodeGraph> Self::read(const char* data, std::size_t size,
+                                    const std::string& key, StringPool& pool) {
+    rapidjson::MemoryStream stream(data, size);
+    rapidjson::Reader reader;
+    Handler handler(key, pool);
+    if (reader.Parse(stream, handler).IsError()) {
+        return std::nullopt;
+    }
+    return handler.takeGraph();
+}
+} // namespace ee
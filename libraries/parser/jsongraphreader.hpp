@@ -0,0 +1,38 @@
+#ifndef EE_PARSER_JSON_GRAPH_READER_HPP
+#define EE_PARSER_JSON_GRAPH_READER_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "nodegraph.hpp"
+#include "optional.hpp"
+
+namespace ee {
+class StringPool;
+
+/// Builds node graphs from JSON text in a single pass, properties are set
+/// directly from the parser events without an intermediate document.
+class JsonGraphReader final {
+private:
+    using Self = JsonGraphReader;
+
+public:
+    /// Parses a node graph.
+    /// @param data The JSON text, does not need to be null-terminated.
+    /// @param size The size of the JSON text in bytes.
+    /// @param key The member of the top-level object holding the node graph,
+    /// empty if the top-level object is the node graph itself.
+    /// @return The node graph, std::nullopt if the text is malformed or does
+    /// not contain the node graph.
+    static std::optional<NodeGraph> read(const char* data, std::size_t size,
+                                         const std::string& key = "");
+
+    /// Parses a node graph, property strings are interned in the specified
+    /// pool.
+    static std::optional<NodeGraph> read(const char* data, std::size_t size,
+                                         const std::string& key,
+                                         StringPool& pool);
+};
+} // namespace ee
+
+#endif // EE_PARSER_JSON_GRAPH_READER_HPP
@@ -0,0 +1,102 @@
+#include <ciso646>
+
+#include "jsongraphwriter.hpp"
+
+#include <json/prettywriter.h>
+#include <json/stringbuffer.h>
+
+namespace ee {
+namespace key {
+constexpr auto children = "children";
+constexpr auto properties = "properties";
+} // namespace key
+
+namespace {
+using Writer = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+void writeString(Writer& writer, const std::string& str) {
+    writer.String(str.c_str(), static_cast<rapidjson::SizeType>(str.size()));
+}
+
+void writeKey(Writer& writer, const std::string& str) {
+    writer.Key(str.c_str(), static_cast<rapidjson::SizeType>(str.size()));
+}
+
+void writeValue(Writer& writer, const Value& value);
+
+void writeMap(Writer& writer, const ValueMap& dict) {
+    writer.StartObject();
+    for (auto&& entry : dict) {
+        writeKey(writer, entry.first);
+        writeValue(writer, entry.second);
+    }
+    writer.EndObject();
+}
+
+void writeValue(Writer& writer, const Value& value) {
+    switch (value.getType()) {
+    case Value::Type::None:
+        writer.Null();
+        break;
+    case Value::Type::Bool:
+        writer.Bool(value.getBool().value());
+        break;
+    case Value::Type::Int:
+        writer.Int(value.getInt().value());
+        break;
+    case Value::Type::Float:
+        writer.Double(static_cast<double>(value.getFloat().value()));
+        break;
+    case Value::Type::String:
+        writeString(writer, value.asString());
+        break;
+    case Value::Type::List:
+        writer.StartArray();
+        for (auto&& item : value.asList()) {
+            writeValue(writer, item);
+        }
+        writer.EndArray();
+        break;
+    case Value::Type::Map:
+        writeMap(writer, value.asMap());
+        break;
+    case Value::Type::Vec2:
+    case Value::Type::Size:
+    case Value::Type::Color:
+    case Value::Type::Rect:
+    case Value::Type::Blend:
+        writeMap(writer, value.toTagged());
+        break;
+    }
+}
+
+void writeNode(Writer& writer, const NodeGraph& graph) {
+    writer.StartObject();
+    writeKey(writer, key::children);
+    writer.StartArray();
+    for (auto&& child : graph.getChildren()) {
+        writeNode(writer, child);
+    }
+    writer.EndArray();
+    writeKey(writer, key::properties);
+    writeMap(writer, graph.getPropertyHandler().getProperties());
+    writer.EndObject();
+}
+} // namespace
+
+using Self = JsonGraphWriter;
+
+std::string Self::write(const NodeGraph& graph, const std::string& key) {
+    rapidjson::StringBuffer buffer;
+    Writer writer(buffer);
+    if (key.empty()) {
+        writeNode(writer, graph);
+    } else {
+        writer.StartObject();
+        writeKey(writer, key);
+        writeNode(writer, graph);
+        writer.EndObject();
+    }
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+} // namespace ee
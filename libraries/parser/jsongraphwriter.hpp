@@ -0,0 +1,25 @@
+#ifndef EE_PARSER_JSON_GRAPH_WRITER_HPP
+#define EE_PARSER_JSON_GRAPH_WRITER_HPP
+
+#include <string>
+
+#include "nodegraph.hpp"
+
+namespace ee {
+/// Writes node graphs as JSON text, the counterpart of JsonGraphReader.
+class JsonGraphWriter final {
+private:
+    using Self = JsonGraphWriter;
+
+public:
+    /// Writes a node graph, members are sorted by name so that equal graphs
+    /// produce the same text.
+    /// @param graph The node graph.
+    /// @param key The member of the top-level object holding the node graph,
+    /// empty if the top-level object is the node graph itself.
+    static std::string write(const NodeGraph& graph,
+                             const std::string& key = "");
+};
+} // namespace ee
+
+#endif // EE_PARSER_JSON_GRAPH_WRITER_HPP
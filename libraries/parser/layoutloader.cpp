@@ -18,23 +18,20 @@ const PropertyColor3B Self::Property::BackgroundColor(
 
 const PropertyInt Self::Property::BackgroundColorOpacity(
     "background_color_opacity",
-    Helper::makeReader<int>(std::mem_fn(&Target::getBackGroundColorOpacity)),
-    Helper::makeWriter<int>(std::mem_fn(&Target::setBackGroundColorOpacity)));
+    Helper::makeAccessor<int, &Target::getBackGroundColorOpacity,
+                         &Target::setBackGroundColorOpacity>());
 
 const PropertyEnum<Target::BackGroundColorType>
     Self::Property::BackgroundColorType(
         "background_color_type",
-        Helper::makeReader<Target::BackGroundColorType>(
-            std::mem_fn(&Target::getBackGroundColorType)),
-        Helper::makeWriter<Target::BackGroundColorType>(
-            std::mem_fn(&Target::setBackGroundColorType)));
+        Helper::makeAccessor<Target::BackGroundColorType, //
+                             &Target::getBackGroundColorType,
+                             &Target::setBackGroundColorType>());
 
 const PropertyPoint Self::Property::BackgroundColorVector(
     "background_color_vector",
-    Helper::makeReader<cocos2d::Point>(
-        std::mem_fn(&Target::getBackGroundColorVector)),
-    Helper::makeWriter<cocos2d::Point>(
-        std::mem_fn(&Target::setBackGroundColorVector)));
+    Helper::makeAccessor<cocos2d::Point, &Target::getBackGroundColorVector,
+                         &Target::setBackGroundColorVector>());
 
 // const PropertyColor3B<Target> BackgroundEndColor("background_end_color",
 // std::mem_fn(&Target::getBackGroundEndColor),
@@ -43,22 +40,18 @@ const PropertyPoint Self::Property::BackgroundColorVector(
 
 const PropertyRect Self::Property::BackgroundImageCapInsets(
     "background_image_cap_insets",
-    Helper::makeReader<cocos2d::Rect>(
-        std::mem_fn(&Target::getBackGroundImageCapInsets)),
-    Helper::makeWriter<cocos2d::Rect>(
-        std::mem_fn(&Target::setBackGroundImageCapInsets)));
+    Helper::makeAccessor<cocos2d::Rect, &Target::getBackGroundImageCapInsets,
+                         &Target::setBackGroundImageCapInsets>());
 
 const PropertyColor3B Self::Property::BackgroundImageColor(
     "background_image_color",
-    Helper::makeReader<cocos2d::Color3B>(
-        std::mem_fn(&Target::getBackGroundImageColor)),
-    Helper::makeWriter<cocos2d::Color3B>(
-        std::mem_fn(&Target::setBackGroundImageColor)));
+    Helper::makeAccessor<cocos2d::Color3B, &Target::getBackGroundImageColor,
+                         &Target::setBackGroundImageColor>());
 
 const PropertyInt Self::Property::BackgroundImageOpacity(
     "background_image_opacity",
-    Helper::makeReader<int>(std::mem_fn(&Target::getBackGroundImageOpacity)),
-    Helper::makeWriter<int>(std::mem_fn(&Target::setBackGroundImageOpacity)));
+    Helper::makeAccessor<int, &Target::getBackGroundImageOpacity,
+                         &Target::setBackGroundImageOpacity>());
 
 // const PropertyString<Target> BackgroundImageName("background_image_name",
 // std::mem_fn(&Target::getBackgroundIma));
@@ -71,20 +64,18 @@ const PropertyInt Self::Property::BackgroundImageOpacity(
 
 const PropertyBool Self::Property::ClippingEnabled(
     "clipping_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isClippingEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setClippingEnabled)));
+    Helper::makeAccessor<bool, &Target::isClippingEnabled,
+                         &Target::setClippingEnabled>());
 
-const PropertyEnum<Target::ClippingType>
-    Self::Property::ClippingType("clipping_type",
-                                 Helper::makeReader<Target::ClippingType>(
-                                     std::mem_fn(&Target::getClippingType)),
-                                 Helper::makeWriter<Target::ClippingType>(
-                                     std::mem_fn(&Target::setClippingType)));
+const PropertyEnum<Target::ClippingType> Self::Property::ClippingType(
+    "clipping_type",
+    Helper::makeAccessor<Target::ClippingType, &Target::getClippingType,
+                         &Target::setClippingType>());
 
 const PropertyEnum<Target::Type> Self::Property::LayoutType(
     "layout_type",
-    Helper::makeReader<Target::Type>(std::mem_fn(&Target::getLayoutType)),
-    Helper::makeWriter<Target::Type>(std::mem_fn(&Target::setLayoutType)));
+    Helper::makeAccessor<Target::Type, &Target::getLayoutType,
+                         &Target::setLayoutType>());
 
 const std::string Self::Name = "_Layout";
 
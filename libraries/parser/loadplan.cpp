@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <ciso646>
+
+#include "loadplan.hpp"
+#include "nodeinfo.hpp"
+#include "nodeloader.hpp"
+
+#include <2d/CCNode.h>
+
+namespace ee {
+using Self = LoadPlan;
+
+Self::LoadPlan(const NodeLoader& loader)
+    : loader_(loader) {
+    auto&& properties = loader.getProperties();
+    slots_.reserve(properties.size());
+    for (auto&& property : properties) {
+        slots_.push_back(Slot{property, property->getLoadFunction()});
+        keySlots_[property->getSymbol()].push_back(slots_.size() - 1);
+    }
+    for (auto&& property : loader.getTextureProperties()) {
+        textureKeys_.push_back(property->getSymbol());
+    }
+}
+
+Self::~LoadPlan() {}
+
+const NodeLoader& Self::getLoader() const {
+    return loader_;
+}
+
+cocos2d::Node* Self::createNode() const {
+    return loader_.createNode();
+}
+
+void Self::execute(cocos2d::Node* node, const PropertyHandler& handler) const {
+    loader_.beginLoad(node);
+    for (auto&& slot : slots_) {
+        if (not handler.hasProperty(slot.property->getSymbol())) {
+            continue;
+        }
+        if (not slot.load(*slot.property, handler, node)) {
+            CCLOG("Error loading property: %s",
+                  slot.property->getName().c_str());
+        }
+    }
+    loader_.commitLoad(node);
+}
+
+void Self::execute(cocos2d::Node* node, const PropertyHandler& handler,
+                   const std::vector<Symbol>& keys) const {
+    std::vector<std::size_t> indices;
+    for (auto&& key : keys) {
+        auto iter = keySlots_.find(key);
+        if (iter != keySlots_.cend()) {
+            indices.insert(indices.cend(), iter->second.cbegin(),
+                           iter->second.cend());
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    loader_.beginLoad(node);
+    for (auto&& index : indices) {
+        auto&& slot = slots_[index];
+        if (not handler.hasProperty(slot.property->getSymbol())) {
+            continue;
+        }
+        if (not slot.load(*slot.property, handler, node)) {
+            CCLOG("Error loading property: %s",
+                  slot.property->getName().c_str());
+        }
+    }
+    loader_.commitLoad(node);
+}
+
+const std::vector<Symbol>& Self::getTextureKeys() const {
+    return textureKeys_;
+}
+
+bool Self::hasKey(Symbol key) const {
+    return keySlots_.count(key) != 0;
+}
+
+bool Self::migrate(PropertyHandler& handler) const {
+    auto migrated = false;
+    for (auto&& slot : slots_) {
+        if (slot.property->migrate(handler)) {
+            migrated = true;
+        }
+    }
+    return migrated;
+}
+
+const PropertyHandler& Self::getDefaults() const {
+    std::call_once(defaultsFlag_, [this] {
+        defaults_ = std::make_unique<PropertyHandler>();
+        auto node = createNode();
+        NodeInfo::attach(node);
+        loader_.storeProperties(node, *defaults_);
+    });
+    return *defaults_;
+}
+} // namespace ee
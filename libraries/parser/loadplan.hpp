@@ -0,0 +1,76 @@
+#ifndef EE_PARSER_LOAD_PLAN_HPP
+#define EE_PARSER_LOAD_PLAN_HPP
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "parserfwd.hpp"
+#include "property.hpp"
+#include "propertyhandler.hpp"
+
+namespace ee {
+/// Precompiled instructions to load nodes of a single class.
+/// Built once per class by NodeLoaderLibrary.
+class LoadPlan final {
+private:
+    using Self = LoadPlan;
+
+public:
+    /// Compiles a plan for the specified loader.
+    /// @param loader The loader, must outlive the plan.
+    explicit LoadPlan(const NodeLoader& loader);
+
+    ~LoadPlan();
+
+    /// Gets the resolved loader.
+    const NodeLoader& getLoader() const;
+
+    /// Creates a node using the resolved loader.
+    cocos2d::Node* createNode() const;
+
+    /// Loads the properties present in the specified handler to the
+    /// specified node, in the loader's property order.
+    void execute(cocos2d::Node* node, const PropertyHandler& handler) const;
+
+    /// Reloads only the properties reading any of the specified keys.
+    /// @param handler The complete properties of the node.
+    /// @param keys The changed keys.
+    void execute(cocos2d::Node* node, const PropertyHandler& handler,
+                 const std::vector<Symbol>& keys) const;
+
+    /// Gets the keys of string properties naming texture files.
+    const std::vector<Symbol>& getTextureKeys() const;
+
+    /// Checks whether any property reads the specified key.
+    bool hasKey(Symbol key) const;
+
+    /// Converts the properties written by older versions to their current
+    /// form.
+    /// @return Whether any property was converted.
+    bool migrate(PropertyHandler& handler) const;
+
+    /// Gets the properties of a default node of this class.
+    /// Computed on first use, requires the cocos2d context.
+    const PropertyHandler& getDefaults() const;
+
+private:
+    struct Slot {
+        const Property* property;
+        Property::LoadFunction load;
+    };
+
+    const NodeLoader& loader_;
+    std::vector<Slot> slots_;
+    std::vector<Symbol> textureKeys_;
+
+    /// Maps every key to the slots reading it.
+    std::unordered_map<Symbol, std::vector<std::size_t>> keySlots_;
+
+    mutable std::once_flag defaultsFlag_;
+    mutable std::unique_ptr<PropertyHandler> defaults_;
+};
+} // namespace ee
+
+#endif // EE_PARSER_LOAD_PLAN_HPP
@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <cassert>
 #include <ciso646>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 #include "nodegraph.hpp"
 #include "propertyhandler.hpp"
 
+#include <xxhash/xxhash.h>
+
 namespace ee {
 namespace key {
 constexpr auto base_class = "base_class";
@@ -10,88 +17,308 @@ constexpr auto custom_class = "custom_class";
 constexpr auto display_name = "display_name";
 constexpr auto children = "children";
 constexpr auto properties = "properties";
+constexpr auto prefab = "prefab";
 } // namespace key
 
+/// Interned once, converting a name to a symbol locks the symbol table.
+namespace symbol {
+const Symbol base_class(key::base_class);
+const Symbol custom_class(key::custom_class);
+const Symbol display_name(key::display_name);
+const Symbol prefab(key::prefab);
+} // namespace symbol
+
+namespace {
+template <class T>
+void writeBytes(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::string& buffer, const std::string& value) {
+    writeBytes(buffer, static_cast<std::uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+/// Values compare floats with an absolute epsilon, round them the same way
+/// so that values that compare equal hash equally, unless they straddle a
+/// rounding boundary.
+void writeFloat(std::string& buffer, float value) {
+    constexpr auto epsilon = std::numeric_limits<float>::epsilon();
+    // Floats are more than epsilon apart from 2 on, only the equal ones
+    // compare equal there.
+    if (std::abs(value) < 2.0f) {
+        // Also maps -0 to 0.
+        auto steps = std::lround(value / epsilon);
+        writeBytes(buffer, static_cast<std::int32_t>(steps));
+        return;
+    }
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeBytes(buffer, bits);
+}
+
+/// Writes a canonical encoding of the specified value.
+void writeValue(std::string& buffer, const Value& value) {
+    writeBytes(buffer, static_cast<std::uint8_t>(value.getType()));
+    switch (value.getType()) {
+    case Value::Type::None:
+        break;
+    case Value::Type::Bool:
+        writeBytes(buffer, static_cast<std::uint8_t>(*value.getBool()));
+        break;
+    case Value::Type::Int:
+        writeBytes(buffer, static_cast<std::int32_t>(*value.getInt()));
+        break;
+    case Value::Type::Float:
+        writeFloat(buffer, *value.getFloat());
+        break;
+    case Value::Type::String:
+        writeString(buffer, value.asString());
+        break;
+    case Value::Type::List: {
+        auto&& list = value.asList();
+        writeBytes(buffer, static_cast<std::uint32_t>(list.size()));
+        for (auto&& item : list) {
+            writeValue(buffer, item);
+        }
+        break;
+    }
+    case Value::Type::Map: {
+        auto&& dict = value.asMap();
+        writeBytes(buffer, static_cast<std::uint32_t>(dict.size()));
+        for (auto&& entry : dict) {
+            writeString(buffer, entry.first);
+            writeValue(buffer, entry.second);
+        }
+        break;
+    }
+    case Value::Type::Vec2:
+    case Value::Type::Size:
+    case Value::Type::Color:
+    case Value::Type::Rect:
+    case Value::Type::Blend:
+        // The tag distinguishes them from plain maps.
+        writeValue(buffer, Value(value.toTagged()));
+        break;
+    }
+}
+
+/// The vendored xxhash only provides the 32-bit variant, combine two seeds
+/// to make collisions between cache keys unlikely.
+NodeGraph::Hash computeHash(const std::string& buffer) {
+    auto size = static_cast<int>(buffer.size());
+    auto high = XXH32(buffer.data(), size, 0);
+    auto low = XXH32(buffer.data(), size, 0x9E3779B1);
+    NodeGraph::Hash hash = (static_cast<NodeGraph::Hash>(high) << 32) | low;
+    // Zero marks a missing hash.
+    return hash == 0 ? 1 : hash;
+}
+} // namespace
+
 using Self = NodeGraph;
 
-Self::NodeGraph() {}
+Self::Data::Data()
+    : hash(0)
+    , exposed(false) {}
+
+Self::Data::Data(const Data& other)
+    : propertyHandler(other.propertyHandler)
+    , children(other.children)
+    , hash(0)
+    , exposed(false) {}
+
+Self::NodeGraph()
+    : data_(std::make_shared<Data>()) {}
+
+Self::NodeGraph(const Self& other)
+    : data_(other.share()) {}
+
+Self& Self::operator=(const Self& other) {
+    // Self-assignment would orphan the references into the current data.
+    if (this != &other) {
+        data_ = other.share();
+    }
+    return *this;
+}
 
-Self::NodeGraph(const ValueMap& dict) {
+Self::NodeGraph(const ValueMap& dict)
+    : data_(std::make_shared<Data>()) {
     setDictionary(dict);
 }
 
 Self::~NodeGraph() {}
 
 void Self::setDictionary(const ValueMap& dict) {
-    children_.clear();
-    propertyHandler_.clearProperties();
+    // Do not copy the old data only to clear it.
+    data_ = std::make_shared<Data>();
     if (dict.count(key::children)) {
         auto&& children = dict.at(key::children).asList();
         for (auto&& child : children) {
-            children_.emplace_back(child.asMap());
+            data_->children.emplace_back(child.asMap());
         }
     }
     if (dict.count(key::properties)) {
         auto&& properties = dict.at(key::properties).asMap();
-        propertyHandler_.setProperties(properties);
+        data_->propertyHandler.setProperties(properties);
     }
 }
 
+bool Self::isSameAs(const Self& other) const {
+    return data_ == other.data_;
+}
+
+Self::Hash Self::getHash() const {
+    // Exposed nodes may be written through the references they handed out
+    // at any time, and so may their exposed descendants.
+    auto cached = not data_->exposed;
+    auto hash = data_->hash.load(std::memory_order_relaxed);
+    if (cached && hash != 0) {
+        return hash;
+    }
+
+    // Properties are stored in symbol order, which depends on the order
+    // symbols were created in, hash them in name order instead.
+    auto&& handler = getPropertyHandler();
+    auto&& keys = handler.getPropertyKeys();
+    auto&& values = handler.getPropertyValues();
+    std::vector<std::size_t> order(keys.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t lhs, std::size_t rhs) {
+                  return keys[lhs].getName() < keys[rhs].getName();
+              });
+
+    std::string buffer;
+    writeBytes(buffer, static_cast<std::uint32_t>(keys.size()));
+    for (auto&& index : order) {
+        writeString(buffer, keys[index].getName());
+        writeValue(buffer, values[index]);
+    }
+    auto&& children = getChildren();
+    writeBytes(buffer, static_cast<std::uint32_t>(children.size()));
+    for (auto&& child : children) {
+        writeBytes(buffer, child.getHash());
+    }
+
+    hash = computeHash(buffer);
+    if (cached) {
+        // Concurrent readers compute the same hash, either store wins.
+        data_->hash.store(hash, std::memory_order_relaxed);
+    }
+    return hash;
+}
+
+std::shared_ptr<Self::Data> Self::share() const {
+    // References handed out may still write to exposed data, copying it
+    // keeps those writes out of the copy. Only the accessed paths are
+    // exposed, copying their children shares the others.
+    if (data_->exposed) {
+        return std::make_shared<Data>(*data_);
+    }
+    return data_;
+}
+
+void Self::detach() {
+    if (data_.use_count() > 1) {
+        data_ = std::make_shared<Data>(*data_);
+    }
+    // Also stops using the cached hash.
+    data_->exposed = true;
+}
+
+PropertyHandler& Self::getPropertyHandler() {
+    detach();
+    return data_->propertyHandler;
+}
+
 const PropertyHandler& Self::getPropertyHandler() const {
-    return propertyHandler_;
+    return data_->propertyHandler;
 }
 
 std::string Self::getBaseClass() const {
-    return getPropertyHandler().getProperty(key::base_class)->asString();
+    return getPropertyHandler().getProperty(symbol::base_class)->asString();
 }
 
 std::string Self::getCustomClass() const {
     auto&& handler = getPropertyHandler();
-    auto&& value = handler.getProperty(key::custom_class);
+    auto&& value = handler.getProperty(symbol::custom_class);
     return map(value, std::mem_fn(&Value::getString)).value_or("");
 }
 
 std::string Self::getDisplayName() const {
     auto&& handler = getPropertyHandler();
-    auto&& value = handler.getProperty(key::display_name);
+    auto&& value = handler.getProperty(symbol::display_name);
     return map(value, std::mem_fn(&Value::getString)).value_or(getBaseClass());
 }
 
 void Self::setBaseClass(const std::string& name) {
-    propertyHandler_.setProperty(key::base_class, name);
+    getPropertyHandler().setProperty(symbol::base_class, name);
 }
 
 void Self::setCustomClass(const std::string& name) {
-    propertyHandler_.setProperty(key::custom_class, name);
+    getPropertyHandler().setProperty(symbol::custom_class, name);
 }
 
 void Self::setDisplayName(const std::string& name) {
-    propertyHandler_.setProperty(key::display_name, name);
+    getPropertyHandler().setProperty(symbol::display_name, name);
+}
+
+std::string Self::getPrefab() const {
+    auto&& handler = getPropertyHandler();
+    auto&& value = handler.getProperty(symbol::prefab);
+    return map(value, std::mem_fn(&Value::getString)).value_or("");
+}
+
+void Self::setPrefab(const std::string& path) {
+    getPropertyHandler().setProperty(symbol::prefab, path);
+}
+
+bool Self::isPrefabInstance() const {
+    auto value = getPropertyHandler().findProperty(symbol::prefab);
+    return value != nullptr && value->isString() &&
+           not value->asString().empty();
 }
 
 Self& Self::getChild(std::size_t index) {
-    return children_.at(index);
+    detach();
+    return data_->children.at(index);
 }
 
 const Self& Self::getChild(std::size_t index) const {
-    return children_.at(index);
+    return data_->children.at(index);
 }
 
 std::vector<Self>& Self::getChildren() {
-    return children_;
+    detach();
+    return data_->children;
 }
 
 const std::vector<Self>& Self::getChildren() const {
-    return children_;
+    return data_->children;
 }
 
 void Self::addChild(const Self& child) {
-    children_.push_back(child);
+    getChildren().push_back(child);
+}
+
+void Self::insertChild(std::size_t index, const Self& child) {
+    auto&& children = getChildren();
+    assert(index <= children.size());
+    children.insert(children.begin() + static_cast<std::ptrdiff_t>(index),
+                    child);
+}
+
+void Self::removeChild(std::size_t index) {
+    auto&& children = getChildren();
+    assert(index < children.size());
+    children.erase(children.begin() + static_cast<std::ptrdiff_t>(index));
 }
 
 ValueMap Self::toDict() const {
     ValueMap dict;
-    dict[key::properties] = propertyHandler_.getProperties();
+    dict[key::properties] = getPropertyHandler().getProperties();
 
     ValueList children;
     for (auto&& child : getChildren()) {
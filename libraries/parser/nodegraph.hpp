@@ -1,14 +1,25 @@
 #ifndef EE_PARSER_NODE_GRAPH_HPP
 #define EE_PARSER_NODE_GRAPH_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
 #include "propertyhandler.hpp"
 
 namespace ee {
+/// Persistent node tree: copies share their data and subtrees, mutable
+/// accessors copy the shared nodes on the accessed path first.
+/// References returned by the mutable accessors stay valid after the graph
+/// is copied and only ever modify this graph: nodes that handed out mutable
+/// references are no longer shared, copies take a shallow copy of them.
 class NodeGraph final {
 private:
     using Self = NodeGraph;
 
 public:
+    using Hash = std::uint64_t;
+
     /// Constructs an empty node graph.
     NodeGraph();
 
@@ -16,7 +27,11 @@ public:
     /// @param dict Node graph's dictionary.
     explicit NodeGraph(const ValueMap& dict);
 
-    NodeGraph(const Self& other) = default;
+    NodeGraph(const Self& other);
+    NodeGraph(Self&& other) = default;
+
+    Self& operator=(const Self& other);
+    Self& operator=(Self&& other) = default;
 
     ~NodeGraph();
 
@@ -24,6 +39,19 @@ public:
     /// @param dict The desired dictionary.
     void setDictionary(const ValueMap& dict);
 
+    /// Checks whether both graphs share the same data, i.e. are equal
+    /// without having to compare them. Nodes accessed mutably are never
+    /// shared.
+    bool isSameAs(const Self& other) const;
+
+    /// Gets the content hash of this node and its descendants, equal graphs
+    /// have equal hashes regardless of the order properties were set in.
+    /// Cached on nodes never accessed mutably, so shared subtrees are only
+    /// hashed once. Nodes accessed mutably may still be written through the
+    /// returned references, they are hashed on every call.
+    Hash getHash() const;
+
+    PropertyHandler& getPropertyHandler();
     const PropertyHandler& getPropertyHandler() const;
 
     std::string getBaseClass() const;
@@ -34,6 +62,17 @@ public:
     void setCustomClass(const std::string& name);
     void setDisplayName(const std::string& name);
 
+    /// Gets the interface this node is an instance of, empty if the node is
+    /// not a prefab instance. The properties of an instance override the ones
+    /// of the prefab's root, the children of the prefab are added after the
+    /// instance's own children.
+    std::string getPrefab() const;
+
+    /// Makes this node an instance of the specified interface.
+    void setPrefab(const std::string& path);
+
+    bool isPrefabInstance() const;
+
     Self& getChild(std::size_t index);
     const Self& getChild(std::size_t index) const;
 
@@ -42,11 +81,42 @@ public:
 
     void addChild(const Self& child);
 
+    /// Inserts a child before the specified index.
+    void insertChild(std::size_t index, const Self& child);
+
+    /// Removes the child at the specified index.
+    void removeChild(std::size_t index);
+
     ValueMap toDict() const;
 
 private:
-    PropertyHandler propertyHandler_;
-    std::vector<Self> children_;
+    struct Data {
+        Data();
+
+        /// Copies the content, not the cached hash nor the exposed flag.
+        Data(const Data& other);
+
+        PropertyHandler propertyHandler;
+
+        /// Children share their own data.
+        std::vector<NodeGraph> children;
+
+        /// Cached content hash, zero if not computed, unused once exposed.
+        mutable std::atomic<Hash> hash;
+
+        /// Whether mutable references to this data were handed out, such
+        /// data is owned by a single graph and copied instead of shared.
+        bool exposed;
+    };
+
+    /// Gets the data a copy of this node refers to.
+    std::shared_ptr<Data> share() const;
+
+    /// Makes the data of this node unique and marks it exposed, children
+    /// stay shared.
+    void detach();
+
+    std::shared_ptr<Data> data_;
 };
 } // namespace ee
 
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <ciso646>
+
+#include "nodegraph.hpp"
+#include "nodegraphdiff.hpp"
+
+namespace ee {
+namespace key {
+constexpr auto base_class = "base_class";
+constexpr auto custom_class = "custom_class";
+} // namespace key
+
+namespace {
+bool isSameValue(const Value* lhs, const Value* rhs) {
+    if (lhs == nullptr || rhs == nullptr) {
+        return lhs == rhs;
+    }
+    return *lhs == *rhs;
+}
+
+/// Checks whether two nodes are loaded by the same loader.
+bool isSameClass(const NodeGraph& lhs, const NodeGraph& rhs) {
+    if (lhs.isSameAs(rhs)) {
+        return true;
+    }
+    static const Symbol baseClass(key::base_class);
+    static const Symbol customClass(key::custom_class);
+    auto&& lhsHandler = lhs.getPropertyHandler();
+    auto&& rhsHandler = rhs.getPropertyHandler();
+    return isSameValue(lhsHandler.findProperty(baseClass),
+                       rhsHandler.findProperty(baseClass)) &&
+           isSameValue(lhsHandler.findProperty(customClass),
+                       rhsHandler.findProperty(customClass));
+}
+} // namespace
+
+using Self = NodeGraphDiff;
+using Kind = Self::Kind;
+
+Self Self::compute(const NodeGraph& from, const NodeGraph& to) {
+    Self diff;
+    std::vector<std::size_t> path;
+    if (isSameClass(from, to)) {
+        diff.diffNode(from, to, path);
+    } else {
+        Operation operation;
+        operation.kind = Kind::Replace;
+        operation.index = 0;
+        operation.graph = std::make_shared<NodeGraph>(to);
+        diff.operations_.push_back(std::move(operation));
+    }
+    return diff;
+}
+
+Self::NodeGraphDiff() {}
+
+Self::~NodeGraphDiff() {}
+
+bool Self::isEmpty() const {
+    return operations_.empty();
+}
+
+const std::vector<Self::Operation>& Self::getOperations() const {
+    return operations_;
+}
+
+void Self::diffNode(const NodeGraph& from, const NodeGraph& to,
+                    std::vector<std::size_t>& path) {
+    if (from.isSameAs(to)) {
+        // Shared subtrees are equal, only edited paths are visited.
+        return;
+    }
+    diffProperties(from, to, path);
+
+    auto&& lhs = from.getChildren();
+    auto&& rhs = to.getChildren();
+    auto n = lhs.size();
+    auto m = rhs.size();
+    auto common = std::min(n, m);
+
+    // Match the common prefix and suffix, the middle is replaced.
+    std::size_t prefix = 0;
+    while (prefix < common && isSameClass(lhs[prefix], rhs[prefix])) {
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while (suffix < common - prefix &&
+           isSameClass(lhs[n - 1 - suffix], rhs[m - 1 - suffix])) {
+        ++suffix;
+    }
+
+    for (std::size_t i = 0; i < prefix; ++i) {
+        path.push_back(i);
+        diffNode(lhs[i], rhs[i], path);
+        path.pop_back();
+    }
+    for (auto i = n - suffix; i > prefix; --i) {
+        Operation operation;
+        operation.kind = Kind::RemoveChild;
+        operation.path = path;
+        operation.index = i - 1;
+        operations_.push_back(std::move(operation));
+    }
+    for (auto i = prefix; i < m - suffix; ++i) {
+        Operation operation;
+        operation.kind = Kind::InsertChild;
+        operation.path = path;
+        operation.index = i;
+        operation.graph = std::make_shared<NodeGraph>(rhs[i]);
+        operations_.push_back(std::move(operation));
+    }
+    for (std::size_t i = 0; i < suffix; ++i) {
+        path.push_back(m - suffix + i);
+        diffNode(lhs[n - suffix + i], rhs[m - suffix + i], path);
+        path.pop_back();
+    }
+}
+
+void Self::diffProperties(const NodeGraph& from, const NodeGraph& to,
+                          const std::vector<std::size_t>& path) {
+    auto&& lhs = from.getPropertyHandler();
+    auto&& rhs = to.getPropertyHandler();
+    auto&& lhsKeys = lhs.getPropertyKeys();
+    auto&& rhsKeys = rhs.getPropertyKeys();
+    auto&& lhsValues = lhs.getPropertyValues();
+    auto&& rhsValues = rhs.getPropertyValues();
+
+    auto addOperation = [&](Kind kind, Symbol key, const Value* value) {
+        Operation operation;
+        operation.kind = kind;
+        operation.path = path;
+        operation.index = 0;
+        operation.key = key;
+        if (value != nullptr) {
+            operation.value = *value;
+        }
+        operations_.push_back(std::move(operation));
+    };
+
+    // Both key arrays are sorted, merge them.
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < lhsKeys.size() || j < rhsKeys.size()) {
+        if (j == rhsKeys.size() ||
+            (i < lhsKeys.size() && lhsKeys[i] < rhsKeys[j])) {
+            addOperation(Kind::RemoveProperty, lhsKeys[i], nullptr);
+            ++i;
+        } else if (i == lhsKeys.size() || rhsKeys[j] < lhsKeys[i]) {
+            addOperation(Kind::SetProperty, rhsKeys[j], &rhsValues[j]);
+            ++j;
+        } else {
+            if (lhsValues[i] != rhsValues[j]) {
+                addOperation(Kind::SetProperty, rhsKeys[j], &rhsValues[j]);
+            }
+            ++i;
+            ++j;
+        }
+    }
+}
+
+void Self::apply(NodeGraph& graph) const {
+    for (auto&& operation : operations_) {
+        auto target = &graph;
+        for (auto&& index : operation.path) {
+            target = &target->getChild(index);
+        }
+        auto&& handler = target->getPropertyHandler();
+        switch (operation.kind) {
+        case Kind::SetProperty:
+            handler.setProperty(operation.key, operation.value);
+            break;
+        case Kind::RemoveProperty:
+            handler.removeProperty(operation.key);
+            break;
+        case Kind::InsertChild:
+            target->insertChild(operation.index, *operation.graph);
+            break;
+        case Kind::RemoveChild:
+            target->removeChild(operation.index);
+            break;
+        case Kind::Replace:
+            *target = *operation.graph;
+            break;
+        }
+    }
+}
+} // namespace ee
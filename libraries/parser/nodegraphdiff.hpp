@@ -0,0 +1,91 @@
+#ifndef EE_PARSER_NODE_GRAPH_DIFF_HPP
+#define EE_PARSER_NODE_GRAPH_DIFF_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "symbol.hpp"
+#include "value.hpp"
+
+namespace ee {
+class NodeGraph;
+
+/// Structural and property differences between two node graphs.
+/// Operations are meant to be applied in order: each path refers to the tree
+/// as left by the previous operations. The paths of property operations are
+/// also valid in the target graph.
+class NodeGraphDiff final {
+private:
+    using Self = NodeGraphDiff;
+
+public:
+    enum class Kind {
+        /// Sets a property of the target node.
+        SetProperty,
+
+        /// Removes a property of the target node.
+        RemoveProperty,
+
+        /// Inserts a child into the target node.
+        InsertChild,
+
+        /// Removes a child from the target node.
+        RemoveChild,
+
+        /// Replaces the target node, used when the class of the root changes.
+        Replace,
+    };
+
+    struct Operation {
+        Kind kind;
+
+        /// Child indices from the root to the target node.
+        std::vector<std::size_t> path;
+
+        /// Child index for InsertChild and RemoveChild.
+        std::size_t index;
+
+        /// Property key for SetProperty and RemoveProperty.
+        Symbol key;
+
+        /// Property value for SetProperty.
+        Value value;
+
+        /// Inserted subtree for InsertChild and Replace.
+        std::shared_ptr<const NodeGraph> graph;
+    };
+
+    /// Computes the operations transforming a graph into another.
+    /// Children are matched by class, unmatched children are removed and
+    /// inserted instead of being diffed. Subtrees shared by both graphs are
+    /// skipped, so diffing a graph against an edited copy is proportional
+    /// to the edits.
+    static Self compute(const NodeGraph& from, const NodeGraph& to);
+
+    /// Constructs an empty diff.
+    NodeGraphDiff();
+
+    ~NodeGraphDiff();
+
+    /// Checks whether both graphs were equal.
+    bool isEmpty() const;
+
+    const std::vector<Operation>& getOperations() const;
+
+    /// Applies the operations to the specified graph, which must be equal to
+    /// the source graph of the diff.
+    void apply(NodeGraph& graph) const;
+
+private:
+    void diffNode(const NodeGraph& from, const NodeGraph& to,
+                  std::vector<std::size_t>& path);
+
+    void diffProperties(const NodeGraph& from, const NodeGraph& to,
+                        const std::vector<std::size_t>& path);
+
+    std::vector<Operation> operations_;
+};
+} // namespace ee
+
+#endif // EE_PARSER_NODE_GRAPH_DIFF_HPP
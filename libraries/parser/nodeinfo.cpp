@@ -1,29 +1,170 @@
+#include <algorithm>
+#include <ciso646>
+#include <memory>
+
 #include "nodeinfo.hpp"
 
 #include <2d/CCNode.h>
 
 namespace ee {
+namespace {
+/// Number of infos per block, blocks are never moved so that references to
+/// infos stay valid when the table grows.
+constexpr std::size_t block_size = 1024;
+
+/// Bits of an id used by the index, the remaining ones hold the generation.
+constexpr unsigned index_bits = sizeof(NodeInfo::Id) >= 8 ? 32 : 20;
+constexpr NodeInfo::Id index_mask = (NodeInfo::Id(1) << index_bits) - 1;
+constexpr NodeInfo::Id generation_mask =
+    ~NodeInfo::Id(0) >> index_bits;
+
+} // namespace
+
+class NodeInfo::Table final {
+public:
+    static Table& getInstance() {
+        // Never destroyed, nodes may be released during static destruction.
+        static auto sharedInstance = new Table();
+        return *sharedInstance;
+    }
+
+    Id acquire() {
+        std::size_t index;
+        if (freeIndices_.empty()) {
+            index = size_++;
+            CC_ASSERT(index < index_mask);
+            if (index % block_size == 0) {
+                blocks_.push_back(std::make_unique<Entry[]>(block_size));
+            }
+        } else {
+            index = freeIndices_.back();
+            freeIndices_.pop_back();
+        }
+        auto&& entry = getEntry(index);
+        entry.used = true;
+        ++count_;
+        // Index 0 is reserved for nodes without info.
+        return (entry.generation << index_bits) | (index + 1);
+    }
+
+    void release(Id id) {
+        auto entry = find(id);
+        if (entry == nullptr) {
+            return;
+        }
+        entry->info.reset();
+        entry->used = false;
+        entry->generation = (entry->generation + 1) & generation_mask;
+        freeIndices_.push_back((id & index_mask) - 1);
+        --count_;
+    }
+
+    NodeInfo* get(Id id) {
+        auto entry = find(id);
+        return entry == nullptr ? nullptr : &entry->info;
+    }
+
+    std::size_t getCount() const { return count_; }
+
+private:
+    struct Entry {
+        Entry()
+            : generation(0)
+            , used(false) {}
+
+        NodeInfo info;
+        Id generation;
+        bool used;
+    };
+
+    Table()
+        : size_(0)
+        , count_(0) {}
+
+    Entry& getEntry(std::size_t index) {
+        return blocks_[index / block_size][index % block_size];
+    }
+
+    Entry* find(Id id) {
+        auto index = id & index_mask;
+        if (index == 0 || index > size_) {
+            return nullptr;
+        }
+        auto&& entry = getEntry(index - 1);
+        if (not entry.used || entry.generation != (id >> index_bits)) {
+            return nullptr;
+        }
+        return &entry;
+    }
+
+    std::vector<std::unique_ptr<Entry[]>> blocks_;
+    std::vector<std::size_t> freeIndices_;
+    std::size_t size_;
+    std::size_t count_;
+};
+
+/// User object of a node, releases the info of the node along with it.
+class NodeInfo::Handle final : public cocos2d::Ref {
+public:
+    explicit Handle(Id id_)
+        : id(id_) {}
+
+    virtual ~Handle() override {
+        Table::getInstance().release(id);
+    }
+
+    const Id id;
+};
+
 using Self = NodeInfo;
 
+Self::Id Self::getId(const cocos2d::Node* node) {
+    auto handle = dynamic_cast<const Handle*>(node->getUserObject());
+    return handle == nullptr ? 0 : handle->id;
+}
+
 const PropertyHandler& Self::getPropertyHandler(const cocos2d::Node* node) {
-    auto obj = node->getUserObject();
-    auto info = dynamic_cast<const NodeInfo*>(obj);
-    return info->getPropertyHandler();
+    return getInfo(node)->getPropertyHandler();
 }
 
 PropertyHandler& Self::getPropertyHandler(cocos2d::Node* node) {
-    auto obj = node->getUserObject();
-    auto info = dynamic_cast<NodeInfo*>(obj);
-    return info->getPropertyHandler();
+    return getInfo(node)->getPropertyHandler();
+}
+
+Self& Self::attach(cocos2d::Node* node) {
+    auto&& table = Table::getInstance();
+    auto id = table.acquire();
+    auto handle = new Handle(id);
+    // Releases the previous handle, hence the previous info.
+    node->setUserObject(handle);
+    handle->release();
+    return *table.get(id);
+}
+
+const Self* Self::getInfo(const cocos2d::Node* node) {
+    return Table::getInstance().get(getId(node));
+}
+
+Self* Self::getInfo(cocos2d::Node* node) {
+    return Table::getInstance().get(getId(node));
 }
 
-Self* Self::create() {
-    auto result = new Self();
-    result->autorelease();
-    return result;
+std::size_t Self::getInfoCount() {
+    return Table::getInstance().getCount();
 }
 
-Self::NodeInfo() {}
+Self::NodeInfo()
+    : batchDepth_(0)
+    , fromPrefab_(false) {}
+
+void Self::reset() {
+    // Keep the property storage for the next node.
+    propertyHandler_.clearProperties();
+    resources_.clear();
+    batchDepth_ = 0;
+    pendingUpdates_.clear();
+    fromPrefab_ = false;
+}
 
 const PropertyHandler& Self::getPropertyHandler() const {
     return propertyHandler_;
@@ -32,4 +173,72 @@ const PropertyHandler& Self::getPropertyHandler() const {
 PropertyHandler& Self::getPropertyHandler() {
     return propertyHandler_;
 }
+
+void Self::setFromPrefab(bool fromPrefab) {
+    fromPrefab_ = fromPrefab;
+}
+
+bool Self::isFromPrefab() const {
+    return fromPrefab_;
+}
+
+const cocos2d::Node* Self::getGraphNode(const cocos2d::Node* node) {
+    while (node != nullptr) {
+        auto info = getInfo(node);
+        if (info == nullptr || not info->isFromPrefab()) {
+            break;
+        }
+        node = node->getParent();
+    }
+    return node;
+}
+
+cocos2d::Node* Self::getGraphNode(cocos2d::Node* node) {
+    return const_cast<cocos2d::Node*>(
+        getGraphNode(static_cast<const cocos2d::Node*>(node)));
+}
+
+void Self::setResource(Symbol key, std::shared_ptr<const void> resource) {
+    auto iter = std::find_if(
+        resources_.begin(), resources_.end(),
+        [key](const auto& elt) { return elt.first == key; });
+    if (iter != resources_.end()) {
+        iter->second = std::move(resource);
+    } else {
+        resources_.emplace_back(key, std::move(resource));
+    }
+}
+
+void Self::beginBatch() {
+    ++batchDepth_;
+}
+
+bool Self::endBatch() {
+    CC_ASSERT(batchDepth_ > 0);
+    return --batchDepth_ == 0;
+}
+
+bool Self::isBatching() const {
+    return batchDepth_ > 0;
+}
+
+void Self::addPendingUpdate(Symbol key) {
+    if (not hasPendingUpdate(key)) {
+        pendingUpdates_.push_back(key);
+    }
+}
+
+bool Self::hasPendingUpdate(Symbol key) const {
+    return std::find(pendingUpdates_.cbegin(), pendingUpdates_.cend(), key) !=
+           pendingUpdates_.cend();
+}
+
+bool Self::takePendingUpdate(Symbol key) {
+    auto iter = std::find(pendingUpdates_.begin(), pendingUpdates_.end(), key);
+    if (iter == pendingUpdates_.end()) {
+        return false;
+    }
+    pendingUpdates_.erase(iter);
+    return true;
+}
 } // namespace ee
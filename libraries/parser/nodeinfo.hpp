@@ -1,25 +1,80 @@
 #ifndef EE_PARSER_NODE_INFO_HPP
 #define EE_PARSER_NODE_INFO_HPP
 
-#include "propertyhandler.hpp"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 
-#include <base/CCRef.h>
+#include "propertyhandler.hpp"
+#include "symbol.hpp"
 
 namespace ee {
 /// Stores additional properties for a node.
-class NodeInfo final : public cocos2d::Ref {
+/// Infos live in a pooled side table, nodes refer to their info through a
+/// small user object holding its id, which recycles the info when the node
+/// is destroyed. Must only be used from the cocos2d thread.
+class NodeInfo final {
 private:
     using Self = NodeInfo;
 
 public:
+    /// Identifies an info, combines its index in the table and the
+    /// generation of the slot so that ids of recycled infos are never
+    /// mistaken for the current ones.
+    using Id = std::uintptr_t;
+
     static const PropertyHandler& getPropertyHandler(const cocos2d::Node* node);
     static PropertyHandler& getPropertyHandler(cocos2d::Node* node);
 
-    static Self* create();
+    /// Attaches an empty info to the specified node, the previous info of the
+    /// node is recycled.
+    static Self& attach(cocos2d::Node* node);
+
+    /// Gets the info attached to the specified node.
+    /// @return nullptr if the node has no info.
+    static const Self* getInfo(const cocos2d::Node* node);
+    static Self* getInfo(cocos2d::Node* node);
+
+    /// Gets the number of infos currently attached to nodes.
+    static std::size_t getInfoCount();
 
     const PropertyHandler& getPropertyHandler() const;
     PropertyHandler& getPropertyHandler();
 
+    /// Marks the node as added by a prefab instance, such nodes are not in
+    /// the node graph and are edited through their instance.
+    void setFromPrefab(bool fromPrefab);
+    bool isFromPrefab() const;
+
+    /// Gets the closest node that is in the node graph, i.e. the specified
+    /// node or the prefab instance that added it.
+    static const cocos2d::Node* getGraphNode(const cocos2d::Node* node);
+    static cocos2d::Node* getGraphNode(cocos2d::Node* node);
+
+    /// Keeps the specified resource alive as long as the node, replaces the
+    /// resource previously stored with the same key.
+    void setResource(Symbol key, std::shared_ptr<const void> resource);
+
+    /// Starts a batch of property writes, batches can be nested.
+    void beginBatch();
+
+    /// Ends a batch of property writes.
+    /// @return Whether the outermost batch ended.
+    bool endBatch();
+
+    /// Checks whether property writes are being batched.
+    bool isBatching() const;
+
+    /// Marks an expensive update as pending until the batch ends.
+    void addPendingUpdate(Symbol key);
+
+    bool hasPendingUpdate(Symbol key) const;
+
+    /// Clears a pending update.
+    /// @return Whether the update was pending.
+    bool takePendingUpdate(Symbol key);
+
 protected:
     friend NodeInfoReader;
     friend NodeInfoWriter;
@@ -27,8 +82,22 @@ protected:
     NodeInfo();
 
 private:
+    class Table;
+    class Handle;
+
+    /// Gets the id of the info attached to the specified node, 0 if none.
+    static Id getId(const cocos2d::Node* node);
+
+    /// Clears the info so that it can be reused, keeps the allocated
+    /// property storage.
+    void reset();
+
     PropertyHandler propertyHandler_;
+    std::vector<std::pair<Symbol, std::shared_ptr<const void>>> resources_;
+    int batchDepth_;
+    std::vector<Symbol> pendingUpdates_;
+    bool fromPrefab_;
 };
 } // namespace ee
 
-#endif // NODEINFO_HPP
+#endif // EE_PARSER_NODE_INFO_HPP
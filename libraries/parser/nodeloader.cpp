@@ -1,5 +1,6 @@
 #include <ciso646>
 
+#include "nodeinfo.hpp"
 #include "nodeloader.hpp"
 
 #include <2d/CCNode.h>
@@ -10,101 +11,92 @@ using Self = NodeLoader;
 using Target = cocos2d::Node;
 using Helper = PropertyHelper<Target>;
 
+namespace {
+// Selects the overloads used by Position.
+using PositionGetter = const cocos2d::Point& (Target::*)() const;
+using PositionSetter = void (Target::*)(const cocos2d::Point&);
+} // namespace
+
 const PropertyPoint Self::Property::AnchorPoint(
     "anchor_point",
-    Helper::makeReader<cocos2d::Point>(std::mem_fn(&Target::getAnchorPoint)),
-    Helper::makeWriter<cocos2d::Point>(std::mem_fn(&Target::setAnchorPoint)));
+    Helper::makeAccessor<cocos2d::Point, &Target::getAnchorPoint,
+                         &Target::setAnchorPoint>());
 
 const PropertyBool Self::Property::CascadeColorEnabled(
     "cascade_color_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isCascadeColorEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setCascadeColorEnabled)));
+    Helper::makeAccessor<bool, &Target::isCascadeColorEnabled,
+                         &Target::setCascadeColorEnabled>());
 
 const PropertyBool Self::Property::CascadeOpacityEnabled(
     "cascade_opacity_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isCascadeOpacityEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setCascadeOpacityEnabled)));
+    Helper::makeAccessor<bool, &Target::isCascadeOpacityEnabled,
+                         &Target::setCascadeOpacityEnabled>());
 
 const PropertyColor3B Self::Property::Color(
     "color",
-    Helper::makeReader<cocos2d::Color3B>(std::mem_fn(&Target::getColor)),
-    Helper::makeWriter<cocos2d::Color3B>(std::mem_fn(&Target::setColor)));
+    Helper::makeAccessor<cocos2d::Color3B, &Target::getColor,
+                         &Target::setColor>());
 
 const PropertySize Self::Property::ContentSize(
     "content_size",
-    Helper::makeReader<cocos2d::Size>(std::mem_fn(&Target::getContentSize)),
-    Helper::makeWriter<cocos2d::Size>(std::mem_fn(&Target::setContentSize)));
+    Helper::makeAccessor<cocos2d::Size, &Target::getContentSize,
+                         &Target::setContentSize>());
 
 const PropertyBool Self::Property::IgnoreAnchorPointForPosition(
     "ignore_anchor_point_for_position",
-    Helper::makeReader<bool>(
-        std::mem_fn(&Target::isIgnoreAnchorPointForPosition)),
-    Helper::makeWriter<bool>(
-        std::mem_fn(&Target::setIgnoreAnchorPointForPosition)));
+    Helper::makeAccessor<bool, &Target::isIgnoreAnchorPointForPosition,
+                         &Target::setIgnoreAnchorPointForPosition>());
 
 const PropertyInt Self::Property::LocalZOrder(
     "local_z_order",
-    Helper::makeReader<int>(std::mem_fn(&Target::getLocalZOrder)),
-    Helper::makeWriter<int>(std::mem_fn(&Target::setLocalZOrder)));
+    Helper::makeAccessor<int, &Target::getLocalZOrder,
+                         &Target::setLocalZOrder>());
 
 const PropertyString Self::Property::Name(
-    "name", //
-    Helper::makeReader<std::string>(std::mem_fn(&Target::getName)),
-    Helper::makeWriter<std::string>(std::mem_fn(&Target::setName)));
+    "name",
+    Helper::makeAccessor<std::string, &Target::getName, &Target::setName>());
 
 const PropertyInt Self::Property::Opacity(
-    "opacity", //
-    Helper::makeReader<int>(std::mem_fn(&Target::getOpacity)),
-    Helper::makeWriter<int>(std::mem_fn(&Target::setOpacity)));
+    "opacity",
+    Helper::makeAccessor<int, &Target::getOpacity, &Target::setOpacity>());
 
 const PropertyBool Self::Property::OpacityModifyRGB(
     "opacity_modify_rgb",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isOpacityModifyRGB)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setOpacityModifyRGB)));
+    Helper::makeAccessor<bool, &Target::isOpacityModifyRGB,
+                         &Target::setOpacityModifyRGB>());
 
 const PropertyPoint Self::Property::Position(
-    "position", Helper ::makeReader<cocos2d::Point>([](const Target* node) {
-        return node->getPosition();
-    }),
-    Helper::makeWriter<cocos2d::Point>([](Target* node,
-                                          const cocos2d::Point& position) {
-        node->setPosition(position);
-    }));
+    "position",
+    Helper::makeAccessor<cocos2d::Point,
+                         static_cast<PositionGetter>(&Target::getPosition),
+                         static_cast<PositionSetter>(&Target::setPosition)>());
 
 const PropertyFloat Self::Property::Rotation(
-    "rotation", //
-    Helper::makeReader<float>(std::mem_fn(&Target::getRotation)),
-    Helper::makeWriter<float>(std::mem_fn(&Target::setRotation)));
+    "rotation",
+    Helper::makeAccessor<float, &Target::getRotation, &Target::setRotation>());
 
 const PropertyFloat Self::Property::ScaleX(
-    "scale_x", //
-    Helper::makeReader<float>(std::mem_fn(&Target::getScaleX)),
-    Helper::makeWriter<float>(std::mem_fn(&Target::setScaleX)));
+    "scale_x",
+    Helper::makeAccessor<float, &Target::getScaleX, &Target::setScaleX>());
 
 const PropertyFloat Self::Property::ScaleY(
-    "scale_y", //
-    Helper::makeReader<float>(std::mem_fn(&Target::getScaleY)),
-    Helper::makeWriter<float>(std::mem_fn(&Target::setScaleY)));
+    "scale_y",
+    Helper::makeAccessor<float, &Target::getScaleY, &Target::setScaleY>());
 
 const PropertyFloat Self::Property::SkewX(
-    "skew_x", //
-    Helper::makeReader<float>(std::mem_fn(&Target::getSkewX)),
-    Helper::makeWriter<float>(std::mem_fn(&Target::setSkewX)));
+    "skew_x",
+    Helper::makeAccessor<float, &Target::getSkewX, &Target::setSkewX>());
 
 const PropertyFloat Self::Property::SkewY(
-    "skew_y", //
-    Helper::makeReader<float>(std::mem_fn(&Target::getSkewY)),
-    Helper::makeWriter<float>(std::mem_fn(&Target::setSkewY)));
+    "skew_y",
+    Helper::makeAccessor<float, &Target::getSkewY, &Target::setSkewY>());
 
-const PropertyInt
-    Self::Property::Tag("tag",
-                        Helper::makeReader<int>(std::mem_fn(&Target::getTag)),
-                        Helper::makeWriter<int>(std::mem_fn(&Target::setTag)));
+const PropertyInt Self::Property::Tag(
+    "tag", Helper::makeAccessor<int, &Target::getTag, &Target::setTag>());
 
 const PropertyBool Self::Property::Visible(
-    "visible", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isVisible)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setVisible)));
+    "visible",
+    Helper::makeAccessor<bool, &Target::isVisible, &Target::setVisible>());
 
 const std::string Self::Name = "_Node";
 
@@ -123,7 +115,6 @@ Self::NodeLoader() {
     addProperty(Property::Rotation);
     addProperty(Property::ScaleX);
     addProperty(Property::ScaleY);
-    addProperty(Property::Position);
     addProperty(Property::SkewX);
     addProperty(Property::SkewY);
     addProperty(Property::Tag);
@@ -142,24 +133,40 @@ cocos2d::Node* Self::createNode() const {
 
 void Self::loadProperties(cocos2d::Node* node,
                           const PropertyHandler& handler) const {
-    for (auto&& property : getProperties()) {
-        if (not property->load(handler, node)) {
-            CCLOG("Error loading property: %s", property->getName().c_str());
+    beginLoad(node);
+    for (auto&& slot : slots_) {
+        if (not slot.load(*slot.property, handler, node)) {
+            CCLOG("Error loading property: %s",
+                  slot.property->getName().c_str());
         }
     }
+    commitLoad(node);
+}
+
+void Self::beginLoad(cocos2d::Node* node) const {
+    NodeInfo::getInfo(node)->beginBatch();
+}
+
+void Self::commitLoad(cocos2d::Node* node) const {
+    if (NodeInfo::getInfo(node)->endBatch()) {
+        commitProperties(node);
+    }
 }
 
 void Self::storeProperties(const cocos2d::Node* node,
                            PropertyHandler& handler) const {
-    for (auto&& property : getProperties()) {
-        if (not property->store(handler, node)) {
-            CCLOG("Error storing property: %s", property->getName().c_str());
+    for (auto&& slot : slots_) {
+        if (not slot.store(*slot.property, handler, node)) {
+            CCLOG("Error storing property: %s",
+                  slot.property->getName().c_str());
         }
     }
 }
 
 Self& Self::addProperty(const ee::Property& property) {
     properties_.push_back(&property);
+    slots_.push_back(Slot{&property, property.getLoadFunction(),
+                          property.getStoreFunction()});
     return *this;
 }
 
@@ -167,9 +174,22 @@ const std::vector<const ee::Property*>& Self::getProperties() const {
     return properties_;
 }
 
+Self& Self::markTextureProperty(const ee::Property& property) {
+    textureProperties_.push_back(&property);
+    return *this;
+}
+
+const std::vector<const ee::Property*>& Self::getTextureProperties() const {
+    return textureProperties_;
+}
+
+void Self::commitProperties(cocos2d::Node*) const {}
+
 NodeLoaderPtr Self::clone() const {
     auto result = cloneRaw();
     result->properties_ = properties_;
+    result->textureProperties_ = textureProperties_;
+    result->slots_ = slots_;
     return NodeLoaderPtr(result);
 }
 
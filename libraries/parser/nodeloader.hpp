@@ -5,6 +5,8 @@
 #include "property.hpp"
 
 namespace ee {
+class LoadPlan;
+
 /// Parses cocos2d::Node.
 class NodeLoader {
 private:
@@ -51,6 +53,14 @@ public:
     void loadProperties(cocos2d::Node* node,
                         const PropertyHandler& handler) const;
 
+    /// Starts a batch of property loads into the specified node, expensive
+    /// setters stage their values until the batch is committed.
+    void beginLoad(cocos2d::Node* node) const;
+
+    /// Commits the batch started by beginLoad, performs the staged work once
+    /// the outermost batch ends.
+    void commitLoad(cocos2d::Node* node) const;
+
     /// Stores properties from the specified node to the specified loader.
     void storeProperties(const cocos2d::Node* node,
                          PropertyHandler& handler) const;
@@ -59,14 +69,34 @@ public:
     NodeLoaderPtr clone() const;
 
 protected:
+    friend LoadPlan;
+
     Self& addProperty(const ee::Property& property);
     const std::vector<const ee::Property*>& getProperties() const;
 
+    /// Marks a string property as a texture file so that readers can
+    /// pre-decode it.
+    Self& markTextureProperty(const ee::Property& property);
+    const std::vector<const ee::Property*>& getTextureProperties() const;
+
+    /// Performs the work staged by setters during a batch.
+    virtual void commitProperties(cocos2d::Node* node) const;
+
     /// Raw clones this node.
     virtual Self* cloneRaw() const;
 
 private:
+    /// Resolved entry points of a property, avoids virtual dispatch when
+    /// loading.
+    struct Slot {
+        const ee::Property* property;
+        ee::Property::LoadFunction load;
+        ee::Property::StoreFunction store;
+    };
+
     std::vector<const ee::Property*> properties_;
+    std::vector<const ee::Property*> textureProperties_;
+    std::vector<Slot> slots_;
 };
 } // namespace ee
 
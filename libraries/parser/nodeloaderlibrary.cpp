@@ -1,6 +1,7 @@
 #include <cassert>
 
 #include "layercolorloader.hpp"
+#include "loadplan.hpp"
 #include "nodeloader.hpp"
 #include "nodeloaderlibrary.hpp"
 #include "scale9spriteloader.hpp"
@@ -51,6 +52,8 @@ bool Self::removeLoader(const std::string& name) {
         return false;
     }
     loaders_.erase(name);
+    std::lock_guard<std::mutex> guard(plansMutex_);
+    plans_.erase(name);
     return true;
 }
 
@@ -58,4 +61,14 @@ const NodeLoaderPtr& Self::getLoader(const std::string& name) const {
     assert(hasLoader(name));
     return loaders_.at(name);
 }
+
+const LoadPlan& Self::getPlan(const std::string& name) const {
+    std::lock_guard<std::mutex> guard(plansMutex_);
+    auto iter = plans_.find(name);
+    if (iter == plans_.cend()) {
+        auto&& loader = getLoader(name);
+        iter = plans_.emplace(name, std::make_unique<LoadPlan>(*loader)).first;
+    }
+    return *iter->second;
+}
 } // namespace ee
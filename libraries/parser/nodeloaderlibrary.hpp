@@ -1,12 +1,16 @@
 #ifndef EE_PARSER_NODE_LOADER_LIBRARY_HPP
 #define EE_PARSER_NODE_LOADER_LIBRARY_HPP
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
 #include "parserfwd.hpp"
 
 namespace ee {
+class LoadPlan;
+
 /// A collection of node loaders.
 class NodeLoaderLibrary final {
 private:
@@ -44,9 +48,18 @@ public:
     /// @param name The name of the node loader.
     const NodeLoaderPtr& getLoader(const std::string& name) const;
 
+    /// Gets the load plan of the loader whose the specified name.
+    /// Plans are compiled on first use and cached.
+    /// @param name The name of the node loader.
+    const LoadPlan& getPlan(const std::string& name) const;
+
 private:
     /// Stores individual node loaders.
     std::unordered_map<std::string, NodeLoaderPtr> loaders_;
+
+    /// Compiled load plans, keyed by loader name.
+    mutable std::mutex plansMutex_;
+    mutable std::unordered_map<std::string, std::unique_ptr<LoadPlan>> plans_;
 };
 } // namespace ee
 
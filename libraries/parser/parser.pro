@@ -36,7 +36,17 @@ HEADERS += \
     propertytraits.hpp \
     optional.hpp \
     skeletonanimationloader.hpp \
-    skeletonanimationmanager.hpp
+    skeletonanimationmanager.hpp \
+    binarygraph.hpp \
+    symbol.hpp \
+    stringpool.hpp \
+    loadplan.hpp \
+    preparedgraph.hpp \
+    nodegraphdiff.hpp \
+    jsongraphreader.hpp \
+    jsongraphwriter.hpp \
+    skeletonbinarywriter.hpp \
+    skeletonbinarycache.hpp
 
 SOURCES += \
     nodeloader.cpp \
@@ -54,4 +64,14 @@ SOURCES += \
     propertytraits.cpp \
     property.cpp \
     skeletonanimationloader.cpp \
-    skeletonanimationmanager.cpp
+    skeletonanimationmanager.cpp \
+    binarygraph.cpp \
+    symbol.cpp \
+    stringpool.cpp \
+    loadplan.cpp \
+    preparedgraph.cpp \
+    nodegraphdiff.cpp \
+    jsongraphreader.cpp \
+    jsongraphwriter.cpp \
+    skeletonbinarywriter.cpp \
+    skeletonbinarycache.cpp
@@ -0,0 +1,70 @@
+#include <limits>
+
+#include "preparedgraph.hpp"
+
+#include <platform/CCImage.h>
+
+namespace ee {
+using Self = PreparedGraph;
+
+const std::size_t Self::NoParent = std::numeric_limits<std::size_t>::max();
+
+Self::PreparedGraph()
+    : decodedTextureCount_(0)
+    , prepareTime_(0)
+    , instantiateTime_(0) {}
+
+Self::~PreparedGraph() {
+    releaseTextures();
+}
+
+Self::PreparedGraph(Self&& other)
+    : instructions_(std::move(other.instructions_))
+    , textures_(std::move(other.textures_))
+    , decodedTextureCount_(other.decodedTextureCount_)
+    , prepareTime_(other.prepareTime_)
+    , instantiateTime_(other.instantiateTime_) {
+    other.textures_.clear();
+}
+
+Self& Self::operator=(Self&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    releaseTextures();
+    instructions_ = std::move(other.instructions_);
+    textures_ = std::move(other.textures_);
+    decodedTextureCount_ = other.decodedTextureCount_;
+    prepareTime_ = other.prepareTime_;
+    instantiateTime_ = other.instantiateTime_;
+    other.textures_.clear();
+    return *this;
+}
+
+const std::vector<Self::Instruction>& Self::getInstructions() const {
+    return instructions_;
+}
+
+std::size_t Self::getTextureCount() const {
+    return textures_.size();
+}
+
+std::size_t Self::getDecodedTextureCount() const {
+    return decodedTextureCount_;
+}
+
+double Self::getPrepareTime() const {
+    return prepareTime_;
+}
+
+double Self::getInstantiateTime() const {
+    return instantiateTime_;
+}
+
+void Self::releaseTextures() {
+    for (auto&& texture : textures_) {
+        texture.second->release();
+    }
+    textures_.clear();
+}
+} // namespace ee
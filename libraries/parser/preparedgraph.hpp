@@ -0,0 +1,84 @@
+#ifndef EE_PARSER_PREPARED_GRAPH_HPP
+#define EE_PARSER_PREPARED_GRAPH_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "propertyhandler.hpp"
+
+namespace cocos2d {
+class Image;
+} // namespace cocos2d
+
+namespace ee {
+class GraphReader;
+class LoadPlan;
+
+/// Output of GraphReader::prepare: a flat, pre-order list of decoded nodes
+/// and pre-decoded textures, ready to be instantiated on the cocos2d thread.
+class PreparedGraph final {
+private:
+    using Self = PreparedGraph;
+
+public:
+    /// Creates one node.
+    struct Instruction {
+        const LoadPlan* plan;
+
+        /// Index of the parent instruction, NoParent for the root.
+        std::size_t parent;
+
+        /// Decoded properties of the node.
+        PropertyHandler properties;
+
+        /// Whether the node is a child of a prefab instance, such nodes are
+        /// not in the node graph.
+        bool fromPrefab;
+    };
+
+    static const std::size_t NoParent;
+
+    PreparedGraph();
+    ~PreparedGraph();
+
+    PreparedGraph(Self&& other);
+    Self& operator=(Self&& other);
+
+    PreparedGraph(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    /// Gets the instructions, parents always come before their children.
+    const std::vector<Instruction>& getInstructions() const;
+
+    /// Gets the number of pre-decoded textures not yet uploaded.
+    std::size_t getTextureCount() const;
+
+    /// Gets the number of textures decoded in the prepare phase.
+    std::size_t getDecodedTextureCount() const;
+
+    /// Gets the wall time spent in the prepare phase, in milliseconds.
+    double getPrepareTime() const;
+
+    /// Gets the wall time spent in the instantiate phase, in milliseconds,
+    /// zero until instantiated.
+    double getInstantiateTime() const;
+
+private:
+    friend GraphReader;
+
+    void releaseTextures();
+
+    std::vector<Instruction> instructions_;
+
+    /// Full texture paths and their decoded images (retained).
+    std::vector<std::pair<std::string, cocos2d::Image*>> textures_;
+
+    std::size_t decodedTextureCount_;
+    double prepareTime_;
+    double instantiateTime_;
+};
+} // namespace ee
+
+#endif // EE_PARSER_PREPARED_GRAPH_HPP
@@ -4,11 +4,49 @@ namespace ee {
 using Self = Property;
 
 Self::Property(const std::string& name)
-    : name_(name) {}
+    : symbol_(name)
+    , load_(&loadVirtual)
+    , store_(&storeVirtual)
+    , migrate_(nullptr) {}
 
 Self::~Property() {}
 
 const std::string& Self::getName() const {
-    return name_;
+    return symbol_.getName();
+}
+
+Symbol Self::getSymbol() const {
+    return symbol_;
+}
+
+Self::LoadFunction Self::getLoadFunction() const {
+    return load_;
+}
+
+Self::StoreFunction Self::getStoreFunction() const {
+    return store_;
+}
+
+void Self::setFunctions(LoadFunction load, StoreFunction store) {
+    load_ = load;
+    store_ = store;
+}
+
+bool Self::migrate(PropertyHandler& handler) const {
+    return migrate_ != nullptr && migrate_(handler, symbol_);
+}
+
+void Self::setMigrateFunction(MigrateFunction migrate) {
+    migrate_ = migrate;
+}
+
+bool Self::loadVirtual(const Property& property,
+                       const PropertyHandler& handler, cocos2d::Node* node) {
+    return property.load(handler, node);
+}
+
+bool Self::storeVirtual(const Property& property, PropertyHandler& handler,
+                        const cocos2d::Node* node) {
+    return property.store(handler, node);
 }
 } // namespace ee
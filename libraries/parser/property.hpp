@@ -5,6 +5,8 @@
 
 #include "optional.hpp"
 #include "parserfwd.hpp"
+#include "propertytraits.hpp"
+#include "symbol.hpp"
 #include "value.hpp"
 
 namespace cocos2d {
@@ -22,20 +24,71 @@ struct IsProperty;
 
 class Property {
 public:
+    /// Non-virtual entry points used by node loader slot tables.
+    using LoadFunction = bool (*)(const Property& property,
+                                  const PropertyHandler& handler,
+                                  cocos2d::Node* node);
+    using StoreFunction = bool (*)(const Property& property,
+                                   PropertyHandler& handler,
+                                   const cocos2d::Node* node);
+    using MigrateFunction = bool (*)(PropertyHandler& handler, Symbol name);
+
     Property(const std::string& name);
 
     virtual ~Property();
 
     const std::string& getName() const;
 
+    /// Gets the interned name of this property.
+    Symbol getSymbol() const;
+
     virtual bool load(const PropertyHandler& handler,
                       cocos2d::Node* node) const = 0;
 
     virtual bool store(PropertyHandler& handler,
                        const cocos2d::Node* node) const = 0;
 
+    LoadFunction getLoadFunction() const;
+    StoreFunction getStoreFunction() const;
+
+    /// Converts this property from the form written by older versions.
+    /// @return Whether the property was converted.
+    bool migrate(PropertyHandler& handler) const;
+
+protected:
+    void setFunctions(LoadFunction load, StoreFunction store);
+    void setMigrateFunction(MigrateFunction migrate);
+
 private:
-    std::string name_;
+    static bool loadVirtual(const Property& property,
+                            const PropertyHandler& handler,
+                            cocos2d::Node* node);
+    static bool storeVirtual(const Property& property, PropertyHandler& handler,
+                             const cocos2d::Node* node);
+
+    Symbol symbol_;
+    LoadFunction load_;
+    StoreFunction store_;
+    MigrateFunction migrate_;
+};
+
+/// Compile-time accessor bound to a getter/setter pair of Target.
+/// The node is assumed to be a Target, which the owning loader guarantees,
+/// so it is downcast statically.
+template <class Target, class ValueT, auto Getter, auto Setter>
+struct MemberAccessor {
+    using Value = ValueT;
+
+    static std::optional<Value> read(const cocos2d::Node* node) {
+        assert(dynamic_cast<const Target*>(node) != nullptr);
+        return static_cast<Value>((static_cast<const Target*>(node)->*Getter)());
+    }
+
+    static bool write(cocos2d::Node* node, const Value& value) {
+        assert(dynamic_cast<Target*>(node) != nullptr);
+        (static_cast<Target*>(node)->*Setter)(value);
+        return true;
+    }
 };
 
 /// A node property.
@@ -55,16 +108,41 @@ public:
                              const Writer& writer)
         : Super(name)
         , reader_(reader)
-        , writer_(writer) {}
+        , writer_(writer)
+        , rawReader_(nullptr)
+        , rawWriter_(nullptr) {
+        setMigrateFunction(&PropertyTraits<Value>::migrateProperty);
+    }
+
+    /// Constructs a property whose accessors are resolved at compile time.
+    template <class Target, auto Getter, auto Setter>
+    explicit GenericProperty(
+        const std::string& name,
+        MemberAccessor<Target, Value, Getter, Setter> accessor)
+        : Super(name)
+        , reader_(&decltype(accessor)::read)
+        , writer_(&decltype(accessor)::write)
+        , rawReader_(&decltype(accessor)::read)
+        , rawWriter_(&decltype(accessor)::write) {
+        setMigrateFunction(&PropertyTraits<Value>::migrateProperty);
+        setFunctions(&loadWith<decltype(accessor)>,
+                     &storeWith<decltype(accessor)>);
+    }
 
     const Reader& getReader() const { return reader_; }
     const Writer& getWriter() const { return writer_; }
 
     std::optional<Value> read(const cocos2d::Node* node) const {
+        if (rawReader_ != nullptr) {
+            return rawReader_(node);
+        }
         return getReader()(node);
     }
 
     bool write(cocos2d::Node* node, const Value& value) const {
+        if (rawWriter_ != nullptr) {
+            return rawWriter_(node, value);
+        }
         return getWriter()(node, value);
     }
 
@@ -75,8 +153,21 @@ public:
                        const cocos2d::Node* node) const override;
 
 private:
+    using RawReader = std::optional<Value> (*)(const cocos2d::Node* node);
+    using RawWriter = bool (*)(cocos2d::Node* node, const Value& value);
+
+    template <class Accessor>
+    static bool loadWith(const ee::Property& property,
+                         const PropertyHandler& handler, cocos2d::Node* node);
+
+    template <class Accessor>
+    static bool storeWith(const ee::Property& property,
+                          PropertyHandler& handler, const cocos2d::Node* node);
+
     Reader reader_;
     Writer writer_;
+    RawReader rawReader_;
+    RawWriter rawWriter_;
 };
 
 template <class Target, class Value>
@@ -108,6 +199,12 @@ typename GenericProperty<Value>::Writer makePropertyWriter(
 
 template <class Target>
 struct PropertyHelper {
+    /// Makes an accessor from a getter/setter pair of Target.
+    template <class Value, auto Getter, auto Setter>
+    static constexpr auto makeAccessor() {
+        return MemberAccessor<Target, Value, Getter, Setter>();
+    }
+
     template <class Value, class Reader>
     static auto makeReader(const Reader& reader) {
         return makePropertyReader<Target, Value>(reader);
@@ -140,6 +237,29 @@ bool GenericProperty<T>::store(PropertyHandler& handler,
                                const cocos2d::Node* node) const {
     return handler.storeProperty(*this, node);
 }
+
+template <class T>
+template <class Accessor>
+bool GenericProperty<T>::loadWith(const ee::Property& property,
+                                  const PropertyHandler& handler,
+                                  cocos2d::Node* node) {
+    return handler.loadValue<T>(property.getSymbol(), [node](const T& value) {
+        return Accessor::write(node, value);
+    });
+}
+
+template <class T>
+template <class Accessor>
+bool GenericProperty<T>::storeWith(const ee::Property& property,
+                                   PropertyHandler& handler,
+                                   const cocos2d::Node* node) {
+    auto value = Accessor::read(node);
+    if (not value.has_value()) {
+        return false;
+    }
+    handler.setProperty<T>(property.getSymbol(), value.value());
+    return true;
+}
 } // namespace ee
 
 #endif // EE_PARSER_PROPERTY_HPP
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <ciso646>
 
 #include "propertyhandler.hpp"
@@ -7,31 +8,92 @@ using Self = PropertyHandler;
 
 Self::PropertyHandler() {}
 
-const ValueMap& Self::getProperties() const {
-    return properties_;
+ValueMap Self::getProperties() const {
+    ValueMap properties;
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+        properties.emplace(keys_[i].getName(), values_[i]);
+    }
+    return properties;
 }
 
 void Self::setProperties(const ValueMap& properties) {
-    properties_ = properties;
+    clearProperties();
+    keys_.reserve(properties.size());
+    values_.reserve(properties.size());
+    for (auto&& elt : properties) {
+        setProperty(elt.first, elt.second);
+    }
 }
 
 void Self::clearProperties() {
-    properties_.clear();
+    keys_.clear();
+    values_.clear();
+}
+
+std::size_t Self::getPropertyCount() const {
+    return keys_.size();
+}
+
+void Self::reserve(std::size_t count) {
+    keys_.reserve(count);
+    values_.reserve(count);
 }
 
-bool Self::hasProperty(const std::string& name) const {
-    return properties_.count(name) != 0;
+const std::vector<Symbol>& Self::getPropertyKeys() const {
+    return keys_;
 }
 
-std::optional<Value> Self::getProperty(const std::string& name) const {
-    if (not hasProperty(name)) {
+const std::vector<Value>& Self::getPropertyValues() const {
+    return values_;
+}
+
+bool Self::hasProperty(Symbol name) const {
+    return findProperty(name) != nullptr;
+}
+
+std::optional<Value> Self::getProperty(Symbol name) const {
+    auto value = findProperty(name);
+    if (value == nullptr) {
         return std::nullopt;
     }
-    return properties_.at(name);
+    return *value;
+}
+
+void Self::setProperty(Symbol name, const Value& value) {
+    setProperty(name, Value(value));
+}
+
+void Self::setProperty(Symbol name, Value&& value) {
+    auto index = lowerBound(name);
+    if (index < keys_.size() && keys_[index] == name) {
+        values_[index] = std::move(value);
+        return;
+    }
+    keys_.insert(keys_.begin() + index, name);
+    values_.insert(values_.begin() + index, std::move(value));
+}
+
+bool Self::removeProperty(Symbol name) {
+    auto index = lowerBound(name);
+    if (index == keys_.size() || keys_[index] != name) {
+        return false;
+    }
+    keys_.erase(keys_.begin() + index);
+    values_.erase(values_.begin() + index);
+    return true;
+}
+
+const Value* Self::findProperty(Symbol name) const {
+    auto index = lowerBound(name);
+    if (index < keys_.size() && keys_[index] == name) {
+        return &values_[index];
+    }
+    return nullptr;
 }
 
-void Self::setProperty(const std::string& name, const Value& value) {
-    properties_[name] = value;
+std::size_t Self::lowerBound(Symbol name) const {
+    auto iter = std::lower_bound(keys_.cbegin(), keys_.cend(), name);
+    return static_cast<std::size_t>(iter - keys_.cbegin());
 }
 
 bool Self::loadProperty(const Property& property, cocos2d::Node* node) const {
@@ -3,11 +3,16 @@
 
 #include <functional>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "parserfwd.hpp"
 #include "propertytraits.hpp"
+#include "symbol.hpp"
+#include "value.hpp"
 
 namespace ee {
+/// Stores properties as parallel key/value arrays sorted by symbol id.
 class PropertyHandler {
 private:
     using Self = PropertyHandler;
@@ -15,28 +20,55 @@ private:
 public:
     PropertyHandler();
 
-    const ValueMap& getProperties() const;
+    /// Builds a name-ordered dictionary of all properties.
+    ValueMap getProperties() const;
     void setProperties(const ValueMap& properties);
     void clearProperties();
 
-    bool hasProperty(const std::string& name) const;
-    std::optional<Value> getProperty(const std::string& name) const;
-    void setProperty(const std::string& name, const Value& value);
+    /// Gets the number of properties.
+    std::size_t getPropertyCount() const;
+
+    /// Reserves storage for the specified number of properties.
+    void reserve(std::size_t count);
+
+    /// Gets the keys, in the same order as the values.
+    const std::vector<Symbol>& getPropertyKeys() const;
+
+    /// Gets the values, in the same order as the keys.
+    const std::vector<Value>& getPropertyValues() const;
+
+    bool hasProperty(Symbol name) const;
+    std::optional<Value> getProperty(Symbol name) const;
+    void setProperty(Symbol name, const Value& value);
+    void setProperty(Symbol name, Value&& value);
+
+    /// Removes a property.
+    /// @return Whether the property existed.
+    bool removeProperty(Symbol name);
+
+    /// Finds a property without copying it.
+    /// @return nullptr if the property does not exist.
+    const Value* findProperty(Symbol name) const;
 
     /// Reads a property value from the specified property handler.
     /// @param name The property's name.
     template <class T>
-    std::optional<T> getProperty(const std::string& name) const {
+    std::optional<T> getProperty(Symbol name) const {
         return PropertyTraits<T>::getProperty(*this, name);
     }
 
     /// Writes a property value to the specified property handler.
     /// @param name The property's name.
     template <class T>
-    void setProperty(const std::string& name, const T& value) {
+    void setProperty(Symbol name, const T& value) {
         PropertyTraits<T>::setProperty(*this, name, value);
     }
 
+    /// Reads the specified property and passes it to the writer.
+    /// @param writer Callable taking a const T&, returns whether successful.
+    template <class T, class Writer>
+    bool loadValue(Symbol name, Writer&& writer) const;
+
     bool loadProperty(const Property& property, cocos2d::Node* node) const;
     bool storeProperty(const Property& property, const cocos2d::Node* node);
 
@@ -49,21 +81,40 @@ public:
                        const cocos2d::Node* node);
 
 private:
-    ValueMap properties_;
+    std::size_t lowerBound(Symbol name) const;
+
+    std::vector<Symbol> keys_;
+    std::vector<Value> values_;
 };
 } // namespace ee
 
 #include "property.hpp"
 
 namespace ee {
+template <class T, class Writer>
+bool PropertyHandler::loadValue(Symbol name, Writer&& writer) const {
+    if constexpr (std::is_same<T, std::string>::value) {
+        // Avoid copying the string.
+        auto value = findProperty(name);
+        if (value == nullptr || not value->isString()) {
+            return false;
+        }
+        return writer(value->asString());
+    } else {
+        auto value = getProperty<T>(name);
+        if (not value.has_value()) {
+            return false;
+        }
+        return writer(value.value());
+    }
+}
+
 template <class T>
 bool PropertyHandler::loadProperty(const GenericProperty<T>& property,
                                    cocos2d::Node* node) const {
-    auto value = getProperty<T>(property.getName());
-    if (not value.has_value()) {
-        return false;
-    }
-    return property.write(node, value.value());
+    return loadValue<T>(property.getSymbol(), [&](const T& value) {
+        return property.write(node, value);
+    });
 }
 
 template <class T>
@@ -73,7 +124,7 @@ bool PropertyHandler::storeProperty(const GenericProperty<T>& property,
     if (not value.has_value()) {
         return false;
     }
-    setProperty<T>(property.getName(), value.value());
+    setProperty<T>(property.getSymbol(), value.value());
     return true;
 }
 } // namespace ee
@@ -1,3 +1,5 @@
+#include <array>
+
 #include "propertytraits.hpp"
 #include "propertyhandler.hpp"
 
@@ -10,181 +12,269 @@ namespace detail {
 template <class T>
 using Self = PropertyTraitsNonEnum<T>;
 
+using Component = Symbol::Component;
+
+namespace {
+/// Reads the specified components, all of them must exist.
+template <class T, std::size_t N>
+bool readComponents(const PropertyHandler& handler,
+                    const std::array<Symbol, N>& keys,
+                    std::array<T, N>& values) {
+    for (std::size_t i = 0; i < N; ++i) {
+        auto value = handler.getProperty<T>(keys[i]);
+        if (not value.has_value()) {
+            return false;
+        }
+        values[i] = value.value();
+    }
+    return true;
+}
+
+template <std::size_t N>
+void removeComponents(PropertyHandler& handler,
+                      const std::array<Symbol, N>& keys) {
+    for (auto&& key : keys) {
+        handler.removeProperty(key);
+    }
+}
+
+/// Gets the height component, old versions misspelled it as name_heght.
+Symbol getHeightKey(const PropertyHandler& handler, Symbol name) {
+    auto key = name.getComponent(Component::Height);
+    if (handler.hasProperty(key)) {
+        return key;
+    }
+    return Symbol(name.getName() + "_heght");
+}
+} // namespace
+
 template <>
 std::optional<bool> Self<bool>::getProperty(const PropertyHandler& handler,
-                                            const std::string& name) {
-    auto&& value = handler.getProperty(name);
-    return map(value, std::mem_fn(&Value::getBool));
+                                            Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getBool();
 }
 
 template <>
-void Self<bool>::setProperty(PropertyHandler& handler, const std::string& name,
+void Self<bool>::setProperty(PropertyHandler& handler, Symbol name,
                              const bool& value) {
     handler.setProperty(name, Value(value));
 }
 
+template <>
+bool Self<bool>::migrateProperty(PropertyHandler& handler, Symbol name) {
+    (void)handler;
+    (void)name;
+    return false;
+}
+
 template <>
 std::optional<int> Self<int>::getProperty(const PropertyHandler& handler,
-                                          const std::string& name) {
-    auto&& value = handler.getProperty(name);
-    return map(value, std::mem_fn(&Value::getInt));
+                                          Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getInt();
 }
 
 template <>
-void Self<int>::setProperty(PropertyHandler& handler, const std::string& name,
+void Self<int>::setProperty(PropertyHandler& handler, Symbol name,
                             const int& value) {
     handler.setProperty(name, Value(value));
 }
 
+template <>
+bool Self<int>::migrateProperty(PropertyHandler& handler, Symbol name) {
+    (void)handler;
+    (void)name;
+    return false;
+}
+
 template <>
 std::optional<float> Self<float>::getProperty(const PropertyHandler& handler,
-                                              const std::string& name) {
-    auto&& value = handler.getProperty(name);
-    return map(value, std::mem_fn(&Value::getFloat));
+                                              Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getFloat();
 }
 
 template <>
-void Self<float>::setProperty(PropertyHandler& handler, const std::string& name,
+void Self<float>::setProperty(PropertyHandler& handler, Symbol name,
                               const float& value) {
     handler.setProperty(name, Value(value));
 }
 
+template <>
+bool Self<float>::migrateProperty(PropertyHandler& handler, Symbol name) {
+    (void)handler;
+    (void)name;
+    return false;
+}
+
 template <>
 std::optional<std::string>
-Self<std::string>::getProperty(const PropertyHandler& handler,
-                               const std::string& name) {
-    auto&& value = handler.getProperty(name);
-    return map(value, std::mem_fn(&Value::getString));
+Self<std::string>::getProperty(const PropertyHandler& handler, Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getString();
 }
 
 template <>
-void Self<std::string>::setProperty(PropertyHandler& handler,
-                                    const std::string& name,
+void Self<std::string>::setProperty(PropertyHandler& handler, Symbol name,
                                     const std::string& value) {
     handler.setProperty(name, Value(value));
 }
 
+template <>
+bool Self<std::string>::migrateProperty(PropertyHandler& handler, Symbol name) {
+    (void)handler;
+    (void)name;
+    return false;
+}
+
 template <>
 std::optional<cocos2d::BlendFunc>
 Self<cocos2d::BlendFunc>::getProperty(const PropertyHandler& handler,
-                                      const std::string& name) {
-    auto src = handler.getProperty<int>(name + "_src");
-    return map(src, [&](int src_) {
-        auto dst = handler.getProperty<int>(name + "_dst");
-        return map(dst, [&](int dst_) {
-            cocos2d::BlendFunc blend;
-            blend.src = static_cast<GLenum>(src_);
-            blend.dst = static_cast<GLenum>(dst_);
-            return std::make_optional(blend);
-        });
-    });
+                                      Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getBlend();
 }
 
 template <>
 void Self<cocos2d::BlendFunc>::setProperty(PropertyHandler& handler,
-                                           const std::string& name,
+                                           Symbol name,
                                            const cocos2d::BlendFunc& value) {
-    handler.setProperty(name + "_src", Value(static_cast<int>(value.src)));
-    handler.setProperty(name + "_dst", Value(static_cast<int>(value.dst)));
+    handler.setProperty(name, Value(value));
+}
+
+template <>
+bool Self<cocos2d::BlendFunc>::migrateProperty(PropertyHandler& handler,
+                                               Symbol name) {
+    std::array<Symbol, 2> keys = {name.getComponent(Component::Src),
+                                  name.getComponent(Component::Dst)};
+    std::array<int, 2> values;
+    if (not readComponents(handler, keys, values)) {
+        return false;
+    }
+    removeComponents(handler, keys);
+    cocos2d::BlendFunc blend;
+    blend.src = static_cast<GLenum>(values[0]);
+    blend.dst = static_cast<GLenum>(values[1]);
+    handler.setProperty(name, Value(blend));
+    return true;
 }
 
 template <>
 std::optional<cocos2d::Color3B>
 Self<cocos2d::Color3B>::getProperty(const PropertyHandler& handler,
-                                    const std::string& name) {
-    auto r = handler.getProperty<int>(name + "_r");
-    return map(r, [&](int r_) {
-        auto g = handler.getProperty<int>(name + "_g");
-        return map(g, [&](int g_) {
-            auto b = handler.getProperty<int>(name + "_b");
-            return map(b, [&](int b_) {
-                return std::make_optional(
-                    cocos2d::Color3B(static_cast<GLubyte>(r_), //
-                                     static_cast<GLubyte>(g_), //
-                                     static_cast<GLubyte>(b_)));
-            });
-        });
-    });
-}
-
-template <>
-void Self<cocos2d::Color3B>::setProperty(PropertyHandler& handler,
-                                         const std::string& name,
+                                    Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getColor();
+}
+
+template <>
+void Self<cocos2d::Color3B>::setProperty(PropertyHandler& handler, Symbol name,
                                          const cocos2d::Color3B& value) {
-    handler.setProperty(name + "_r", Value(static_cast<int>(value.r)));
-    handler.setProperty(name + "_g", Value(static_cast<int>(value.r)));
-    handler.setProperty(name + "_b", Value(static_cast<int>(value.r)));
+    handler.setProperty(name, Value(value));
+}
+
+template <>
+bool Self<cocos2d::Color3B>::migrateProperty(PropertyHandler& handler,
+                                             Symbol name) {
+    std::array<Symbol, 3> keys = {name.getComponent(Component::R),
+                                  name.getComponent(Component::G),
+                                  name.getComponent(Component::B)};
+    std::array<int, 3> values;
+    if (not readComponents(handler, keys, values)) {
+        return false;
+    }
+    removeComponents(handler, keys);
+    handler.setProperty(name, Value(cocos2d::Color3B(
+                                  static_cast<GLubyte>(values[0]), //
+                                  static_cast<GLubyte>(values[1]), //
+                                  static_cast<GLubyte>(values[2]))));
+    return true;
 }
 
 template <>
 std::optional<cocos2d::Point>
 Self<cocos2d::Point>::getProperty(const PropertyHandler& handler,
-                                  const std::string& name) {
-    auto x = handler.getProperty<float>(name + "_x");
-    return map(x, [&](float x_) {
-        auto y = handler.getProperty<float>(name + "_y");
-        return map(y, [&](float y_) { //
-            return std::make_optional(cocos2d::Point(x_, y_));
-        });
-    });
+                                  Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getVec2();
 }
 
 template <>
-void Self<cocos2d::Point>::setProperty(PropertyHandler& handler,
-                                       const std::string& name,
+void Self<cocos2d::Point>::setProperty(PropertyHandler& handler, Symbol name,
                                        const cocos2d::Point& value) {
-    handler.setProperty(name + "_x", Value(value.x));
-    handler.setProperty(name + "_y", Value(value.y));
+    handler.setProperty(name, Value(value));
+}
+
+template <>
+bool Self<cocos2d::Point>::migrateProperty(PropertyHandler& handler,
+                                           Symbol name) {
+    std::array<Symbol, 2> keys = {name.getComponent(Component::X),
+                                  name.getComponent(Component::Y)};
+    std::array<float, 2> values;
+    if (not readComponents(handler, keys, values)) {
+        return false;
+    }
+    removeComponents(handler, keys);
+    handler.setProperty(name, Value(cocos2d::Point(values[0], values[1])));
+    return true;
 }
 
 template <>
 std::optional<cocos2d::Rect>
-Self<cocos2d::Rect>::getProperty(const PropertyHandler& handler,
-                                 const std::string& name) {
-    auto x = handler.getProperty<float>(name + "_x");
-    return map(x, [&](float x_) {
-        auto y = handler.getProperty<float>(name + "_y");
-        return map(y, [&](float y_) {
-            auto w = handler.getProperty<float>(name + "_width");
-            return map(w, [&](float w_) {
-                auto h = handler.getProperty<float>(name + "_height");
-                return map(h, [&](float h_) { //
-                    return std::make_optional(cocos2d::Rect(x_, y_, w_, h_));
-                });
-            });
-        });
-    });
-}
-
-template <>
-void Self<cocos2d::Rect>::setProperty(PropertyHandler& handler,
-                                      const std::string& name,
+Self<cocos2d::Rect>::getProperty(const PropertyHandler& handler, Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getRect();
+}
+
+template <>
+void Self<cocos2d::Rect>::setProperty(PropertyHandler& handler, Symbol name,
                                       const cocos2d::Rect& value) {
-    handler.setProperty(name + "_x", Value(value.origin.x));
-    handler.setProperty(name + "_y", Value(value.origin.y));
-    handler.setProperty(name + "_width", Value(value.size.width));
-    handler.setProperty(name + "_heght", Value(value.size.height));
+    handler.setProperty(name, Value(value));
+}
+
+template <>
+bool Self<cocos2d::Rect>::migrateProperty(PropertyHandler& handler,
+                                          Symbol name) {
+    std::array<Symbol, 4> keys = {name.getComponent(Component::X),
+                                  name.getComponent(Component::Y),
+                                  name.getComponent(Component::Width),
+                                  getHeightKey(handler, name)};
+    std::array<float, 4> values;
+    if (not readComponents(handler, keys, values)) {
+        return false;
+    }
+    removeComponents(handler, keys);
+    handler.setProperty(name, Value(cocos2d::Rect(values[0], values[1],
+                                                  values[2], values[3])));
+    return true;
 }
 
 template <>
 std::optional<cocos2d::Size>
-Self<cocos2d::Size>::getProperty(const PropertyHandler& handler,
-                                 const std::string& name) {
-    auto w = handler.getProperty<float>(name + "_width");
-    return map(w, [&](float w_) {
-        auto h = handler.getProperty<float>(name + "_height");
-        return map(h, [&](float h_) { //
-            return std::make_optional(cocos2d::Size(w_, h_));
-        });
-    });
+Self<cocos2d::Size>::getProperty(const PropertyHandler& handler, Symbol name) {
+    auto value = handler.findProperty(name);
+    return value == nullptr ? std::nullopt : value->getSize();
 }
 
 template <>
-void Self<cocos2d::Size>::setProperty(PropertyHandler& handler,
-                                      const std::string& name,
+void Self<cocos2d::Size>::setProperty(PropertyHandler& handler, Symbol name,
                                       const cocos2d::Size& value) {
-    handler.setProperty(name + "_width", Value(value.width));
-    handler.setProperty(name + "_heght", Value(value.height));
+    handler.setProperty(name, Value(value));
+}
+
+template <>
+bool Self<cocos2d::Size>::migrateProperty(PropertyHandler& handler,
+                                          Symbol name) {
+    std::array<Symbol, 2> keys = {name.getComponent(Component::Width),
+                                  getHeightKey(handler, name)};
+    std::array<float, 2> values;
+    if (not readComponents(handler, keys, values)) {
+        return false;
+    }
+    removeComponents(handler, keys);
+    handler.setProperty(name, Value(cocos2d::Size(values[0], values[1])));
+    return true;
 }
 } // namespace detail
 } // namespace ee
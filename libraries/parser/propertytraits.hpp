@@ -5,6 +5,7 @@
 
 #include "optional.hpp"
 #include "parserfwd.hpp"
+#include "symbol.hpp"
 
 namespace ee {
 namespace detail {
@@ -14,19 +15,24 @@ public:
     /// Reads a property value from the specified property handler.
     /// @param name The property's name.
     static std::optional<Value> getProperty(const PropertyHandler& handler,
-                                            const std::string& name);
+                                            Symbol name);
 
     /// Writes a property value to the specified property handler.
     /// @param name The property's name.
-    static void setProperty(PropertyHandler& handler, const std::string& name,
+    static void setProperty(PropertyHandler& handler, Symbol name,
                             const Value& value);
+
+    /// Converts the property from the per-component form written by older
+    /// versions, e.g. name_x and name_y, to its packed form.
+    /// @return Whether the property was converted.
+    static bool migrateProperty(PropertyHandler& handler, Symbol name);
 };
 
 template <class Value>
 class PropertyTraitsEnum {
 public:
     static std::optional<Value> getProperty(const PropertyHandler& handler,
-                                            const std::string& name) {
+                                            Symbol name) {
         auto value = PropertyTraitsNonEnum<int>::getProperty(handler, name);
         return map(value,
                    [](int value_) { //
@@ -34,11 +40,17 @@ public:
                    });
     }
 
-    static void setProperty(PropertyHandler& handler, const std::string& name,
+    static void setProperty(PropertyHandler& handler, Symbol name,
                             Value value) {
         PropertyTraitsNonEnum<int>::setProperty(handler, name,
                                                 static_cast<int>(value));
     }
+
+    static bool migrateProperty(PropertyHandler& handler, Symbol name) {
+        (void)handler;
+        (void)name;
+        return false;
+    }
 };
 } // namespace detail
 
@@ -8,16 +8,14 @@ using Target = cocos2d::ui::Scale9Sprite;
 using Helper = PropertyHelper<Target>;
 
 const PropertyEnum<Target::State> Self::Property::State(
-    "state", //
-    Helper::makeReader<Target::State>(std::mem_fn(&Target::getState)),
-    Helper::makeWriter<Target::State>(std::mem_fn(&Target::setState)));
-
-const PropertyEnum<Target::RenderingType>
-    Self::Property::RenderingType("rendering_type",
-                                  Helper::makeReader<Target::RenderingType>(
-                                      std::mem_fn(&Target::getRenderingType)),
-                                  Helper::makeWriter<Target::RenderingType>(
-                                      std::mem_fn(&Target::setRenderingType)));
+    "state",
+    Helper::makeAccessor<Target::State, &Target::getState,
+                         &Target::setState>());
+
+const PropertyEnum<Target::RenderingType> Self::Property::RenderingType(
+    "rendering_type",
+    Helper::makeAccessor<Target::RenderingType, &Target::getRenderingType,
+                         &Target::setRenderingType>());
 
 const std::string Self::Name = "_Scale9Sprite";
 
@@ -1,3 +1,5 @@
+#include <ciso646>
+
 #include "skeletonanimationloader.hpp"
 #include "nodeinfo.hpp"
 #include "skeletonanimationmanager.hpp"
@@ -21,8 +23,22 @@ constexpr auto time_scale = "time_scale";
 constexpr auto blend_func = "blend_func";
 constexpr auto debug_bones = "debug_bones";
 constexpr auto debug_slots = "debug_slots";
+constexpr auto skeleton_data = "skeleton_data";
 } // namespace key
 
+/// Interned once, converting a name to a symbol locks the symbol table.
+namespace symbol {
+const Symbol initialized(key::initialized);
+const Symbol data_file(key::data_file);
+const Symbol atlas_file(key::atlas_file);
+const Symbol animation_scale(key::animation_scale);
+const Symbol animation(key::animation);
+const Symbol skin(key::skin);
+const Symbol loop(key::loop);
+const Symbol blend_func(key::blend_func);
+const Symbol skeleton_data(key::skeleton_data);
+} // namespace symbol
+
 namespace defaults {
 constexpr auto initialized = false;
 constexpr auto animation_scale = 1.0f;
@@ -32,87 +48,110 @@ constexpr auto loop = false;
 } // namespace defaults
 
 namespace {
-void initializeNode(Target* node, const std::string& dataFile,
-                    const std::string& atlasFile, float scale) {
+/// Re-creates the skeleton from the data and atlas files.
+void initializeNode(Target* node) {
+    auto dataFile = Self::Property::DataFile.read(node);
+    auto atlasFile = Self::Property::AtlasFile.read(node);
+    if (not dataFile || not atlasFile) {
+        return;
+    }
+    auto scale = Self::Property::AnimationScale.read(node).value();
     auto animation = Self::Property::Animation.read(node);
     auto skin = Self::Property::Skin.read(node);
     auto loop = Self::Property::Loop.read(node);
     auto timeScale = Self::Property::TimeScale.read(node);
     auto&& handler = NodeInfo::getPropertyHandler(node);
-    auto initialized = handler.getProperty<bool>(key::initialized)
+    // Reset by the initialization.
+    auto blendFunc =
+        handler.getProperty<cocos2d::BlendFunc>(symbol::blend_func);
+    auto initialized = handler.getProperty<bool>(symbol::initialized)
                            .value_or(defaults::initialized);
     if (initialized) {
         spSkeleton_dispose(node->getSkeleton());
     }
     auto&& manager = SkeletonAnimationManager::getInstance();
-    auto data = manager.getSkeletonData(dataFile, atlasFile, scale);
+    auto data = manager.getSkeletonData(*dataFile, *atlasFile, scale);
     if (data == nullptr) {
         data = manager.getNullSkeletonData();
     }
-    node->initWithData(data);
+    node->initWithData(data.get());
+    // The node does not own the skeleton data, keep it referenced in the
+    // cache until the node is detached or initialized again.
+    auto info = NodeInfo::getInfo(node);
+    info->setResource(symbol::skeleton_data, std::move(data));
     Self::Property::Animation.write(node, animation.value());
     Self::Property::Skin.write(node, skin.value());
     Self::Property::Loop.write(node, loop.value());
     Self::Property::TimeScale.write(node, timeScale.value());
-    handler.setProperty(key::initialized, true);
+    if (blendFunc) {
+        node->setBlendFunc(*blendFunc);
+    }
+    handler.setProperty(symbol::initialized, true);
+}
+
+/// Initializes the node now, or once when the current batch is committed.
+void updateNode(Target* node) {
+    auto info = NodeInfo::getInfo(node);
+    if (info->isBatching()) {
+        info->addPendingUpdate(symbol::initialized);
+        return;
+    }
+    initializeNode(node);
+}
+
+/// Checks whether the skeleton is about to be re-created, in which case the
+/// animation state is applied by initializeNode.
+bool isUpdatePending(Target* node) {
+    return NodeInfo::getInfo(node)->hasPendingUpdate(symbol::initialized);
 }
 } // namespace
 
 const PropertyString Self::Property::DataFile(
     key::data_file, Helper::makeReader<std::string>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<std::string>(key::data_file);
+        return handler.getProperty<std::string>(symbol::data_file);
     }),
     Helper::makeWriter<std::string>([](Target* node, const std::string& value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty(key::data_file, value);
-        auto animationScale = AnimationScale.read(node);
-        auto atlasFile = AtlasFile.read(node);
-        if (animationScale && atlasFile) {
-            initializeNode(node, value, *atlasFile, *animationScale);
-        }
+        handler.setProperty(symbol::data_file, value);
+        updateNode(node);
     }));
 
 const PropertyString Self::Property::AtlasFile(
     key::atlas_file, Helper::makeReader<std::string>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<std::string>(key::atlas_file);
+        return handler.getProperty<std::string>(symbol::atlas_file);
     }),
     Helper::makeWriter<std::string>([](Target* node, const std::string& value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty(key::atlas_file, value);
-        auto animationScale = AnimationScale.read(node);
-        auto dataFile = DataFile.read(node);
-        if (animationScale && dataFile) {
-            initializeNode(node, *dataFile, value, *animationScale);
-        }
+        handler.setProperty(symbol::atlas_file, value);
+        updateNode(node);
     }));
 
 const PropertyFloat Self::Property::AnimationScale(
     key::animation_scale, Helper::makeReader<float>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<float>(key::animation_scale)
+        return handler.getProperty<float>(symbol::animation_scale)
             .value_or(defaults::animation_scale);
     }),
     Helper::makeWriter<float>([](Target* node, float value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty(key::animation_scale, value);
-        auto atlasFile = AtlasFile.read(node);
-        auto dataFile = DataFile.read(node);
-        if (atlasFile && dataFile) {
-            initializeNode(node, *dataFile, *atlasFile, value);
-        }
+        handler.setProperty(symbol::animation_scale, value);
+        updateNode(node);
     }));
 
 const PropertyString Self::Property::Animation(
     key::animation, Helper::makeReader<std::string>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<std::string>(key::animation)
+        return handler.getProperty<std::string>(symbol::animation)
             .value_or(defaults::animation);
     }),
     Helper::makeWriter<std::string>([](Target* node, const std::string& value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty(key::animation, value);
+        handler.setProperty(symbol::animation, value);
+        if (isUpdatePending(node)) {
+            return;
+        }
         auto loop = Loop.read(node).value();
         auto entry = node->setAnimation(0, value, loop);
     }));
@@ -120,46 +159,59 @@ const PropertyString Self::Property::Animation(
 const PropertyString Self::Property::Skin(
     key::skin, Helper::makeReader<std::string>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<std::string>(key::skin).value_or(
+        return handler.getProperty<std::string>(symbol::skin).value_or(
             defaults::skin);
     }),
     Helper::makeWriter<std::string>([](Target* node, const std::string& value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty(key::skin, value);
+        handler.setProperty(symbol::skin, value);
+        if (isUpdatePending(node)) {
+            return;
+        }
         node->setSkin(value);
     }));
 
 const PropertyBool Self::Property::Loop(
     key::loop, Helper::makeReader<bool>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<bool>(key::loop).value_or(defaults::loop);
+        return handler.getProperty<bool>(symbol::loop).value_or(defaults::loop);
     }),
     Helper::makeWriter<bool>([](Target* node, bool value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty(key::loop, value);
+        handler.setProperty(symbol::loop, value);
+        if (isUpdatePending(node)) {
+            return;
+        }
         auto animation = Animation.read(node).value();
         auto entry = node->setAnimation(0, animation, value);
     }));
 
 const PropertyFloat Self::Property::TimeScale(
-    key::time_scale, //
-    Helper::makeReader<float>(std::mem_fn(&Target::getTimeScale)),
-    Helper::makeWriter<float>(std::mem_fn(&Target::setTimeScale)));
+    key::time_scale,
+    Helper::makeAccessor<float, &Target::getTimeScale,
+                         &Target::setTimeScale>());
 
 const PropertyBlend Self::Property::BlendFunc(
     key::blend_func,
-    Helper::makeReader<cocos2d::BlendFunc>(std::mem_fn(&Target::getBlendFunc)),
-    Helper::makeWriter<cocos2d::BlendFunc>(std::mem_fn(&Target::setBlendFunc)));
+    Helper::makeReader<cocos2d::BlendFunc>(
+        [](const Target* node) { return node->getBlendFunc(); }),
+    Helper::makeWriter<cocos2d::BlendFunc>(
+        [](Target* node, const cocos2d::BlendFunc& value) {
+            // Kept to be applied again when the skeleton is re-created.
+            auto&& handler = NodeInfo::getPropertyHandler(node);
+            handler.setProperty(symbol::blend_func, value);
+            node->setBlendFunc(value);
+        }));
 
 const PropertyBool Self::Property::DebugBones(
     key::debug_bones,
-    Helper::makeReader<bool>(std::mem_fn(&Target::getDebugBonesEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setDebugBonesEnabled)));
+    Helper::makeAccessor<bool, &Target::getDebugBonesEnabled,
+                         &Target::setDebugBonesEnabled>());
 
 const PropertyBool Self::Property::DebugSlots(
     key::debug_slots,
-    Helper::makeReader<bool>(std::mem_fn(&Target::getDebugSlotsEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setDebugSlotsEnabled)));
+    Helper::makeAccessor<bool, &Target::getDebugSlotsEnabled,
+                         &Target::setDebugSlotsEnabled>());
 
 const std::string Self::Name = "_SkeletonAnimation";
 
@@ -186,6 +238,14 @@ cocos2d::Node* Self::createNode() const {
     return Target::create();
 }
 
+void Self::commitProperties(cocos2d::Node* node) const {
+    Super::commitProperties(node);
+    auto target = dynamic_cast<Target*>(node);
+    if (NodeInfo::getInfo(target)->takePendingUpdate(symbol::initialized)) {
+        initializeNode(target);
+    }
+}
+
 Self* Self::cloneRaw() const {
     return new Self();
 }
@@ -37,6 +37,9 @@ public:
     virtual cocos2d::Node* createNode() const override;
 
 protected:
+    /// @see Super.
+    virtual void commitProperties(cocos2d::Node* node) const override;
+
     /// @see Super.
     virtual Self* cloneRaw() const override;
 };
@@ -1,41 +1,44 @@
 #include <cassert>
+#include <ciso646>
+#include <cstring>
+#include <tuple>
 
 #include "skeletonanimationmanager.hpp"
+#include "skeletonbinarycache.hpp"
 
+#include <platform/CCFileUtils.h>
 #include <spine/Atlas.h>
 #include <spine/Cocos2dAttachmentLoader.h>
 #include <spine/SkeletonAnimation.h>
+#include <spine/SkeletonBinary.h>
 #include <spine/extension.h>
 
 namespace ee {
 namespace detail {
 struct SpineData {
-    explicit SpineData(spSkeletonData* data_, spAttachmentLoader* loader_)
+    explicit SpineData(spSkeletonData* data_, spAttachmentLoader* loader_,
+                       std::size_t size_)
         : data(data_)
-        , loader(loader_) {}
+        , loader(loader_)
+        , size(size_) {}
+
+    ~SpineData() {
+        spSkeletonData_dispose(data);
+        spAttachmentLoader_dispose(loader);
+    }
 
     spSkeletonData* data;
     spAttachmentLoader* loader;
-};
-
-namespace {
-const SpineAtlasDeleter& getAtlasDeleter() {
-    static SpineAtlasDeleter deleter = [](spAtlas* atlas) { //
-        spAtlas_dispose(atlas);
-    };
-    return deleter;
-}
 
-const SpineDataDeleter& getSkeletonDataDeleter() {
-    static SpineDataDeleter deleter = [](SpineData* data) {
-        spSkeletonData_dispose(data->data);
-        spAttachmentLoader_dispose(data->loader);
-    };
-    return deleter;
-}
-} // namespace
+    /// Approximate size, estimated from the size of the source file.
+    std::size_t size;
+};
 } // namespace detail
 
+namespace defaults {
+constexpr std::size_t budget = 64 * 1024 * 1024;
+} // namespace defaults
+
 namespace {
 spAtlas* createDummyAtlas() {
     auto self = new spAtlas();
@@ -51,6 +54,59 @@ spAtlas* createDummyAtlas() {
 std::string getDummyDataContent() {
     return R"({"bones":[]})";
 }
+
+std::size_t getAtlasSize(const spAtlas& atlas) {
+    std::size_t size = 0;
+    for (auto page = atlas.pages; page != nullptr; page = page->next) {
+        size += static_cast<std::size_t>(page->width) *
+                static_cast<std::size_t>(page->height) * 4;
+    }
+    return size;
+}
+
+bool isBinaryFile(const std::string& path) {
+    constexpr auto extension = ".skel";
+    auto length = std::strlen(extension);
+    return path.size() >= length &&
+           path.compare(path.size() - length, length, extension) == 0;
+}
+
+/// The binary reader does not handle missing regions, unlike the JSON reader
+/// which reports an error.
+bool hasRegions(spAtlas* atlas, const std::vector<std::string>& regions) {
+    for (auto&& region : regions) {
+        if (spAtlas_findRegion(atlas, region.c_str()) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+spSkeletonData* readBinaryData(spAttachmentLoader* attachmentLoader,
+                               const std::string& content, float scale) {
+    auto binary = spSkeletonBinary_createWithLoader(attachmentLoader);
+    binary->scale = scale;
+    auto skeletonData = spSkeletonBinary_readSkeletonData(
+        binary, reinterpret_cast<const unsigned char*>(content.data()),
+        static_cast<int>(content.size()));
+    spSkeletonBinary_dispose(binary);
+    return skeletonData;
+}
+
+spSkeletonData* readJsonData(spAttachmentLoader* attachmentLoader,
+                             const std::string& content, float scale) {
+    auto json = spSkeletonJson_createWithLoader(attachmentLoader);
+    json->scale = scale;
+    auto skeletonData = spSkeletonJson_readSkeletonData(json, content.c_str());
+    spSkeletonJson_dispose(json);
+    return skeletonData;
+}
+
+template <class T>
+bool isReady(const std::shared_future<T>& future) {
+    return future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+}
 } // namespace
 
 using Self = SkeletonAnimationManager;
@@ -63,63 +119,306 @@ Self& Self::getInstance() {
     return sharedInstance;
 }
 
-Self::SkeletonAnimationManager() {}
-Self::~SkeletonAnimationManager() {}
+Self::SkeletonAnimationManager()
+    : budget_(defaults::budget)
+    , useCounter_(0)
+    , cacheDirectory_()
+    , stats_()
+    , stopping_(false) {}
 
-spAtlas* Self::getAtlas(const std::string& atlasFile) {
-    auto iter = cachedAtlas_.find(atlasFile);
-    if (iter == cachedAtlas_.cend()) {
-        auto atlas = (atlasFile == NullAtlasFile
-                          ? createDummyAtlas()
-                          : spAtlas_createFromFile(atlasFile.c_str(), nullptr));
-        if (atlas == nullptr) {
-            return nullptr;
+Self::~SkeletonAnimationManager() {
+    std::deque<Task> tasks;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+        tasks.swap(tasks_);
+    }
+    taskCondition_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    // Fail the preloads that were not started instead of breaking their
+    // promises, a request waiting for one sees a failed load.
+    for (auto&& task : tasks) {
+        task.promise.set_value(nullptr);
+    }
+}
+
+bool Self::Key::operator<(const Key& other) const {
+    return std::tie(dataFile, atlasFile, scale) <
+           std::tie(other.dataFile, other.atlasFile, other.scale);
+}
+
+Self::AtlasPtr Self::getAtlas(const std::string& atlasFile) {
+    auto iter = atlases_.find(atlasFile);
+    if (iter != atlases_.cend()) {
+        auto atlas = iter->second.lock();
+        if (atlas) {
+            return atlas;
         }
-        auto ptr = detail::SpineAtlasPtr(atlas, detail::getAtlasDeleter());
-        iter = cachedAtlas_.emplace(atlasFile, std::move(ptr)).first;
     }
-    return iter->second.get();
+    auto atlas = (atlasFile == NullAtlasFile
+                      ? createDummyAtlas()
+                      : spAtlas_createFromFile(atlasFile.c_str(), nullptr));
+    if (atlas == nullptr) {
+        return nullptr;
+    }
+    auto ptr = AtlasPtr(atlas, spAtlas_dispose);
+    atlases_[atlasFile] = ptr;
+    return ptr;
 }
 
-spSkeletonData* Self::getSkeletonData(const std::string& dataFile,
-                                      const std::string& atlasFile,
-                                      float scale) {
-    auto iter = cachedSkeletonData_.find(std::make_pair(dataFile, scale));
-    if (iter == cachedSkeletonData_.cend()) {
-        auto&& atlas = getAtlas(atlasFile);
-        if (atlas == nullptr) {
+Self::SpineDataPtr Self::loadSkeletonData(const std::string& dataFile,
+                                          const std::string& fullPath,
+                                          const std::string& cacheDirectory,
+                                          spAtlas* atlas, float scale) {
+    std::string content;
+    if (dataFile == NullDataFile) {
+        content = getDummyDataContent();
+    } else {
+        // The full path is resolved by the caller, file utils only read here.
+        auto data = cocos2d::FileUtils::getInstance()->getDataFromFile(fullPath);
+        if (data.isNull()) {
             return nullptr;
         }
-        auto attachmentLoader = &Cocos2dAttachmentLoader_create(atlas)->super;
-        auto json = spSkeletonJson_createWithLoader(attachmentLoader);
-        json->scale = scale;
-
-        auto skeletonData =
-            (dataFile == NullDataFile
-                 ? spSkeletonJson_readSkeletonData(
-                       json, getDummyDataContent().c_str())
-                 : spSkeletonJson_readSkeletonDataFile(json, dataFile.c_str()));
-        if (skeletonData == nullptr) {
-            spSkeletonJson_dispose(json);
-            return nullptr;
+        // The spine parser expects a null-terminated string.
+        content.assign(reinterpret_cast<const char*>(data.getBytes()),
+                       static_cast<std::size_t>(data.getSize()));
+    }
+
+    auto attachmentLoader = &Cocos2dAttachmentLoader_create(atlas)->super;
+    spSkeletonData* skeletonData = nullptr;
+    if (isBinaryFile(dataFile)) {
+        skeletonData = readBinaryData(attachmentLoader, content, scale);
+    } else {
+        std::optional<SkeletonBinaryWriter::Result> binary;
+        if (not cacheDirectory.empty() && not fullPath.empty()) {
+            binary = SkeletonBinaryCache::get(cacheDirectory, fullPath, content);
+        }
+        if (binary && hasRegions(atlas, binary->regions)) {
+            skeletonData = readBinaryData(attachmentLoader, binary->data, scale);
+        } else {
+            skeletonData = readJsonData(attachmentLoader, content, scale);
         }
-        auto ptr = detail::SpineDataPtr(
-            new detail::SpineData(skeletonData, attachmentLoader),
-            detail::getSkeletonDataDeleter());
-        assert(ptr);
+    }
+    if (skeletonData == nullptr) {
+        spAttachmentLoader_dispose(attachmentLoader);
+        return nullptr;
+    }
+    return std::make_shared<detail::SpineData>(skeletonData, attachmentLoader,
+                                               content.size());
+}
 
-        spSkeletonJson_dispose(json);
+Self::Entry* Self::findEntry(const Key& key,
+                             std::unique_lock<std::mutex>& lock,
+                             std::optional<Task>& task) {
+    assert(lock.owns_lock());
+    auto iter = entries_.find(key);
+    if (iter != entries_.cend()) {
+        ++stats_.hits;
+        return &iter->second;
+    }
+    ++stats_.misses;
 
-        iter = cachedSkeletonData_
-                   .emplace(std::piecewise_construct,
-                            std::forward_as_tuple(dataFile, scale),
-                            std::forward_as_tuple(std::move(ptr)))
-                   .first;
+    // Textures can only be created on the cocos2d thread.
+    auto atlas = getAtlas(key.atlasFile);
+    if (not atlas) {
+        return nullptr;
     }
-    return iter->second->data;
+    auto fullPath =
+        (key.dataFile == NullDataFile
+             ? std::string()
+             : cocos2d::FileUtils::getInstance()->fullPathForFilename(
+                   key.dataFile));
+    auto cacheDirectory = cacheDirectory_;
+
+    // Entries are not evicted until their data is ready, the entry keeps the
+    // atlas alive while the task uses it.
+    auto rawAtlas = atlas.get();
+    task.emplace();
+    task->load = [key, fullPath, cacheDirectory, rawAtlas] {
+        return loadSkeletonData(key.dataFile, fullPath, cacheDirectory,
+                                rawAtlas, key.scale);
+    };
+
+    Entry entry;
+    entry.atlas = atlas;
+    entry.data = task->promise.get_future().share();
+    entry.referenceCount = 0;
+    entry.lastUse = ++useCounter_;
+    return &entries_.emplace(key, std::move(entry)).first->second;
+}
+
+Self::SkeletonDataPtr Self::getSkeletonData(const std::string& dataFile,
+                                            const std::string& atlasFile,
+                                            float scale) {
+    Key key{dataFile, atlasFile, scale};
+    std::optional<Task> task;
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto entry = findEntry(key, lock, task);
+    if (entry == nullptr) {
+        return nullptr;
+    }
+    ++entry->referenceCount;
+    auto future = entry->data;
+
+    // Load or wait for the preload without blocking the other requests, which
+    // wait for the pending entry instead of loading it again.
+    lock.unlock();
+    if (task) {
+        task->promise.set_value(task->load());
+    }
+    auto data = future.get();
+    if (not data) {
+        release(key);
+        return nullptr;
+    }
+
+    lock.lock();
+    trim(budget_);
+    lock.unlock();
+    return SkeletonDataPtr(data->data,
+                           [this, key](spSkeletonData*) { release(key); });
 }
 
-spSkeletonData* Self::getNullSkeletonData() {
+Self::SkeletonDataPtr Self::getNullSkeletonData() {
     return getSkeletonData(NullDataFile, NullAtlasFile, 1.0f);
 }
+
+void Self::preloadSkeletonData(const std::string& dataFile,
+                               const std::string& atlasFile, float scale) {
+    std::optional<Task> task;
+    std::unique_lock<std::mutex> lock(mutex_);
+    findEntry(Key{dataFile, atlasFile, scale}, lock, task);
+    if (not task) {
+        return;
+    }
+    tasks_.push_back(std::move(*task));
+    if (not worker_.joinable()) {
+        worker_ = std::thread(&Self::runWorker, this);
+    }
+    taskCondition_.notify_one();
+}
+
+void Self::release(const Key& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = entries_.find(key);
+    assert(iter != entries_.cend());
+    auto&& entry = iter->second;
+    assert(entry.referenceCount > 0);
+    if (--entry.referenceCount > 0) {
+        return;
+    }
+    if (isReady(entry.data) && not entry.data.get()) {
+        // Failed preload, retry on the next request.
+        entries_.erase(iter);
+        return;
+    }
+    entry.lastUse = ++useCounter_;
+    trim(budget_);
+}
+
+void Self::setBudget(std::size_t bytes) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    budget_ = bytes;
+    trim(budget_);
+}
+
+std::size_t Self::getBudget() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return budget_;
+}
+
+void Self::purge() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    trim(0);
+}
+
+void Self::setCacheDirectory(const std::string& directory) {
+    if (not directory.empty()) {
+        cocos2d::FileUtils::getInstance()->createDirectory(directory);
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    cacheDirectory_ = directory;
+}
+
+std::string Self::getCacheDirectory() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return cacheDirectory_;
+}
+
+void Self::trim(std::size_t budget) {
+    while (true) {
+        std::size_t bytes = 0;
+        auto victim = entries_.end();
+        for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
+            auto&& entry = iter->second;
+            if (not isReady(entry.data)) {
+                // Being loaded by the worker, which uses its atlas.
+                continue;
+            }
+            auto&& data = entry.data.get();
+            bytes += data ? data->size : 0;
+            if (entry.referenceCount == 0 &&
+                (victim == entries_.end() ||
+                 entry.lastUse < victim->second.lastUse)) {
+                victim = iter;
+            }
+        }
+        for (auto&& elt : atlases_) {
+            auto atlas = elt.second.lock();
+            bytes += atlas ? getAtlasSize(*atlas) : 0;
+        }
+        if (bytes <= budget || victim == entries_.end()) {
+            break;
+        }
+        entries_.erase(victim);
+        ++stats_.evictions;
+    }
+    for (auto iter = atlases_.begin(); iter != atlases_.end();) {
+        if (iter->second.expired()) {
+            iter = atlases_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+Self::Stats Self::getStats() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto stats = stats_;
+    stats.entries = entries_.size();
+    stats.referencedEntries = 0;
+    stats.bytes = 0;
+    for (auto&& elt : entries_) {
+        auto&& entry = elt.second;
+        if (entry.referenceCount > 0) {
+            ++stats.referencedEntries;
+        }
+        if (isReady(entry.data) && entry.data.get()) {
+            stats.bytes += entry.data.get()->size;
+        }
+    }
+    for (auto&& elt : atlases_) {
+        auto atlas = elt.second.lock();
+        stats.bytes += atlas ? getAtlasSize(*atlas) : 0;
+    }
+    return stats;
+}
+
+void Self::runWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        taskCondition_.wait(lock,
+                            [this] { return stopping_ || not tasks_.empty(); });
+        if (stopping_) {
+            break;
+        }
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task.promise.set_value(task.load());
+        lock.lock();
+    }
+}
 } // namespace ee
@@ -1,10 +1,18 @@
 #ifndef EE_PARSER_SKELETON_ANIMATION_MANAGER_HPP
 #define EE_PARSER_SKELETON_ANIMATION_MANAGER_HPP
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+
+#include "optional.hpp"
 
 struct spAtlas;
 struct spSkeletonData;
@@ -12,29 +20,75 @@ struct spSkeletonData;
 namespace ee {
 namespace detail {
 struct SpineData;
-
-using SpineAtlasDeleter = std::function<void(spAtlas* atlas)>;
-using SpineAtlasPtr = std::unique_ptr<spAtlas, SpineAtlasDeleter>;
-using SpineDataDeleter = std::function<void(SpineData* data)>;
-using SpineDataPtr = std::unique_ptr<SpineData, SpineDataDeleter>;
 } // namespace detail
 
+/// Thread-safe, reference-counted cache of spine atlases and skeleton data.
+/// Unreferenced skeleton data stays cached until the memory budget is
+/// exceeded, then the least recently used entries are evicted.
 class SkeletonAnimationManager {
 private:
     using Self = SkeletonAnimationManager;
 
 public:
+    /// Keeps the skeleton data alive, the data must not be used after the
+    /// last reference is released.
+    using SkeletonDataPtr = std::shared_ptr<spSkeletonData>;
+
+    struct Stats {
+        /// Number of requests served from the cache, preloads included.
+        std::size_t hits;
+
+        /// Number of requests that had to load the skeleton data.
+        std::size_t misses;
+
+        /// Number of evicted entries.
+        std::size_t evictions;
+
+        /// Number of cached entries.
+        std::size_t entries;
+
+        /// Number of cached entries currently referenced.
+        std::size_t referencedEntries;
+
+        /// Approximate number of bytes used by the cached entries.
+        std::size_t bytes;
+    };
+
     static const std::string NullAtlasFile;
     static const std::string NullDataFile;
 
     static Self& getInstance();
 
-    spAtlas* getAtlas(const std::string& atlasFile);
-
-    spSkeletonData* getSkeletonData(const std::string& dataFile,
+    /// Gets the skeleton data for the specified files, loads it
+    /// synchronously if it is neither cached nor being preloaded.
+    /// Must be called from the cocos2d thread.
+    /// @return nullptr if the files could not be loaded.
+    SkeletonDataPtr getSkeletonData(const std::string& dataFile,
                                     const std::string& atlasFile, float scale);
 
-    spSkeletonData* getNullSkeletonData();
+    SkeletonDataPtr getNullSkeletonData();
+
+    /// Loads the atlas on the calling thread, then parses the skeleton data
+    /// on a worker thread. Later requests for the same files wait for the
+    /// result instead of loading it again.
+    /// Must be called from the cocos2d thread.
+    void preloadSkeletonData(const std::string& dataFile,
+                             const std::string& atlasFile, float scale);
+
+    /// Sets the memory budget of the cache in bytes.
+    void setBudget(std::size_t bytes);
+    std::size_t getBudget() const;
+
+    /// Evicts all unreferenced entries.
+    void purge();
+
+    /// Sets the directory where JSON skeletons converted to the binary format
+    /// are cached, the directory is created if needed. Empty to disable the
+    /// cache, which is the default.
+    void setCacheDirectory(const std::string& directory);
+    std::string getCacheDirectory() const;
+
+    Stats getStats() const;
 
 protected:
     SkeletonAnimationManager();
@@ -44,10 +98,77 @@ protected:
     Self& operator=(const Self&) = delete;
 
 private:
-    std::map<std::string, detail::SpineAtlasPtr> cachedAtlas_;
+    using AtlasPtr = std::shared_ptr<spAtlas>;
+    using SpineDataPtr = std::shared_ptr<detail::SpineData>;
+
+    struct Key {
+        std::string dataFile;
+        std::string atlasFile;
+        float scale;
+
+        bool operator<(const Key& other) const;
+    };
+
+    struct Entry {
+        /// Kept alive as long as the skeleton data.
+        AtlasPtr atlas;
+
+        /// Ready when the skeleton data has been loaded.
+        std::shared_future<SpineDataPtr> data;
+
+        std::size_t referenceCount;
+
+        /// Value of the use counter when the entry was last released.
+        std::size_t lastUse;
+    };
+
+    /// Gets or loads the atlas, must be called from the cocos2d thread.
+    AtlasPtr getAtlas(const std::string& atlasFile);
+
+    /// Loads the skeleton data, may be called from any thread.
+    /// .skel files are read with the binary reader, JSON files are read
+    /// through the binary cache when a cache directory is given.
+    /// @param atlas Kept alive by the entry being loaded, the worker never
+    /// owns it so that atlas textures are only released on the cocos2d
+    /// thread.
+    static SpineDataPtr loadSkeletonData(const std::string& dataFile,
+                                         const std::string& fullPath,
+                                         const std::string& cacheDirectory,
+                                         spAtlas* atlas, float scale);
+
+    /// Loads the skeleton data of a pending entry.
+    struct Task {
+        std::promise<SpineDataPtr> promise;
+        std::function<SpineDataPtr()> load;
+    };
+
+    /// Finds or creates the entry for the specified key, a created entry is
+    /// pending until its task is run. Tasks may be run without the mutex.
+    /// Must be called with the mutex held.
+    /// @param task Set if the entry was created.
+    Entry* findEntry(const Key& key, std::unique_lock<std::mutex>& lock,
+                     std::optional<Task>& task);
+
+    void release(const Key& key);
+
+    /// Evicts entries until the budget is met, must be called with the mutex
+    /// held.
+    void trim(std::size_t budget);
+
+    void runWorker();
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<spAtlas>> atlases_;
+    std::map<Key, Entry> entries_;
+    std::size_t budget_;
+    std::size_t useCounter_;
+    std::string cacheDirectory_;
+    Stats stats_;
 
-    std::map<std::pair<std::string, float>, detail::SpineDataPtr>
-        cachedSkeletonData_;
+    std::thread worker_;
+    std::condition_variable taskCondition_;
+    std::deque<Task> tasks_;
+    bool stopping_;
 };
 } // namespace ee
 
@@ -0,0 +1,193 @@
+#include <atomic>
+#include <ciso646>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "skeletonbinarycache.hpp"
+
+#include <xxhash/xxhash.h>
+
+namespace ee {
+using Self = SkeletonBinaryCache;
+using Result = SkeletonBinaryWriter::Result;
+
+namespace {
+constexpr std::uint32_t magic = 0x4B534545; // EESK
+constexpr std::uint32_t version = 1;
+
+struct Header {
+    std::uint32_t sourceSize;
+    std::uint32_t sourceHash;
+    std::string sourcePath;
+};
+
+std::uint32_t computeHash(const std::string& data) {
+    return XXH32(data.data(), static_cast<int>(data.size()), 0);
+}
+
+std::string getCachePath(const std::string& directory,
+                         const std::string& fullPath) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08x.skelcache",
+                  computeHash(fullPath));
+    if (not directory.empty() && directory.back() != '/') {
+        return directory + '/' + name;
+    }
+    return directory + name;
+}
+
+void writeInt(std::string& output, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        output.push_back(static_cast<char>(value >> (i * 8)));
+    }
+}
+
+void writeString(std::string& output, const std::string& value) {
+    writeInt(output, static_cast<std::uint32_t>(value.size()));
+    output += value;
+}
+
+class Input {
+public:
+    explicit Input(const std::string& data)
+        : data_(data)
+        , position_(0) {}
+
+    bool readInt(std::uint32_t& value) {
+        if (data_.size() - position_ < 4) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            auto byte = static_cast<std::uint8_t>(data_[position_++]);
+            value |= static_cast<std::uint32_t>(byte) << (i * 8);
+        }
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        std::uint32_t size;
+        if (not readInt(size) || data_.size() - position_ < size) {
+            return false;
+        }
+        value.assign(data_, position_, size);
+        position_ += size;
+        return true;
+    }
+
+private:
+    const std::string& data_;
+    std::size_t position_;
+};
+
+bool readFile(const std::string& path, std::string& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (not file) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+    return not file.bad();
+}
+
+std::optional<Result> readEntry(const std::string& path,
+                                const Header& header) {
+    std::string data;
+    if (not readFile(path, data)) {
+        return std::nullopt;
+    }
+    Input input(data);
+    std::uint32_t entryMagic, entryVersion;
+    Header entryHeader;
+    if (not input.readInt(entryMagic) || entryMagic != magic ||
+        not input.readInt(entryVersion) || entryVersion != version ||
+        not input.readInt(entryHeader.sourceSize) ||
+        not input.readInt(entryHeader.sourceHash) ||
+        not input.readString(entryHeader.sourcePath)) {
+        return std::nullopt;
+    }
+    // Also guards against collisions of the path hash.
+    if (entryHeader.sourceSize != header.sourceSize ||
+        entryHeader.sourceHash != header.sourceHash ||
+        entryHeader.sourcePath != header.sourcePath) {
+        return std::nullopt;
+    }
+    Result result;
+    std::uint32_t regionCount;
+    if (not input.readInt(regionCount)) {
+        return std::nullopt;
+    }
+    result.regions.resize(regionCount);
+    for (auto&& region : result.regions) {
+        if (not input.readString(region)) {
+            return std::nullopt;
+        }
+    }
+    if (not input.readString(result.data)) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+bool writeEntry(const std::string& path, const Header& header,
+                const Result& result) {
+    std::string data;
+    writeInt(data, magic);
+    writeInt(data, version);
+    writeInt(data, header.sourceSize);
+    writeInt(data, header.sourceHash);
+    writeString(data, header.sourcePath);
+    writeInt(data, static_cast<std::uint32_t>(result.regions.size()));
+    for (auto&& region : result.regions) {
+        writeString(data, region);
+    }
+    writeString(data, result.data);
+
+    // Written to a unique temporary file first, so that concurrent loads of
+    // the same skeleton never read a partially written entry.
+    static std::atomic<unsigned> counter(0);
+    auto temporaryPath = path + "." + std::to_string(counter++) + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (not file.write(data.data(),
+                           static_cast<std::streamsize>(data.size()))) {
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        // Windows does not replace existing files.
+        std::remove(path.c_str());
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+std::optional<Result> Self::get(const std::string& directory,
+                                const std::string& fullPath,
+                                const std::string& json) {
+    Header header;
+    header.sourceSize = static_cast<std::uint32_t>(json.size());
+    header.sourceHash = computeHash(json);
+    header.sourcePath = fullPath;
+
+    auto path = getCachePath(directory, fullPath);
+    auto result = readEntry(path, header);
+    if (result) {
+        return result;
+    }
+    result = SkeletonBinaryWriter::convert(json);
+    if (result) {
+        // Failing to write only costs a conversion on the next load.
+        writeEntry(path, header, result.value());
+    }
+    return result;
+}
+} // namespace ee
@@ -0,0 +1,30 @@
+#ifndef EE_PARSER_SKELETON_BINARY_CACHE_HPP
+#define EE_PARSER_SKELETON_BINARY_CACHE_HPP
+
+#include <string>
+
+#include "optional.hpp"
+#include "skeletonbinarywriter.hpp"
+
+namespace ee {
+/// Stores spine JSON skeletons converted to the binary format on disk.
+/// Entries are keyed by the path of the JSON file and invalidated when its
+/// size or hash changes.
+class SkeletonBinaryCache final {
+private:
+    using Self = SkeletonBinaryCache;
+
+public:
+    /// Gets the binary skeleton for a JSON skeleton, converts and stores it
+    /// if it is not cached yet or outdated. May be called from any thread.
+    /// @param directory The cache directory, must exist.
+    /// @param fullPath The full path of the JSON file.
+    /// @param json The content of the JSON file.
+    /// @return std::nullopt if the JSON can not be converted.
+    static std::optional<SkeletonBinaryWriter::Result>
+    get(const std::string& directory, const std::string& fullPath,
+        const std::string& json);
+};
+} // namespace ee
+
+#endif // EE_PARSER_SKELETON_BINARY_CACHE_HPP
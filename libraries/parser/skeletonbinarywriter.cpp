@@ -0,0 +1,1000 @@
+#include <ciso646>
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "skeletonbinarywriter.hpp"
+
+#include <spine/Json.h>
+
+namespace ee {
+using Self = SkeletonBinaryWriter;
+
+namespace {
+/// Constants of spine/SkeletonBinary.c.
+namespace binary {
+constexpr std::uint8_t attachment_region = 0;
+constexpr std::uint8_t attachment_bounding_box = 1;
+constexpr std::uint8_t attachment_mesh = 2;
+constexpr std::uint8_t attachment_linked_mesh = 3;
+constexpr std::uint8_t attachment_path = 4;
+
+constexpr std::uint8_t curve_linear = 0;
+constexpr std::uint8_t curve_stepped = 1;
+constexpr std::uint8_t curve_bezier = 2;
+
+constexpr std::uint8_t bone_rotate = 0;
+constexpr std::uint8_t bone_translate = 1;
+constexpr std::uint8_t bone_scale = 2;
+constexpr std::uint8_t bone_shear = 3;
+
+constexpr std::uint8_t slot_attachment = 0;
+constexpr std::uint8_t slot_color = 1;
+
+constexpr std::uint8_t path_position = 0;
+constexpr std::uint8_t path_spacing = 1;
+constexpr std::uint8_t path_mix = 2;
+} // namespace binary
+
+/// Mirrors the readers of spine/SkeletonBinary.c.
+class Output {
+public:
+    void writeByte(std::uint8_t value) {
+        buffer_.push_back(static_cast<char>(value));
+    }
+
+    void writeSByte(std::int8_t value) {
+        writeByte(static_cast<std::uint8_t>(value));
+    }
+
+    void writeBoolean(bool value) { writeByte(value ? 1 : 0); }
+
+    void writeInt(std::uint32_t value) {
+        writeByte(static_cast<std::uint8_t>(value >> 24));
+        writeByte(static_cast<std::uint8_t>(value >> 16));
+        writeByte(static_cast<std::uint8_t>(value >> 8));
+        writeByte(static_cast<std::uint8_t>(value));
+    }
+
+    void writeVarint(int value, bool optimizePositive = true) {
+        auto bits = static_cast<std::uint32_t>(value);
+        if (not optimizePositive) {
+            // Zig-zag encoding.
+            bits = (bits << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0u);
+        }
+        while (bits >= 0x80) {
+            writeByte(static_cast<std::uint8_t>((bits & 0x7F) | 0x80));
+            bits >>= 7;
+        }
+        writeByte(static_cast<std::uint8_t>(bits));
+    }
+
+    void writeFloat(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeInt(bits);
+    }
+
+    /// Null strings are read back as null.
+    void writeString(const char* value) {
+        if (value == nullptr) {
+            writeVarint(0);
+            return;
+        }
+        auto length = std::strlen(value);
+        writeVarint(static_cast<int>(length + 1));
+        buffer_.append(value, length);
+    }
+
+    void append(const Output& other) { buffer_ += other.buffer_; }
+
+    std::string& getBuffer() { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+using IndexMap = std::unordered_map<std::string, int>;
+
+int findIndex(const IndexMap& indices, const char* name) {
+    if (name == nullptr) {
+        return -1;
+    }
+    auto iter = indices.find(name);
+    if (iter == indices.cend()) {
+        return -1;
+    }
+    return iter->second;
+}
+
+void addIndex(IndexMap& indices, const char* name, int index) {
+    // Keeps the first index, spine looks up names linearly.
+    indices.emplace(name, index);
+}
+
+/// Parses a RRGGBBAA color the way spSkeletonJson does.
+bool writeColor(Output& output, const char* value) {
+    if (value == nullptr) {
+        output.writeInt(0xFFFFFFFF);
+        return true;
+    }
+    if (std::strlen(value) != 8) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        char digits[3] = {value[i * 2], value[i * 2 + 1], '\0'};
+        char* error;
+        auto component = std::strtoul(digits, &error, 16);
+        if (*error != '\0') {
+            return false;
+        }
+        output.writeByte(static_cast<std::uint8_t>(component));
+    }
+    return true;
+}
+
+bool writeCurve(Output& output, Json* frame) {
+    auto curve = Json_getItem(frame, "curve");
+    if (curve != nullptr && curve->type == Json_String &&
+        std::strcmp(curve->valueString, "stepped") == 0) {
+        output.writeByte(binary::curve_stepped);
+    } else if (curve != nullptr && curve->type == Json_Array) {
+        if (curve->size < 4) {
+            return false;
+        }
+        output.writeByte(binary::curve_bezier);
+        auto item = curve->child;
+        for (int i = 0; i < 4; ++i, item = item->next) {
+            output.writeFloat(item->valueFloat);
+        }
+    } else {
+        output.writeByte(binary::curve_linear);
+    }
+    return true;
+}
+
+class Converter {
+public:
+    bool convert(Json* root, Self::Result& result) {
+        if (not writeHeader(root) || not writeBones(root) ||
+            not writeSlots(root) || not writeIkConstraints(root) ||
+            not writeTransformConstraints(root) ||
+            not writePathConstraints(root) || not writeSkins(root) ||
+            not writeEvents(root) || not writeAnimations(root)) {
+            return false;
+        }
+        result.data = std::move(output_.getBuffer());
+        result.regions = std::move(regions_);
+        return true;
+    }
+
+private:
+    bool writeHeader(Json* root) {
+        auto skeleton = Json_getItem(root, "skeleton");
+        const char* hash = nullptr;
+        const char* version = nullptr;
+        const char* images = nullptr;
+        float width = 0;
+        float height = 0;
+        float fps = 0;
+        if (skeleton != nullptr) {
+            hash = Json_getString(skeleton, "hash", nullptr);
+            version = Json_getString(skeleton, "spine", nullptr);
+            images = Json_getString(skeleton, "images", nullptr);
+            width = Json_getFloat(skeleton, "width", 0);
+            height = Json_getFloat(skeleton, "height", 0);
+            fps = Json_getFloat(skeleton, "fps", 0);
+        }
+        // Empty strings are read back as null.
+        output_.writeString(hash == nullptr ? "" : hash);
+        output_.writeString(version == nullptr ? "" : version);
+        output_.writeFloat(width);
+        output_.writeFloat(height);
+
+        // Nonessential data is kept so that mesh sizes match spSkeletonJson.
+        output_.writeBoolean(true);
+        output_.writeFloat(fps);
+        output_.writeString(images);
+        return true;
+    }
+
+    bool writeBoneIndices(Json* constraint) {
+        auto bones = Json_getItem(constraint, "bones");
+        if (bones == nullptr) {
+            return false;
+        }
+        output_.writeVarint(bones->size);
+        for (auto bone = bones->child; bone != nullptr; bone = bone->next) {
+            auto index = findIndex(bones_, bone->valueString);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+        }
+        return true;
+    }
+
+    bool writeBones(Json* root) {
+        auto bones = Json_getItem(root, "bones");
+        if (bones == nullptr) {
+            return false;
+        }
+        output_.writeVarint(bones->size);
+        int index = 0;
+        for (auto bone = bones->child; bone != nullptr;
+             bone = bone->next, ++index) {
+            auto name = Json_getString(bone, "name", nullptr);
+            if (name == nullptr) {
+                return false;
+            }
+            output_.writeString(name);
+
+            // The binary format only allows the first bone to be a root.
+            auto parent =
+                findIndex(bones_, Json_getString(bone, "parent", nullptr));
+            if ((index == 0) != (parent == -1)) {
+                return false;
+            }
+            if (index > 0) {
+                output_.writeVarint(parent);
+            }
+            addIndex(bones_, name, index);
+
+            output_.writeFloat(Json_getFloat(bone, "rotation", 0));
+            output_.writeFloat(Json_getFloat(bone, "x", 0));
+            output_.writeFloat(Json_getFloat(bone, "y", 0));
+            output_.writeFloat(Json_getFloat(bone, "scaleX", 1));
+            output_.writeFloat(Json_getFloat(bone, "scaleY", 1));
+            output_.writeFloat(Json_getFloat(bone, "shearX", 0));
+            output_.writeFloat(Json_getFloat(bone, "shearY", 0));
+            output_.writeFloat(Json_getFloat(bone, "length", 0));
+
+            auto mode = Json_getString(bone, "transform", "normal");
+            int transformMode = 0;
+            if (std::strcmp(mode, "onlyTranslation") == 0) {
+                transformMode = 1;
+            } else if (std::strcmp(mode, "noRotationOrReflection") == 0) {
+                transformMode = 2;
+            } else if (std::strcmp(mode, "noScale") == 0) {
+                transformMode = 3;
+            } else if (std::strcmp(mode, "noScaleOrReflection") == 0) {
+                transformMode = 4;
+            }
+            output_.writeVarint(transformMode);
+            output_.writeInt(0); // Bone color.
+        }
+        return true;
+    }
+
+    bool writeSlots(Json* root) {
+        auto slots = Json_getItem(root, "slots");
+        if (slots == nullptr) {
+            output_.writeVarint(0);
+            return true;
+        }
+        output_.writeVarint(slots->size);
+        int index = 0;
+        for (auto slot = slots->child; slot != nullptr;
+             slot = slot->next, ++index) {
+            auto name = Json_getString(slot, "name", nullptr);
+            auto bone =
+                findIndex(bones_, Json_getString(slot, "bone", nullptr));
+            if (name == nullptr || bone == -1) {
+                return false;
+            }
+            output_.writeString(name);
+            output_.writeVarint(bone);
+            addIndex(slots_, name, index);
+            if (not writeColor(output_,
+                               Json_getString(slot, "color", nullptr))) {
+                return false;
+            }
+            auto attachment = Json_getItem(slot, "attachment");
+            output_.writeString(attachment == nullptr ? nullptr
+                                                      : attachment->valueString);
+            auto blend = Json_getString(slot, "blend", "normal");
+            int blendMode = 0;
+            if (std::strcmp(blend, "additive") == 0) {
+                blendMode = 1;
+            } else if (std::strcmp(blend, "multiply") == 0) {
+                blendMode = 2;
+            } else if (std::strcmp(blend, "screen") == 0) {
+                blendMode = 3;
+            }
+            output_.writeVarint(blendMode);
+        }
+        return true;
+    }
+
+    bool writeIkConstraints(Json* root) {
+        auto constraints = Json_getItem(root, "ik");
+        output_.writeVarint(constraints == nullptr ? 0 : constraints->size);
+        int index = 0;
+        for (auto constraint = constraints == nullptr ? nullptr
+                                                      : constraints->child;
+             constraint != nullptr; constraint = constraint->next, ++index) {
+            auto name = Json_getString(constraint, "name", nullptr);
+            auto target =
+                findIndex(bones_, Json_getString(constraint, "target", nullptr));
+            if (name == nullptr || target == -1) {
+                return false;
+            }
+            output_.writeString(name);
+            output_.writeVarint(Json_getInt(constraint, "order", 0));
+            addIndex(ikConstraints_, name, index);
+            if (not writeBoneIndices(constraint)) {
+                return false;
+            }
+            output_.writeVarint(target);
+            output_.writeFloat(Json_getFloat(constraint, "mix", 1));
+            output_.writeSByte(
+                Json_getInt(constraint, "bendPositive", 1) ? 1 : -1);
+        }
+        return true;
+    }
+
+    bool writeTransformConstraints(Json* root) {
+        auto constraints = Json_getItem(root, "transform");
+        output_.writeVarint(constraints == nullptr ? 0 : constraints->size);
+        int index = 0;
+        for (auto constraint = constraints == nullptr ? nullptr
+                                                      : constraints->child;
+             constraint != nullptr; constraint = constraint->next, ++index) {
+            auto name = Json_getString(constraint, "name", nullptr);
+            auto target =
+                findIndex(bones_, Json_getString(constraint, "target", nullptr));
+            if (name == nullptr || target == -1) {
+                return false;
+            }
+            output_.writeString(name);
+            output_.writeVarint(Json_getInt(constraint, "order", 0));
+            addIndex(transformConstraints_, name, index);
+            if (not writeBoneIndices(constraint)) {
+                return false;
+            }
+            output_.writeVarint(target);
+            output_.writeFloat(Json_getFloat(constraint, "rotation", 0));
+            output_.writeFloat(Json_getFloat(constraint, "x", 0));
+            output_.writeFloat(Json_getFloat(constraint, "y", 0));
+            output_.writeFloat(Json_getFloat(constraint, "scaleX", 0));
+            output_.writeFloat(Json_getFloat(constraint, "scaleY", 0));
+            output_.writeFloat(Json_getFloat(constraint, "shearY", 0));
+            output_.writeFloat(Json_getFloat(constraint, "rotateMix", 1));
+            output_.writeFloat(Json_getFloat(constraint, "translateMix", 1));
+            output_.writeFloat(Json_getFloat(constraint, "scaleMix", 1));
+            output_.writeFloat(Json_getFloat(constraint, "shearMix", 1));
+        }
+        return true;
+    }
+
+    bool writePathConstraints(Json* root) {
+        auto constraints = Json_getItem(root, "path");
+        output_.writeVarint(constraints == nullptr ? 0 : constraints->size);
+        int index = 0;
+        for (auto constraint = constraints == nullptr ? nullptr
+                                                      : constraints->child;
+             constraint != nullptr; constraint = constraint->next, ++index) {
+            auto name = Json_getString(constraint, "name", nullptr);
+            auto target =
+                findIndex(slots_, Json_getString(constraint, "target", nullptr));
+            if (name == nullptr || target == -1) {
+                return false;
+            }
+            output_.writeString(name);
+            output_.writeVarint(Json_getInt(constraint, "order", 0));
+            addIndex(pathConstraints_, name, index);
+            if (not writeBoneIndices(constraint)) {
+                return false;
+            }
+            output_.writeVarint(target);
+
+            // Unknown modes keep the zero-initialized value, as in spine.
+            auto item = Json_getString(constraint, "positionMode", "percent");
+            int positionMode = 0;
+            if (std::strcmp(item, "percent") == 0) {
+                positionMode = 1;
+            }
+            item = Json_getString(constraint, "spacingMode", "length");
+            int spacingMode = 0;
+            if (std::strcmp(item, "fixed") == 0) {
+                spacingMode = 1;
+            } else if (std::strcmp(item, "percent") == 0) {
+                spacingMode = 2;
+            }
+            item = Json_getString(constraint, "rotateMode", "tangent");
+            int rotateMode = 0;
+            if (std::strcmp(item, "chain") == 0) {
+                rotateMode = 1;
+            } else if (std::strcmp(item, "chainScale") == 0) {
+                rotateMode = 2;
+            }
+            output_.writeVarint(positionMode);
+            output_.writeVarint(spacingMode);
+            output_.writeVarint(rotateMode);
+            output_.writeFloat(Json_getFloat(constraint, "rotation", 0));
+            output_.writeFloat(Json_getFloat(constraint, "position", 0));
+            output_.writeFloat(Json_getFloat(constraint, "spacing", 0));
+            output_.writeFloat(Json_getFloat(constraint, "rotateMix", 1));
+            output_.writeFloat(Json_getFloat(constraint, "translateMix", 1));
+        }
+        return true;
+    }
+
+    /// Mirrors _readVertices of spSkeletonJson.
+    bool writeVertices(Json* attachment, int verticesLength) {
+        auto vertices = Json_getItem(attachment, "vertices");
+        if (vertices == nullptr) {
+            return false;
+        }
+        if (vertices->size == verticesLength) {
+            output_.writeBoolean(false);
+            for (auto item = vertices->child; item != nullptr;
+                 item = item->next) {
+                output_.writeFloat(item->valueFloat);
+            }
+            return true;
+        }
+        output_.writeBoolean(true);
+        auto item = vertices->child;
+        for (int i = 0; i < verticesLength / 2; ++i) {
+            if (item == nullptr) {
+                return false;
+            }
+            auto boneCount = static_cast<int>(item->valueFloat);
+            output_.writeVarint(boneCount);
+            item = item->next;
+            for (int j = 0; j < boneCount; ++j) {
+                if (item == nullptr || item->next == nullptr ||
+                    item->next->next == nullptr ||
+                    item->next->next->next == nullptr) {
+                    return false;
+                }
+                output_.writeVarint(static_cast<int>(item->valueFloat));
+                item = item->next;
+                for (int k = 0; k < 3; ++k, item = item->next) {
+                    output_.writeFloat(item->valueFloat);
+                }
+            }
+        }
+        return item == nullptr;
+    }
+
+    bool writeAttachment(Json* attachment) {
+        auto name = Json_getString(attachment, "name", nullptr);
+        auto path = Json_getString(attachment, "path", nullptr);
+        auto regionPath = path != nullptr
+                              ? path
+                              : name != nullptr ? name : attachment->name;
+        auto type = Json_getString(attachment, "type", "region");
+        output_.writeString(name);
+
+        if (std::strcmp(type, "region") == 0) {
+            regions_.emplace_back(regionPath);
+            output_.writeByte(binary::attachment_region);
+            output_.writeString(path);
+            output_.writeFloat(Json_getFloat(attachment, "rotation", 0));
+            output_.writeFloat(Json_getFloat(attachment, "x", 0));
+            output_.writeFloat(Json_getFloat(attachment, "y", 0));
+            output_.writeFloat(Json_getFloat(attachment, "scaleX", 1));
+            output_.writeFloat(Json_getFloat(attachment, "scaleY", 1));
+            output_.writeFloat(Json_getFloat(attachment, "width", 32));
+            output_.writeFloat(Json_getFloat(attachment, "height", 32));
+            return writeColor(output_,
+                              Json_getString(attachment, "color", nullptr));
+        }
+
+        if (std::strcmp(type, "mesh") == 0 ||
+            std::strcmp(type, "linkedmesh") == 0) {
+            regions_.emplace_back(regionPath);
+            auto parent = Json_getItem(attachment, "parent");
+            if (parent != nullptr) {
+                output_.writeByte(binary::attachment_linked_mesh);
+                output_.writeString(path);
+                if (not writeColor(output_, Json_getString(attachment, "color",
+                                                           nullptr))) {
+                    return false;
+                }
+                output_.writeString(
+                    Json_getString(attachment, "skin", nullptr));
+                output_.writeString(parent->valueString);
+                output_.writeBoolean(Json_getInt(attachment, "deform", 1) != 0);
+                output_.writeFloat(Json_getFloat(attachment, "width", 32));
+                output_.writeFloat(Json_getFloat(attachment, "height", 32));
+                return true;
+            }
+
+            auto uvs = Json_getItem(attachment, "uvs");
+            auto triangles = Json_getItem(attachment, "triangles");
+            if (uvs == nullptr || triangles == nullptr || uvs->size % 2 != 0) {
+                return false;
+            }
+            output_.writeByte(binary::attachment_mesh);
+            output_.writeString(path);
+            if (not writeColor(output_,
+                               Json_getString(attachment, "color", nullptr))) {
+                return false;
+            }
+            output_.writeVarint(uvs->size / 2);
+            for (auto item = uvs->child; item != nullptr; item = item->next) {
+                output_.writeFloat(item->valueFloat);
+            }
+            output_.writeVarint(triangles->size);
+            for (auto item = triangles->child; item != nullptr;
+                 item = item->next) {
+                auto index = static_cast<unsigned short>(item->valueInt);
+                output_.writeByte(static_cast<std::uint8_t>(index >> 8));
+                output_.writeByte(static_cast<std::uint8_t>(index));
+            }
+            if (not writeVertices(attachment, uvs->size)) {
+                return false;
+            }
+            // Both formats store the number of hull vertices, spSkeletonBinary
+            // doubles it while spSkeletonJson does not. Nothing in the cocos2d
+            // runtime reads it.
+            output_.writeVarint(Json_getInt(attachment, "hull", 0));
+            // Edges are only used by the spine editor, and the binary reader
+            // stores them in an array of the wrong width.
+            output_.writeVarint(0);
+            output_.writeFloat(Json_getFloat(attachment, "width", 32));
+            output_.writeFloat(Json_getFloat(attachment, "height", 32));
+            return true;
+        }
+
+        if (std::strcmp(type, "boundingbox") == 0) {
+            auto vertexCount = Json_getInt(attachment, "vertexCount", 0);
+            output_.writeByte(binary::attachment_bounding_box);
+            output_.writeVarint(vertexCount);
+            if (not writeVertices(attachment, vertexCount << 1)) {
+                return false;
+            }
+            output_.writeInt(0); // Color.
+            return true;
+        }
+
+        if (std::strcmp(type, "path") == 0) {
+            auto vertexCount = Json_getInt(attachment, "vertexCount", 0);
+            auto lengths = Json_getItem(attachment, "lengths");
+            if (lengths == nullptr || lengths->size != vertexCount / 3) {
+                return false;
+            }
+            output_.writeByte(binary::attachment_path);
+            output_.writeBoolean(Json_getInt(attachment, "closed", 0) != 0);
+            output_.writeBoolean(
+                Json_getInt(attachment, "constantSpeed", 1) != 0);
+            output_.writeVarint(vertexCount);
+            if (not writeVertices(attachment, vertexCount << 1)) {
+                return false;
+            }
+            for (auto item = lengths->child; item != nullptr;
+                 item = item->next) {
+                output_.writeFloat(item->valueFloat);
+            }
+            output_.writeInt(0); // Color.
+            return true;
+        }
+        return false;
+    }
+
+    bool writeSkin(Json* skin) {
+        output_.writeVarint(skin == nullptr ? 0 : skin->size);
+        for (auto slot = skin == nullptr ? nullptr : skin->child;
+             slot != nullptr; slot = slot->next) {
+            auto index = findIndex(slots_, slot->name);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+            output_.writeVarint(slot->size);
+            for (auto attachment = slot->child; attachment != nullptr;
+                 attachment = attachment->next) {
+                output_.writeString(attachment->name);
+                if (not writeAttachment(attachment)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool writeSkins(Json* root) {
+        auto skins = Json_getItem(root, "skins");
+        Json* defaultSkin = nullptr;
+        int skinCount = 0;
+        for (auto skin = skins == nullptr ? nullptr : skins->child;
+             skin != nullptr; skin = skin->next) {
+            if (defaultSkin == nullptr && std::strcmp(skin->name, "default") == 0) {
+                defaultSkin = skin;
+            } else {
+                ++skinCount;
+            }
+        }
+
+        // The binary reader always stores the default skin first, and
+        // represents empty skins as null.
+        int index = 0;
+        if (defaultSkin != nullptr && defaultSkin->size > 0) {
+            addIndex(skins_, defaultSkin->name, index++);
+        }
+        if (not writeSkin(defaultSkin)) {
+            return false;
+        }
+        output_.writeVarint(skinCount);
+        for (auto skin = skins == nullptr ? nullptr : skins->child;
+             skin != nullptr; skin = skin->next) {
+            if (skin == defaultSkin) {
+                continue;
+            }
+            if (skin->size == 0) {
+                return false;
+            }
+            addIndex(skins_, skin->name, index++);
+            output_.writeString(skin->name);
+            if (not writeSkin(skin)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool writeEvents(Json* root) {
+        auto events = Json_getItem(root, "events");
+        output_.writeVarint(events == nullptr ? 0 : events->size);
+        int index = 0;
+        for (auto event = events == nullptr ? nullptr : events->child;
+             event != nullptr; event = event->next, ++index) {
+            addIndex(events_, event->name, index);
+            eventData_.push_back(event);
+            output_.writeString(event->name);
+            output_.writeVarint(Json_getInt(event, "int", 0), false);
+            output_.writeFloat(Json_getFloat(event, "float", 0));
+            output_.writeString(Json_getString(event, "string", nullptr));
+        }
+        return true;
+    }
+
+    bool writeAnimations(Json* root) {
+        auto animations = Json_getItem(root, "animations");
+        output_.writeVarint(animations == nullptr ? 0 : animations->size);
+        for (auto animation = animations == nullptr ? nullptr
+                                                    : animations->child;
+             animation != nullptr; animation = animation->next) {
+            output_.writeString(animation->name);
+            if (not writeAnimation(animation)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool writeSlotTimelines(Json* animation) {
+        auto slots = Json_getItem(animation, "slots");
+        output_.writeVarint(slots == nullptr ? 0 : slots->size);
+        for (auto slot = slots == nullptr ? nullptr : slots->child;
+             slot != nullptr; slot = slot->next) {
+            auto index = findIndex(slots_, slot->name);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+            output_.writeVarint(slot->size);
+            for (auto timeline = slot->child; timeline != nullptr;
+                 timeline = timeline->next) {
+                bool isColor = std::strcmp(timeline->name, "color") == 0;
+                if (not isColor &&
+                    std::strcmp(timeline->name, "attachment") != 0) {
+                    return false;
+                }
+                output_.writeByte(isColor ? binary::slot_color
+                                          : binary::slot_attachment);
+                output_.writeVarint(timeline->size);
+                for (auto frame = timeline->child; frame != nullptr;
+                     frame = frame->next) {
+                    output_.writeFloat(Json_getFloat(frame, "time", 0));
+                    if (isColor) {
+                        auto color = Json_getString(frame, "color", nullptr);
+                        if (color == nullptr ||
+                            not writeColor(output_, color)) {
+                            return false;
+                        }
+                        if (frame->next != nullptr &&
+                            not writeCurve(output_, frame)) {
+                            return false;
+                        }
+                    } else {
+                        auto name = Json_getItem(frame, "name");
+                        if (name == nullptr) {
+                            return false;
+                        }
+                        output_.writeString(
+                            name->type == Json_NULL ? nullptr
+                                                    : name->valueString);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool writeBoneTimelines(Json* animation) {
+        auto bones = Json_getItem(animation, "bones");
+        output_.writeVarint(bones == nullptr ? 0 : bones->size);
+        for (auto bone = bones == nullptr ? nullptr : bones->child;
+             bone != nullptr; bone = bone->next) {
+            auto index = findIndex(bones_, bone->name);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+            output_.writeVarint(bone->size);
+            for (auto timeline = bone->child; timeline != nullptr;
+                 timeline = timeline->next) {
+                bool isRotate = std::strcmp(timeline->name, "rotate") == 0;
+                if (isRotate) {
+                    output_.writeByte(binary::bone_rotate);
+                } else if (std::strcmp(timeline->name, "translate") == 0) {
+                    output_.writeByte(binary::bone_translate);
+                } else if (std::strcmp(timeline->name, "scale") == 0) {
+                    output_.writeByte(binary::bone_scale);
+                } else if (std::strcmp(timeline->name, "shear") == 0) {
+                    output_.writeByte(binary::bone_shear);
+                } else {
+                    return false;
+                }
+                output_.writeVarint(timeline->size);
+                for (auto frame = timeline->child; frame != nullptr;
+                     frame = frame->next) {
+                    output_.writeFloat(Json_getFloat(frame, "time", 0));
+                    if (isRotate) {
+                        output_.writeFloat(Json_getFloat(frame, "angle", 0));
+                    } else {
+                        output_.writeFloat(Json_getFloat(frame, "x", 0));
+                        output_.writeFloat(Json_getFloat(frame, "y", 0));
+                    }
+                    if (frame->next != nullptr &&
+                        not writeCurve(output_, frame)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool writeConstraintTimelines(Json* animation) {
+        auto ik = Json_getItem(animation, "ik");
+        output_.writeVarint(ik == nullptr ? 0 : ik->size);
+        for (auto constraint = ik == nullptr ? nullptr : ik->child;
+             constraint != nullptr; constraint = constraint->next) {
+            auto index = findIndex(ikConstraints_, constraint->name);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+            output_.writeVarint(constraint->size);
+            for (auto frame = constraint->child; frame != nullptr;
+                 frame = frame->next) {
+                output_.writeFloat(Json_getFloat(frame, "time", 0));
+                output_.writeFloat(Json_getFloat(frame, "mix", 1));
+                output_.writeSByte(
+                    Json_getInt(frame, "bendPositive", 1) ? 1 : -1);
+                if (frame->next != nullptr && not writeCurve(output_, frame)) {
+                    return false;
+                }
+            }
+        }
+
+        auto transform = Json_getItem(animation, "transform");
+        output_.writeVarint(transform == nullptr ? 0 : transform->size);
+        for (auto constraint = transform == nullptr ? nullptr
+                                                    : transform->child;
+             constraint != nullptr; constraint = constraint->next) {
+            auto index = findIndex(transformConstraints_, constraint->name);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+            output_.writeVarint(constraint->size);
+            for (auto frame = constraint->child; frame != nullptr;
+                 frame = frame->next) {
+                output_.writeFloat(Json_getFloat(frame, "time", 0));
+                output_.writeFloat(Json_getFloat(frame, "rotateMix", 1));
+                output_.writeFloat(Json_getFloat(frame, "translateMix", 1));
+                output_.writeFloat(Json_getFloat(frame, "scaleMix", 1));
+                output_.writeFloat(Json_getFloat(frame, "shearMix", 1));
+                if (frame->next != nullptr && not writeCurve(output_, frame)) {
+                    return false;
+                }
+            }
+        }
+
+        auto paths = Json_getItem(animation, "paths");
+        output_.writeVarint(paths == nullptr ? 0 : paths->size);
+        for (auto constraint = paths == nullptr ? nullptr : paths->child;
+             constraint != nullptr; constraint = constraint->next) {
+            auto index = findIndex(pathConstraints_, constraint->name);
+            if (index == -1) {
+                return false;
+            }
+            output_.writeVarint(index);
+            Output timelines;
+            int timelineCount = 0;
+            for (auto timeline = constraint->child; timeline != nullptr;
+                 timeline = timeline->next) {
+                auto name = timeline->name;
+                bool isMix = std::strcmp(name, "position") != 0 &&
+                             std::strcmp(name, "spacing") != 0;
+                if (std::strcmp(name, "mix") == 0) {
+                    // spSkeletonJson skips mix timelines.
+                    continue;
+                }
+                ++timelineCount;
+                timelines.writeByte(isMix ? binary::path_mix
+                                          : std::strcmp(name, "spacing") == 0
+                                                ? binary::path_spacing
+                                                : binary::path_position);
+                timelines.writeVarint(timeline->size);
+                for (auto frame = timeline->child; frame != nullptr;
+                     frame = frame->next) {
+                    timelines.writeFloat(Json_getFloat(frame, "time", 0));
+                    if (isMix) {
+                        timelines.writeFloat(
+                            Json_getFloat(frame, "rotateMix", 1));
+                        timelines.writeFloat(
+                            Json_getFloat(frame, "translateMix", 1));
+                    } else {
+                        timelines.writeFloat(Json_getFloat(frame, name, 0));
+                    }
+                    if (frame->next != nullptr &&
+                        not writeCurve(timelines, frame)) {
+                        return false;
+                    }
+                }
+            }
+            output_.writeVarint(timelineCount);
+            output_.append(timelines);
+        }
+        return true;
+    }
+
+    bool writeDeformTimelines(Json* animation) {
+        auto deform = Json_getItem(animation, "deform");
+        output_.writeVarint(deform == nullptr ? 0 : deform->size);
+        for (auto skin = deform == nullptr ? nullptr : deform->child;
+             skin != nullptr; skin = skin->next) {
+            auto skinIndex = findIndex(skins_, skin->name);
+            if (skinIndex == -1) {
+                return false;
+            }
+            output_.writeVarint(skinIndex);
+            output_.writeVarint(skin->size);
+            for (auto slot = skin->child; slot != nullptr; slot = slot->next) {
+                auto slotIndex = findIndex(slots_, slot->name);
+                if (slotIndex == -1) {
+                    return false;
+                }
+                output_.writeVarint(slotIndex);
+                output_.writeVarint(slot->size);
+                for (auto timeline = slot->child; timeline != nullptr;
+                     timeline = timeline->next) {
+                    output_.writeString(timeline->name);
+                    output_.writeVarint(timeline->size);
+                    for (auto frame = timeline->child; frame != nullptr;
+                         frame = frame->next) {
+                        output_.writeFloat(Json_getFloat(frame, "time", 0));
+                        // Empty vertices load as the setup pose either way.
+                        auto vertices = Json_getItem(frame, "vertices");
+                        auto count = vertices == nullptr ? 0 : vertices->size;
+                        output_.writeVarint(count);
+                        if (count > 0) {
+                            output_.writeVarint(
+                                Json_getInt(frame, "offset", 0));
+                            for (auto item = vertices->child; item != nullptr;
+                                 item = item->next) {
+                                output_.writeFloat(item->valueFloat);
+                            }
+                        }
+                        if (frame->next != nullptr &&
+                            not writeCurve(output_, frame)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool writeDrawOrderTimeline(Json* animation) {
+        auto drawOrder = Json_getItem(animation, "drawOrder");
+        output_.writeVarint(drawOrder == nullptr ? 0 : drawOrder->size);
+        for (auto frame = drawOrder == nullptr ? nullptr : drawOrder->child;
+             frame != nullptr; frame = frame->next) {
+            output_.writeFloat(Json_getFloat(frame, "time", 0));
+            // No offsets loads as the setup draw order either way.
+            auto offsets = Json_getItem(frame, "offsets");
+            output_.writeVarint(offsets == nullptr ? 0 : offsets->size);
+            for (auto offset = offsets == nullptr ? nullptr : offsets->child;
+                 offset != nullptr; offset = offset->next) {
+                auto index =
+                    findIndex(slots_, Json_getString(offset, "slot", nullptr));
+                if (index == -1) {
+                    return false;
+                }
+                output_.writeVarint(index);
+                // Negative offsets are read back from the unsigned encoding.
+                output_.writeVarint(Json_getInt(offset, "offset", 0));
+            }
+        }
+        return true;
+    }
+
+    bool writeEventTimeline(Json* animation) {
+        auto events = Json_getItem(animation, "events");
+        output_.writeVarint(events == nullptr ? 0 : events->size);
+        for (auto frame = events == nullptr ? nullptr : events->child;
+             frame != nullptr; frame = frame->next) {
+            auto index =
+                findIndex(events_, Json_getString(frame, "name", nullptr));
+            if (index == -1) {
+                return false;
+            }
+            auto event = eventData_.at(static_cast<std::size_t>(index));
+            output_.writeFloat(Json_getFloat(frame, "time", 0));
+            output_.writeVarint(index);
+            output_.writeVarint(
+                Json_getInt(frame, "int", Json_getInt(event, "int", 0)), false);
+            output_.writeFloat(
+                Json_getFloat(frame, "float", Json_getFloat(event, "float", 0)));
+            // The binary reader crashes when copying a null default string,
+            // the resolved string is always written instead.
+            output_.writeBoolean(true);
+            output_.writeString(Json_getString(
+                frame, "string", Json_getString(event, "string", nullptr)));
+        }
+        return true;
+    }
+
+    bool writeAnimation(Json* animation) {
+        return writeSlotTimelines(animation) &&
+               writeBoneTimelines(animation) &&
+               writeConstraintTimelines(animation) &&
+               writeDeformTimelines(animation) &&
+               writeDrawOrderTimeline(animation) &&
+               writeEventTimeline(animation);
+    }
+
+    Output output_;
+    std::vector<std::string> regions_;
+    IndexMap bones_;
+    IndexMap slots_;
+    IndexMap ikConstraints_;
+    IndexMap transformConstraints_;
+    IndexMap pathConstraints_;
+    IndexMap skins_;
+    IndexMap events_;
+    std::vector<Json*> eventData_;
+};
+} // namespace
+
+std::optional<Self::Result> Self::convert(const std::string& json) {
+    // Numbers are parsed with strtof, same as spSkeletonJson.
+    std::string oldLocale = std::setlocale(LC_NUMERIC, nullptr);
+    std::setlocale(LC_NUMERIC, "C");
+    auto root = Json_create(json.c_str());
+    std::setlocale(LC_NUMERIC, oldLocale.c_str());
+    if (root == nullptr) {
+        return std::nullopt;
+    }
+
+    Result result;
+    Converter converter;
+    auto succeeded = converter.convert(root, result);
+    Json_dispose(root);
+    if (not succeeded) {
+        return std::nullopt;
+    }
+    return result;
+}
+} // namespace ee
@@ -0,0 +1,36 @@
+#ifndef EE_PARSER_SKELETON_BINARY_WRITER_HPP
+#define EE_PARSER_SKELETON_BINARY_WRITER_HPP
+
+#include <string>
+#include <vector>
+
+#include "optional.hpp"
+
+namespace ee {
+/// Converts spine JSON skeletons to the spine binary format, so that they can
+/// be loaded with spSkeletonBinary instead of the much slower JSON parser.
+/// The conversion mirrors spSkeletonJson, the binary data loads the same
+/// skeleton data as the JSON it was converted from.
+class SkeletonBinaryWriter final {
+private:
+    using Self = SkeletonBinaryWriter;
+
+public:
+    struct Result {
+        /// The skeleton in the spine binary format.
+        std::string data;
+
+        /// Atlas regions used by the attachments, the binary reader does not
+        /// handle missing regions so they must be checked before loading.
+        std::vector<std::string> regions;
+    };
+
+    /// Converts a JSON skeleton.
+    /// @param json The JSON text.
+    /// @return std::nullopt if the JSON is malformed, or uses constructs that
+    /// the binary format can not represent.
+    static std::optional<Result> convert(const std::string& json);
+};
+} // namespace ee
+
+#endif // EE_PARSER_SKELETON_BINARY_WRITER_HPP
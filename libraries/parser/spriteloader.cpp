@@ -8,42 +8,61 @@ using Self = SpriteLoader;
 using Target = cocos2d::Sprite;
 using Helper = PropertyHelper<Target>;
 
+namespace key {
+constexpr auto texture = "texture";
+} // namespace key
+
+/// Interned once, converting a name to a symbol locks the symbol table.
+namespace symbol {
+const Symbol texture(key::texture);
+} // namespace symbol
+
+namespace {
+void applyTexture(Target* node, const std::string& texture) {
+    // Preserve content size and blend func.
+    auto&& contentSize = node->getContentSize();
+    auto&& blendFunc = node->getBlendFunc();
+    node->setTexture(texture);
+    node->setContentSize(contentSize);
+    node->setBlendFunc(blendFunc);
+}
+} // namespace
+
 const PropertyBlend Self::Property::BlendFunc(
     "blend_func",
-    Helper::makeReader<cocos2d::BlendFunc>(std::mem_fn(&Target::getBlendFunc)),
-    Helper::makeWriter<cocos2d::BlendFunc>(std::mem_fn(&Target::setBlendFunc)));
+    Helper::makeAccessor<cocos2d::BlendFunc, &Target::getBlendFunc,
+                         &Target::setBlendFunc>());
 
 const PropertyBool Self::Property::FlippedX(
-    "flipped_x", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isFlippedX)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setFlippedX)));
+    "flipped_x",
+    Helper::makeAccessor<bool, &Target::isFlippedX, &Target::setFlippedX>());
 
 const PropertyBool Self::Property::FlippedY(
-    "flipped_y", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isFlippedY)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setFlippedY)));
+    "flipped_y",
+    Helper::makeAccessor<bool, &Target::isFlippedY, &Target::setFlippedY>());
 
 const PropertyBool Self::Property::StretchEnabled(
     "stretch_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isStretchEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setStretchEnabled)));
+    Helper::makeAccessor<bool, &Target::isStretchEnabled,
+                         &Target::setStretchEnabled>());
 
 const PropertyString Self::Property::Texture(
     "texture", //
     Helper::makeReader<std::string>([](const Target* node) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        return handler.getProperty<std::string>("texture").value();
+        return handler.getProperty<std::string>(symbol::texture);
     }),
     Helper::makeWriter<std::string>([](Target* node, const std::string& value) {
         auto&& handler = NodeInfo::getPropertyHandler(node);
-        handler.setProperty("texture", Value(value));
-
-        // Preserve content size and blend func.
-        auto&& contentSize = node->getContentSize();
-        auto&& blendFunc = node->getBlendFunc();
-        node->setTexture(value);
-        node->setContentSize(contentSize);
-        node->setBlendFunc(blendFunc);
+        handler.setProperty(symbol::texture, Value(value));
+
+        // Resolve the texture once per batch.
+        auto info = NodeInfo::getInfo(node);
+        if (info->isBatching()) {
+            info->addPendingUpdate(symbol::texture);
+            return;
+        }
+        applyTexture(node, value);
     }));
 
 /*
@@ -72,6 +91,7 @@ Self::SpriteLoader() {
     addProperty(Property::FlippedY);
     addProperty(Property::StretchEnabled);
     addProperty(Property::Texture);
+    markTextureProperty(Property::Texture);
 }
 
 Self::~SpriteLoader() {}
@@ -84,6 +104,17 @@ cocos2d::Node* Self::createNode() const {
     return Target::create();
 }
 
+void Self::commitProperties(cocos2d::Node* node) const {
+    Super::commitProperties(node);
+    auto target = dynamic_cast<Target*>(node);
+    if (NodeInfo::getInfo(target)->takePendingUpdate(symbol::texture)) {
+        auto texture = Property::Texture.read(target);
+        if (texture) {
+            applyTexture(target, *texture);
+        }
+    }
+}
+
 Self* Self::cloneRaw() const {
     return new Self();
 }
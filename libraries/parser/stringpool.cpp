@@ -0,0 +1,87 @@
+#include <atomic>
+#include <cstring>
+
+#include "stringpool.hpp"
+#include "value.hpp"
+
+#include <xxhash/xxhash.h>
+
+namespace ee {
+namespace detail {
+struct PooledString {
+    explicit PooledString(const char* data, std::size_t size)
+        : referenceCount(1)
+        , value(data, size) {}
+
+    mutable std::atomic<std::size_t> referenceCount;
+    const std::string value;
+};
+
+void retain(const PooledString* string) {
+    string->referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void release(const PooledString* string) {
+    if (string->referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete string;
+    }
+}
+
+const std::string& getString(const PooledString* string) {
+    return string->value;
+}
+} // namespace detail
+
+namespace {
+/// Capacity of the inline buffer of std::string, shorter strings do not
+/// allocate so pooling them would not save anything.
+const std::size_t inline_capacity = std::string().capacity();
+} // namespace
+
+using Self = StringPool;
+
+Self::StringPool()
+    : stats_() {}
+
+Self::~StringPool() {
+    clear();
+}
+
+Value Self::intern(const char* data, std::size_t size) {
+    if (size <= inline_capacity) {
+        return Value(std::string(data, size));
+    }
+    ++stats_.requestCount;
+    stats_.requestedBytes += size;
+    auto hash = XXH32(data, size, 0);
+    auto range = strings_.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        auto&& value = iter->second->value;
+        if (value.size() == size &&
+            std::memcmp(value.data(), data, size) == 0) {
+            return Value(iter->second);
+        }
+    }
+    // The pool keeps the initial reference.
+    auto string = new detail::PooledString(data, size);
+    strings_.emplace(hash, string);
+    ++stats_.stringCount;
+    stats_.pooledBytes += size;
+    return Value(string);
+}
+
+Value Self::intern(const std::string& str) {
+    return intern(str.data(), str.size());
+}
+
+const Self::Stats& Self::getStats() const {
+    return stats_;
+}
+
+void Self::clear() {
+    for (auto&& elt : strings_) {
+        detail::release(elt.second);
+    }
+    strings_.clear();
+}
+} // namespace ee
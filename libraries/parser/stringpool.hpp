@@ -0,0 +1,68 @@
+#ifndef EE_PARSER_STRING_POOL_HPP
+#define EE_PARSER_STRING_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "parserfwd.hpp"
+
+namespace ee {
+namespace detail {
+struct PooledString;
+
+void retain(const PooledString* string);
+void release(const PooledString* string);
+const std::string& getString(const PooledString* string);
+} // namespace detail
+
+/// Interns the strings of a document, e.g. texture paths and atlas names, so
+/// that values holding the same string share a single immutable copy.
+/// Interned strings are reference counted and outlive the pool, a pool is
+/// usually dropped once its document is read. Not thread-safe.
+class StringPool final {
+private:
+    using Self = StringPool;
+
+public:
+    struct Stats {
+        /// Number of strings interned so far.
+        std::size_t requestCount;
+
+        /// Number of distinct strings.
+        std::size_t stringCount;
+
+        /// Characters the interned strings would take as separate copies.
+        std::size_t requestedBytes;
+
+        /// Characters actually stored by the pool.
+        std::size_t pooledBytes;
+    };
+
+    StringPool();
+    ~StringPool();
+
+    StringPool(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    /// Gets a string value sharing the pooled copy of the specified string.
+    /// Strings short enough to be stored inline by values are not pooled.
+    Value intern(const char* data, std::size_t size);
+    Value intern(const std::string& str);
+
+    const Stats& getStats() const;
+
+    /// Forgets the pooled strings, values still holding them keep them alive.
+    void clear();
+
+private:
+    /// Strings are keyed by their hash, collisions are resolved by comparing
+    /// the strings themselves.
+    std::unordered_multimap<std::uint32_t, const detail::PooledString*>
+        strings_;
+    Stats stats_;
+};
+} // namespace ee
+
+#endif // EE_PARSER_STRING_POOL_HPP
@@ -0,0 +1,118 @@
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "symbol.hpp"
+
+namespace ee {
+namespace detail {
+constexpr std::size_t component_count = 9;
+
+struct SymbolEntry {
+    SymbolEntry(Symbol::Id id_, const std::string& name_)
+        : id(id_)
+        , name(name_) {
+        for (auto&& component : components) {
+            component.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    const Symbol::Id id;
+    const std::string name;
+    mutable std::array<std::atomic<const SymbolEntry*>, component_count>
+        components;
+};
+} // namespace detail
+
+namespace {
+const char* const component_suffixes[] = {
+    "_x", "_y", "_width", "_height", "_r", "_g", "_b", "_src", "_dst",
+};
+
+static_assert(sizeof(component_suffixes) / sizeof(component_suffixes[0]) ==
+                  detail::component_count,
+              "Mismatched component count");
+
+class SymbolTable {
+public:
+    static SymbolTable& getInstance() {
+        static SymbolTable sharedInstance;
+        return sharedInstance;
+    }
+
+    const detail::SymbolEntry* intern(const std::string& name) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto iter = indices_.find(name);
+        if (iter != indices_.cend()) {
+            return iter->second;
+        }
+        auto id = static_cast<Symbol::Id>(entries_.size());
+        entries_.emplace_back(id, name);
+        auto entry = &entries_.back();
+        indices_.emplace(name, entry);
+        return entry;
+    }
+
+    std::size_t size() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return entries_.size();
+    }
+
+private:
+    SymbolTable() {
+        // Reserve id 0 for the empty symbol.
+        entries_.emplace_back(0, std::string());
+        indices_.emplace(std::string(), &entries_.back());
+    }
+
+    std::mutex mutex_;
+
+    /// Deque never relocates its elements.
+    std::deque<detail::SymbolEntry> entries_;
+    std::unordered_map<std::string, const detail::SymbolEntry*> indices_;
+};
+} // namespace
+
+using Self = Symbol;
+
+std::size_t Self::getSymbolCount() {
+    return SymbolTable::getInstance().size();
+}
+
+Self::Symbol() {
+    static const auto empty = SymbolTable::getInstance().intern(std::string());
+    entry_ = empty;
+}
+
+Self::Symbol(const std::string& name)
+    : Self(SymbolTable::getInstance().intern(name)) {}
+
+Self::Symbol(const char* name)
+    : Self(std::string(name)) {}
+
+Self::Symbol(const detail::SymbolEntry* entry)
+    : entry_(entry) {}
+
+Self::Id Self::getId() const {
+    return entry_->id;
+}
+
+const std::string& Self::getName() const {
+    return entry_->name;
+}
+
+Self Self::getComponent(Component component) const {
+    auto index = static_cast<std::size_t>(component);
+    auto&& slot = entry_->components[index];
+    auto entry = slot.load(std::memory_order_acquire);
+    if (entry == nullptr) {
+        // Racing threads intern the same name so they store the same entry.
+        entry = SymbolTable::getInstance().intern(entry_->name +
+                                                  component_suffixes[index]);
+        slot.store(entry, std::memory_order_release);
+    }
+    return Self(entry);
+}
+} // namespace ee
@@ -0,0 +1,77 @@
+#ifndef EE_PARSER_SYMBOL_HPP
+#define EE_PARSER_SYMBOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ee {
+namespace detail {
+struct SymbolEntry;
+} // namespace detail
+
+/// Interned property name.
+/// Symbols are unique per name and live as long as the program, so they can
+/// be compared and copied without touching the underlying string.
+class Symbol final {
+private:
+    using Self = Symbol;
+
+public:
+    using Id = std::uint32_t;
+
+    /// Sub-keys of the per-component form of vector-valued properties
+    /// written by older versions, e.g. position_x.
+    enum class Component {
+        X,
+        Y,
+        Width,
+        Height,
+        R,
+        G,
+        B,
+        Src,
+        Dst,
+    };
+
+    /// Gets the number of interned symbols.
+    static std::size_t getSymbolCount();
+
+    /// Constructs the empty symbol.
+    Symbol();
+
+    /// Interns the specified name.
+    Symbol(const std::string& name);
+    Symbol(const char* name);
+
+    /// Gets the unique id of this symbol, ids are assigned in interning
+    /// order.
+    Id getId() const;
+
+    /// Gets the name of this symbol.
+    const std::string& getName() const;
+
+    /// Gets the composite sub-key, resolved once and cached.
+    Self getComponent(Component component) const;
+
+    bool operator==(const Self& other) const { return entry_ == other.entry_; }
+    bool operator!=(const Self& other) const { return entry_ != other.entry_; }
+    bool operator<(const Self& other) const { return getId() < other.getId(); }
+
+private:
+    explicit Symbol(const detail::SymbolEntry* entry);
+
+    const detail::SymbolEntry* entry_;
+};
+} // namespace ee
+
+namespace std {
+template <>
+struct hash<ee::Symbol> {
+    std::size_t operator()(const ee::Symbol& symbol) const {
+        return symbol.getId();
+    }
+};
+} // namespace std
+
+#endif // EE_PARSER_SYMBOL_HPP
@@ -0,0 +1,17 @@
+#include "nodegraphtest.hpp"
+#include "skeletonbinarywritertest.hpp"
+
+#include <QCoreApplication>
+#include <QTest>
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("parser-test");
+
+    auto status = 0;
+    ee::NodeGraphTest nodeGraphTest;
+    status |= QTest::qExec(&nodeGraphTest, argc, argv);
+    ee::SkeletonBinaryWriterTest skeletonBinaryWriterTest;
+    status |= QTest::qExec(&skeletonBinaryWriterTest, argc, argv);
+    return status;
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+
+#include "nodegraphtest.hpp"
+
+#include <parser/nodegraph.hpp>
+
+#include <math/Vec2.h>
+
+#include <QTest>
+
+namespace ee {
+namespace {
+const Symbol name("name");
+const Symbol scale("scale");
+const Symbol position("position");
+
+NodeGraph makeGraph() {
+    NodeGraph graph;
+    graph.setBaseClass("_Node");
+    auto&& handler = graph.getPropertyHandler();
+    handler.setProperty(name, Value(std::string("root")));
+    handler.setProperty(scale, Value(0.1f));
+    NodeGraph child;
+    child.setBaseClass("_Sprite");
+    graph.addChild(child);
+    return graph;
+}
+
+/// Same content as the specified graph, built without sharing any node.
+NodeGraph rebuild(const NodeGraph& graph) {
+    return NodeGraph(graph.toDict());
+}
+} // namespace
+
+using Self = NodeGraphTest;
+
+void Self::hashOfCopy() {
+    auto graph = makeGraph();
+    auto copy = graph;
+    QCOMPARE(copy.getHash(), graph.getHash());
+    QCOMPARE(copy.getHash(), rebuild(graph).getHash());
+}
+
+void Self::hashAfterWriteThroughReference() {
+    auto graph = makeGraph();
+    auto&& handler = graph.getPropertyHandler();
+    auto hash = graph.getHash();
+    handler.setProperty(name, Value(std::string("renamed")));
+    QVERIFY(graph.getHash() != hash);
+    QCOMPARE(graph.getHash(), rebuild(graph).getHash());
+}
+
+void Self::hashAfterWriteThroughChildReference() {
+    auto graph = makeGraph();
+    auto&& handler = graph.getChild(0).getPropertyHandler();
+    auto hash = graph.getHash();
+    handler.setProperty(name, Value(std::string("child")));
+    QVERIFY(graph.getHash() != hash);
+    QCOMPARE(graph.getHash(), rebuild(graph).getHash());
+}
+
+void Self::hashOfNearlyEqualFloats() {
+    auto lhs = makeGraph();
+    auto rhs = makeGraph();
+    rhs.getPropertyHandler().setProperty(
+        scale, Value(std::nextafter(0.1f, 1.0f)));
+    QVERIFY(lhs.getPropertyHandler().getPropertyValues() ==
+            rhs.getPropertyHandler().getPropertyValues());
+    QCOMPARE(lhs.getHash(), rhs.getHash());
+
+    // Signed zeros compare equal.
+    lhs.getPropertyHandler().setProperty(scale, Value(0.0f));
+    rhs.getPropertyHandler().setProperty(scale, Value(-0.0f));
+    QCOMPARE(lhs.getHash(), rhs.getHash());
+}
+
+void Self::hashOfNearlyEqualPoints() {
+    auto lhs = makeGraph();
+    auto rhs = makeGraph();
+    lhs.getPropertyHandler().setProperty(position,
+                                         Value(cocos2d::Vec2(0.25f, 1.5f)));
+    rhs.getPropertyHandler().setProperty(
+        position, Value(cocos2d::Vec2(std::nextafter(0.25f, 1.0f), 1.5f)));
+    QVERIFY(lhs.getPropertyHandler().getPropertyValues() ==
+            rhs.getPropertyHandler().getPropertyValues());
+    QCOMPARE(lhs.getHash(), rhs.getHash());
+}
+} // namespace ee
@@ -0,0 +1,25 @@
+#ifndef EE_TEST_NODE_GRAPH_TEST_HPP
+#define EE_TEST_NODE_GRAPH_TEST_HPP
+
+#include <QObject>
+
+namespace ee {
+class NodeGraphTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    /// Copies share their data and their cached hash.
+    void hashOfCopy();
+
+    /// Writes through references held across getHash are seen by the next
+    /// getHash.
+    void hashAfterWriteThroughReference();
+    void hashAfterWriteThroughChildReference();
+
+    /// Floats that compare equal hash equally.
+    void hashOfNearlyEqualFloats();
+    void hashOfNearlyEqualPoints();
+};
+} // namespace ee
+
+#endif // EE_TEST_NODE_GRAPH_TEST_HPP
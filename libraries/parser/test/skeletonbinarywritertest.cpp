@@ -0,0 +1,388 @@
+#include <cstdarg>
+#include <vector>
+
+#include "skeletonbinarywritertest.hpp"
+
+#include <parser/skeletonbinarywriter.hpp>
+
+#include <spine/SkeletonBinary.h>
+#include <spine/SkeletonJson.h>
+#include <spine/extension.h>
+
+#include <QFile>
+#include <QStringList>
+#include <QTest>
+
+namespace ee {
+namespace {
+/// Creates attachments without looking up atlas regions, so that the sample
+/// skeleton loads without textures.
+spAttachment* createAttachment(spAttachmentLoader* loader, spSkin* skin,
+                               spAttachmentType type, const char* name,
+                               const char* path) {
+    switch (type) {
+    case SP_ATTACHMENT_REGION: {
+        auto attachment = spRegionAttachment_create(name);
+        // Unit region, updateOffset divides by the original size.
+        attachment->regionWidth = attachment->regionOriginalWidth = 1;
+        attachment->regionHeight = attachment->regionOriginalHeight = 1;
+        return SUPER(attachment);
+    }
+    case SP_ATTACHMENT_MESH:
+    case SP_ATTACHMENT_LINKED_MESH:
+        return SUPER(SUPER(spMeshAttachment_create(name)));
+    case SP_ATTACHMENT_BOUNDING_BOX:
+        return SUPER(SUPER(spBoundingBoxAttachment_create(name)));
+    case SP_ATTACHMENT_PATH:
+        return SUPER(SUPER(spPathAttachment_create(name)));
+    default:
+        _spAttachmentLoader_setUnknownTypeError(loader, type);
+        return nullptr;
+    }
+}
+
+spAttachmentLoader* createAttachmentLoader() {
+    auto loader = NEW(spAttachmentLoader);
+    _spAttachmentLoader_init(loader, _spAttachmentLoader_deinit,
+                             createAttachment, nullptr, nullptr);
+    return loader;
+}
+
+void print(QStringList& lines, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    lines.append(QString::vasprintf(format, args));
+    va_end(args);
+}
+
+const char* orNull(const char* str) {
+    return str == nullptr ? "(null)" : str;
+}
+
+QStringList describeBones(const spSkeletonData* data) {
+    QStringList lines;
+    for (int i = 0; i < data->bonesCount; ++i) {
+        auto bone = data->bones[i];
+        print(lines, "%s parent=%s length=%g", bone->name,
+              bone->parent == nullptr ? "-" : bone->parent->name,
+              bone->length);
+        print(lines, "  x=%g y=%g rotation=%g", bone->x, bone->y,
+              bone->rotation);
+        print(lines, "  scale=%g,%g shear=%g,%g transform=%d", bone->scaleX,
+              bone->scaleY, bone->shearX, bone->shearY, bone->transformMode);
+    }
+    return lines;
+}
+
+QStringList describeSlots(const spSkeletonData* data) {
+    QStringList lines;
+    for (int i = 0; i < data->slotsCount; ++i) {
+        auto slot = data->slots[i];
+        print(lines, "%s bone=%s attachment=%s blend=%d", slot->name,
+              slot->boneData->name, orNull(slot->attachmentName),
+              slot->blendMode);
+        print(lines, "  color=%g,%g,%g,%g", slot->r, slot->g, slot->b,
+              slot->a);
+    }
+    return lines;
+}
+
+QStringList describeConstraints(const spSkeletonData* data) {
+    QStringList lines;
+    for (int i = 0; i < data->ikConstraintsCount; ++i) {
+        auto ik = data->ikConstraints[i];
+        print(lines, "ik %s order=%d target=%s mix=%g bend=%d", ik->name,
+              ik->order, ik->target->name, ik->mix, ik->bendDirection);
+        for (int j = 0; j < ik->bonesCount; ++j) {
+            print(lines, "  bone=%s", ik->bones[j]->name);
+        }
+    }
+    for (int i = 0; i < data->transformConstraintsCount; ++i) {
+        auto tc = data->transformConstraints[i];
+        print(lines, "transform %s order=%d target=%s", tc->name, tc->order,
+              tc->target->name);
+        print(lines, "  offset=%g,%g,%g,%g,%g,%g", tc->offsetRotation,
+              tc->offsetX, tc->offsetY, tc->offsetScaleX, tc->offsetScaleY,
+              tc->offsetShearY);
+        print(lines, "  mix=%g,%g,%g,%g", tc->rotateMix, tc->translateMix,
+              tc->scaleMix, tc->shearMix);
+        for (int j = 0; j < tc->bonesCount; ++j) {
+            print(lines, "  bone=%s", tc->bones[j]->name);
+        }
+    }
+    for (int i = 0; i < data->pathConstraintsCount; ++i) {
+        auto pc = data->pathConstraints[i];
+        print(lines, "path %s order=%d target=%s modes=%d,%d,%d", pc->name,
+              pc->order, pc->target->name, pc->positionMode, pc->spacingMode,
+              pc->rotateMode);
+        print(lines, "  offset=%g position=%g spacing=%g mix=%g,%g",
+              pc->offsetRotation, pc->position, pc->spacing, pc->rotateMix,
+              pc->translateMix);
+        for (int j = 0; j < pc->bonesCount; ++j) {
+            print(lines, "  bone=%s", pc->bones[j]->name);
+        }
+    }
+    return lines;
+}
+
+void describeVertices(QStringList& lines, const spVertexAttachment* vertex) {
+    print(lines, "  world=%d bones=%d", vertex->worldVerticesLength,
+          vertex->bonesCount);
+    for (int i = 0; i < vertex->bonesCount; ++i) {
+        print(lines, "  bone %d", vertex->bones[i]);
+    }
+    for (int i = 0; i < vertex->verticesCount; ++i) {
+        print(lines, "  vertex %g", vertex->vertices[i]);
+    }
+}
+
+void describeAttachment(QStringList& lines, spAttachment* attachment) {
+    print(lines, " %s type=%d", attachment->name, attachment->type);
+    switch (attachment->type) {
+    case SP_ATTACHMENT_REGION: {
+        auto region = SUB_CAST(spRegionAttachment, attachment);
+        print(lines, "  path=%s x=%g y=%g rotation=%g", orNull(region->path),
+              region->x, region->y, region->rotation);
+        print(lines, "  scale=%g,%g size=%g,%g", region->scaleX,
+              region->scaleY, region->width, region->height);
+        print(lines, "  color=%g,%g,%g,%g", region->r, region->g, region->b,
+              region->a);
+        for (auto offset : region->offset) {
+            print(lines, "  offset %g", offset);
+        }
+        break;
+    }
+    case SP_ATTACHMENT_MESH:
+    case SP_ATTACHMENT_LINKED_MESH: {
+        auto mesh = SUB_CAST(spMeshAttachment, attachment);
+        describeVertices(lines, SUPER(mesh));
+        // hullLength is left out: spSkeletonJson keeps the hull vertex count
+        // while spSkeletonBinary doubles it.
+        print(lines, "  path=%s size=%g,%g deform=%d parent=%s",
+              orNull(mesh->path), mesh->width, mesh->height,
+              mesh->inheritDeform,
+              mesh->parentMesh == nullptr ? "-"
+                                          : mesh->parentMesh->super.super.name);
+        print(lines, "  color=%g,%g,%g,%g", mesh->r, mesh->g, mesh->b,
+              mesh->a);
+        for (int i = 0; i < mesh->super.worldVerticesLength; ++i) {
+            print(lines, "  uv %g", mesh->regionUVs[i]);
+        }
+        for (int i = 0; i < mesh->trianglesCount; ++i) {
+            print(lines, "  triangle %d", mesh->triangles[i]);
+        }
+        break;
+    }
+    case SP_ATTACHMENT_BOUNDING_BOX:
+        describeVertices(lines, SUB_CAST(spVertexAttachment, attachment));
+        break;
+    case SP_ATTACHMENT_PATH: {
+        auto path = SUB_CAST(spPathAttachment, attachment);
+        describeVertices(lines, SUPER(path));
+        print(lines, "  closed=%d constant=%d", path->closed,
+              path->constantSpeed);
+        for (int i = 0; i < path->lengthsLength; ++i) {
+            print(lines, "  length %g", path->lengths[i]);
+        }
+        break;
+    }
+    }
+}
+
+QStringList describeSkins(const spSkeletonData* data) {
+    QStringList lines;
+    print(lines, "default=%s",
+          data->defaultSkin == nullptr ? "-" : data->defaultSkin->name);
+    for (int i = 0; i < data->skinsCount; ++i) {
+        auto skin = data->skins[i];
+        for (int slot = 0; slot < data->slotsCount; ++slot) {
+            for (int j = 0;; ++j) {
+                auto name = spSkin_getAttachmentName(skin, slot, j);
+                if (name == nullptr) {
+                    break;
+                }
+                print(lines, "%s slot=%s key=%s", skin->name,
+                      data->slots[slot]->name, name);
+                describeAttachment(lines,
+                                   spSkin_getAttachment(skin, slot, name));
+            }
+        }
+    }
+    return lines;
+}
+
+QStringList describeEvents(const spSkeletonData* data) {
+    QStringList lines;
+    for (int i = 0; i < data->eventsCount; ++i) {
+        auto event = data->events[i];
+        print(lines, "%s int=%d float=%g string=%s", event->name,
+              event->intValue, event->floatValue, orNull(event->stringValue));
+    }
+    return lines;
+}
+
+void describePose(QStringList& lines, spSkeleton* skeleton) {
+    spSkeleton_updateWorldTransform(skeleton);
+    for (int i = 0; i < skeleton->bonesCount; ++i) {
+        auto bone = skeleton->bones[i];
+        print(lines, "  %s %.4f %.4f %.4f %.4f %.4f %.4f", bone->data->name,
+              bone->a, bone->b, bone->c, bone->d, bone->worldX, bone->worldY);
+    }
+    std::vector<float> worldVertices;
+    for (int i = 0; i < skeleton->slotsCount; ++i) {
+        auto slot = skeleton->drawOrder[i];
+        print(lines, "  %s %.4f %.4f %.4f %.4f %s", slot->data->name, slot->r,
+              slot->g, slot->b, slot->a,
+              slot->attachment == nullptr ? "-" : slot->attachment->name);
+        for (int j = 0; j < slot->attachmentVerticesCount; ++j) {
+            print(lines, "   deform %.4f", slot->attachmentVertices[j]);
+        }
+        if (slot->attachment == nullptr ||
+            slot->attachment->type == SP_ATTACHMENT_REGION) {
+            continue;
+        }
+        auto vertex = SUB_CAST(spVertexAttachment, slot->attachment);
+        worldVertices.resize(vertex->worldVerticesLength);
+        spVertexAttachment_computeWorldVertices(vertex, slot,
+                                                worldVertices.data());
+        for (auto value : worldVertices) {
+            print(lines, "   world %.4f", value);
+        }
+    }
+}
+
+/// Counts the events an animation can fire in one apply.
+int countEvents(const spAnimation* animation) {
+    auto count = 0;
+    for (int i = 0; i < animation->timelinesCount; ++i) {
+        auto timeline = animation->timelines[i];
+        if (timeline->type == SP_TIMELINE_EVENT) {
+            count += SUB_CAST(spEventTimeline, timeline)->framesCount;
+        }
+    }
+    return count;
+}
+
+QStringList describeAnimations(spSkeletonData* data) {
+    constexpr auto step = 0.05f;
+    QStringList lines;
+    for (int i = 0; i < data->animationsCount; ++i) {
+        auto animation = data->animations[i];
+        print(lines, "%s duration=%g timelines=%d", animation->name,
+              animation->duration, animation->timelinesCount);
+        std::vector<spEvent*> events(countEvents(animation));
+        // The default skin alone, then each other skin over it.
+        for (int j = -1; j < data->skinsCount; ++j) {
+            auto skin = j < 0 ? data->defaultSkin : data->skins[j];
+            if (j >= 0 && skin == data->defaultSkin) {
+                continue;
+            }
+            auto skeleton = spSkeleton_create(data);
+            spSkeleton_setSkin(skeleton, j < 0 ? nullptr : skin);
+            auto lastTime = -1.0f;
+            for (int frame = 0; frame * step <= animation->duration + step;
+                 ++frame) {
+                auto time = frame * step;
+                auto eventsCount = 0;
+                spSkeleton_setToSetupPose(skeleton);
+                spAnimation_apply(animation, skeleton, lastTime, time, 0,
+                                  events.data(), &eventsCount, 1, 1, 0);
+                lastTime = time;
+                print(lines, " skin=%s time=%.2f",
+                      skin == nullptr ? "-" : skin->name, time);
+                for (int k = 0; k < eventsCount; ++k) {
+                    auto event = events[k];
+                    print(lines, "  event %s %g %d %g %s", event->data->name,
+                          event->time, event->intValue, event->floatValue,
+                          orNull(event->stringValue));
+                }
+                describePose(lines, skeleton);
+            }
+            spSkeleton_dispose(skeleton);
+        }
+    }
+    return lines;
+}
+} // namespace
+
+using Self = SkeletonBinaryWriterTest;
+
+struct Self::Skeleton {
+    static std::unique_ptr<Skeleton> fromJson(const std::string& json) {
+        auto result = std::make_unique<Skeleton>();
+        auto reader = spSkeletonJson_createWithLoader(result->loader);
+        result->data = spSkeletonJson_readSkeletonData(reader, json.c_str());
+        spSkeletonJson_dispose(reader);
+        return result;
+    }
+
+    static std::unique_ptr<Skeleton> fromBinary(const std::string& binary) {
+        auto result = std::make_unique<Skeleton>();
+        auto reader = spSkeletonBinary_createWithLoader(result->loader);
+        result->data = spSkeletonBinary_readSkeletonData(
+            reader, reinterpret_cast<const unsigned char*>(binary.data()),
+            static_cast<int>(binary.size()));
+        spSkeletonBinary_dispose(reader);
+        return result;
+    }
+
+    ~Skeleton() {
+        if (data != nullptr) {
+            spSkeletonData_dispose(data);
+        }
+        spAttachmentLoader_dispose(loader);
+    }
+
+    /// Attachments keep their loader, it must outlive the data.
+    spAttachmentLoader* loader = createAttachmentLoader();
+    spSkeletonData* data = nullptr;
+};
+
+Self::SkeletonBinaryWriterTest() = default;
+Self::~SkeletonBinaryWriterTest() = default;
+
+void Self::initTestCase() {
+    QFile file(QFINDTESTDATA("data/skeleton.json"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    auto json = file.readAll().toStdString();
+
+    json_ = Skeleton::fromJson(json);
+    QVERIFY(json_->data != nullptr);
+
+    auto result = SkeletonBinaryWriter::convert(json);
+    QVERIFY(result.has_value());
+    binary_ = Skeleton::fromBinary(result->data);
+    QVERIFY(binary_->data != nullptr);
+}
+
+void Self::cleanupTestCase() {
+    json_.reset();
+    binary_.reset();
+}
+
+void Self::compareBones() {
+    QCOMPARE(describeBones(binary_->data), describeBones(json_->data));
+}
+
+void Self::compareSlots() {
+    QCOMPARE(describeSlots(binary_->data), describeSlots(json_->data));
+}
+
+void Self::compareConstraints() {
+    QCOMPARE(describeConstraints(binary_->data),
+             describeConstraints(json_->data));
+}
+
+void Self::compareSkins() {
+    QCOMPARE(describeSkins(binary_->data), describeSkins(json_->data));
+}
+
+void Self::compareEvents() {
+    QCOMPARE(describeEvents(binary_->data), describeEvents(json_->data));
+}
+
+void Self::compareAnimations() {
+    QCOMPARE(describeAnimations(binary_->data),
+             describeAnimations(json_->data));
+}
+} // namespace ee
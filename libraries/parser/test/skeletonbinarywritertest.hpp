@@ -0,0 +1,40 @@
+#ifndef EE_TEST_SKELETON_BINARY_WRITER_TEST_HPP
+#define EE_TEST_SKELETON_BINARY_WRITER_TEST_HPP
+
+#include <memory>
+
+#include <QObject>
+
+namespace ee {
+/// Loads the sample skeleton from its JSON and from the binary converted by
+/// SkeletonBinaryWriter, then checks that both load the same data.
+class SkeletonBinaryWriterTest : public QObject {
+    Q_OBJECT
+
+public:
+    SkeletonBinaryWriterTest();
+    ~SkeletonBinaryWriterTest() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void compareBones();
+    void compareSlots();
+    void compareConstraints();
+    void compareSkins();
+    void compareEvents();
+
+    /// Poses both skeletons over each animation with every skin, comparing
+    /// the poses and the fired events.
+    void compareAnimations();
+
+private:
+    struct Skeleton;
+
+    std::unique_ptr<Skeleton> json_;
+    std::unique_ptr<Skeleton> binary_;
+};
+} // namespace ee
+
+#endif // EE_TEST_SKELETON_BINARY_WRITER_TEST_HPP
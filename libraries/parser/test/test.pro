@@ -0,0 +1,62 @@
+include(../../cocos2d/cocos2d.pri)
+
+QT -= gui
+QT += opengl testlib
+
+TARGET = parser-test
+TEMPLATE = app
+
+CONFIG += c++1z
+CONFIG += console
+CONFIG += testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += \
+    ../..
+
+mac {
+    LIBS += \
+        -L$$OUT_PWD/../../cocos2d -lcocos2d \
+        -L$$OUT_PWD/.. -lparser \
+        -L$$OUT_PWD/../../qtplist -lqtplist
+
+    PRE_TARGETDEPS += \
+        $$OUT_PWD/../../cocos2d/libcocos2d.a \
+        $$OUT_PWD/../libparser.a \
+        $$OUT_PWD/../../qtplist/libqtplist.a
+}
+
+win32 {
+    CONFIG(debug, debug|release) {
+        LIBS += \
+            -L$$OUT_PWD/../../cocos2d/debug -lcocos2d \
+            -L$$OUT_PWD/../debug -lparser
+
+        PRE_TARGETDEPS += \
+            $$OUT_PWD/../../cocos2d/debug/cocos2d.lib \
+            $$OUT_PWD/../debug/parser.lib
+    }
+    CONFIG(release, debug|release) {
+        LIBS += \
+            -L$$OUT_PWD/../../cocos2d/release -lcocos2d \
+            -L$$OUT_PWD/../release -lparser
+
+        PRE_TARGETDEPS += \
+            $$OUT_PWD/../../cocos2d/release/cocos2d.lib \
+            $$OUT_PWD/../release/parser.lib
+    }
+}
+
+HEADERS += \
+    nodegraphtest.hpp \
+    skeletonbinarywritertest.hpp
+
+SOURCES += \
+    main.cpp \
+    nodegraphtest.cpp \
+    skeletonbinarywritertest.cpp
+
+DISTFILES += \
+    data/skeleton.json
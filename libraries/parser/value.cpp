@@ -1,14 +1,65 @@
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <numeric>
 
+#include "stringpool.hpp"
 #include "value.hpp"
 
 #include <base/CCValue.h>
+#include <base/ccTypes.h>
+#include <math/CCGeometry.h>
+#include <math/Vec2.h>
 
 namespace ee {
+namespace tag {
+constexpr auto vec2 = "@vec2";
+constexpr auto size = "@size";
+constexpr auto color = "@color";
+constexpr auto rect = "@rect";
+constexpr auto blend = "@blend";
+} // namespace tag
+
+namespace {
+/// Reads exactly count numbers from the specified list.
+bool readFloats(const ValueList& list, std::size_t count, float* output) {
+    if (list.size() != count) {
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        auto value = list[i].getFloat();
+        if (not value.has_value()) {
+            return false;
+        }
+        output[i] = value.value();
+    }
+    return true;
+}
+
+bool readInts(const ValueList& list, std::size_t count, int* output) {
+    if (list.size() != count) {
+        return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        auto value = list[i].getInt();
+        if (not value.has_value()) {
+            return false;
+        }
+        output[i] = value.value();
+    }
+    return true;
+}
+
+bool isNearlyEqual(float lhs, float rhs) {
+    return std::abs(lhs - rhs) <= std::numeric_limits<float>::epsilon();
+}
+} // namespace
+
 using Self = Value;
 
+static_assert(sizeof(Value) <= 16,
+              "Every property pays for the size of Value");
+
 const Self Self::Null = Self();
 
 Self Self::fromValue(const cocos2d::Value& value) {
@@ -33,6 +84,10 @@ Self Self::fromValue(const cocos2d::Value& value) {
         for (auto&& elt : value.asValueMap()) {
             dict.emplace(elt.first, fromValue(elt.second));
         }
+        auto packed = fromTagged(dict);
+        if (packed.has_value()) {
+            return std::move(packed.value());
+        }
         return Self(dict);
     }
     default:
@@ -40,6 +95,76 @@ Self Self::fromValue(const cocos2d::Value& value) {
     }
 }
 
+std::optional<Self> Self::fromTagged(const ValueMap& dict) {
+    if (dict.size() != 1) {
+        return std::nullopt;
+    }
+    auto&& elt = *dict.cbegin();
+    if (elt.first.empty() || elt.first[0] != '@' || not elt.second.isList()) {
+        return std::nullopt;
+    }
+    auto&& name = elt.first;
+    auto&& list = elt.second.asList();
+    float f[4];
+    int i[3];
+    if (name == tag::vec2 && readFloats(list, 2, f)) {
+        return Self(cocos2d::Vec2(f[0], f[1]));
+    }
+    if (name == tag::size && readFloats(list, 2, f)) {
+        return Self(cocos2d::Size(f[0], f[1]));
+    }
+    if (name == tag::color && readInts(list, 3, i)) {
+        return Self(cocos2d::Color3B(static_cast<GLubyte>(i[0]),
+                                     static_cast<GLubyte>(i[1]),
+                                     static_cast<GLubyte>(i[2])));
+    }
+    if (name == tag::rect && readFloats(list, 4, f)) {
+        return Self(cocos2d::Rect(f[0], f[1], f[2], f[3]));
+    }
+    if (name == tag::blend && readInts(list, 2, i)) {
+        return Self(cocos2d::BlendFunc{static_cast<GLenum>(i[0]),
+                                       static_cast<GLenum>(i[1])});
+    }
+    return std::nullopt;
+}
+
+ValueMap Self::toTagged() const {
+    assert(isPacked());
+    ValueList list;
+    const char* name = "";
+    switch (getType()) {
+    case Type::Vec2:
+    case Type::Size:
+        name = isVec2() ? tag::vec2 : tag::size;
+        list.emplace_back(field_.v[0]);
+        list.emplace_back(field_.v[1]);
+        break;
+    case Type::Color:
+        name = tag::color;
+        for (auto&& component : field_.c) {
+            list.emplace_back(static_cast<int>(component));
+        }
+        break;
+    case Type::Rect:
+        name = tag::rect;
+        list.emplace_back(field_.r->origin.x);
+        list.emplace_back(field_.r->origin.y);
+        list.emplace_back(field_.r->size.width);
+        list.emplace_back(field_.r->size.height);
+        break;
+    case Type::Blend:
+        name = tag::blend;
+        list.emplace_back(static_cast<int>(field_.e[0]));
+        list.emplace_back(static_cast<int>(field_.e[1]));
+        break;
+    default:
+        break;
+    }
+    ValueMap dict;
+    dict.emplace(name, Self(std::move(list)));
+    return dict;
+}
+
 cocos2d::Value Self::toValue() const {
     switch (getType()) {
     case Type::Bool:
@@ -64,6 +189,12 @@ cocos2d::Value Self::toValue() const {
         }
         return cocos2d::Value(std::move(dict));
     }
+    case Type::Vec2:
+    case Type::Size:
+    case Type::Color:
+    case Type::Rect:
+    case Type::Blend:
+        return Self(toTagged()).toValue();
     default:
         return cocos2d::Value::Null;
     }
@@ -118,12 +249,44 @@ Self::Value(ValueMap&& value) {
     *this = std::move(value);
 }
 
+Self::Value(const cocos2d::Vec2& value) {
+    type_ = Type::None;
+    *this = value;
+}
+
+Self::Value(const cocos2d::Size& value) {
+    type_ = Type::None;
+    *this = value;
+}
+
+Self::Value(const cocos2d::Color3B& value) {
+    type_ = Type::None;
+    *this = value;
+}
+
+Self::Value(const cocos2d::Rect& value) {
+    type_ = Type::None;
+    *this = value;
+}
+
+Self::Value(const cocos2d::BlendFunc& value) {
+    type_ = Type::None;
+    *this = value;
+}
+
+Self::Value(const detail::PooledString* value) {
+    detail::retain(value);
+    field_.p = value;
+    type_ = Type::String;
+    interned_ = true;
+}
+
 Self::Value(const Self& other) {
     type_ = Type::None;
     *this = other;
 }
 
-Self::Value(Self&& other) {
+Self::Value(Self&& other) noexcept {
     type_ = Type::None;
     *this = std::move(other);
 }
@@ -137,60 +300,56 @@ Self& Self::operator=(const Self& other) {
         return *this;
     }
     switch (other.type_) {
-    case Type::None:
-        clear();
-        break;
-    case Type::Bool:
-        *this = other.field_.b;
-        break;
-    case Type::Int:
-        *this = other.field_.i;
-        break;
-    case Type::Float:
-        *this = other.field_.f;
-        break;
     case Type::String:
-        *this = other.field_.s;
+        if (other.interned_) {
+            auto value = other.field_.p;
+            detail::retain(value);
+            clear();
+            field_.p = value;
+            type_ = Type::String;
+            interned_ = true;
+        } else {
+            *this = *other.field_.s;
+        }
         break;
     case Type::List:
-        *this = other.field_.l;
+        *this = *other.field_.l;
         break;
     case Type::Map:
-        *this = other.field_.m;
+        *this = *other.field_.m;
         break;
+    case Type::Rect:
+        *this = *other.field_.r;
+        break;
+    default: {
+        // The remaining types are trivially copyable, copy before clearing
+        // since other may be owned by this.
+        auto field = other.field_;
+        auto type = other.type_;
+        clear();
+        field_ = field;
+        type_ = type;
+        break;
+    }
     }
     return *this;
 }
 
-Self& Self::operator=(Self&& other) {
+Self& Self::operator=(Self&& other) noexcept {
     if (this == &other) {
         return *this;
     }
-    switch (other.type_) {
-    case Type::None:
-        clear();
-        break;
-    case Type::Bool:
-        *this = std::move(other.field_.b);
-        break;
-    case Type::Int:
-        *this = std::move(other.field_.i);
-        break;
-    case Type::Float:
-        *this = std::move(other.field_.f);
-        break;
-    case Type::String:
-        *this = std::move(other.field_.s);
-        break;
-    case Type::List:
-        *this = std::move(other.field_.l);
-        break;
-    case Type::Map:
-        *this = std::move(other.field_.m);
-        break;
-    }
-    type_ = other.type_;
-    other.clear();
+    // Detach from other first, other may be owned by this. Owned storage is
+    // only referenced by pointers, so the field is moved bitwise.
+    auto field = other.field_;
+    auto type = other.type_;
+    auto interned = other.interned_;
+    other.type_ = Type::None;
+    other.interned_ = false;
+    clear();
+    field_ = field;
+    type_ = type;
+    interned_ = interned;
     return *this;
 }
 
@@ -215,68 +374,105 @@ Self& Self::operator=(float value) {
 }
 
 Self& Self::operator=(const std::string& value) {
-    return *this = std::make_unique<std::string>(value);
+    if (isString() && not interned_) {
+        *field_.s = value;
+        return *this;
+    }
+    // Copy before clearing, value may be owned by this.
+    auto str = new std::string(value);
+    clear();
+    field_.s = str;
+    type_ = Type::String;
+    return *this;
 }
 
 Self& Self::operator=(std::string&& value) {
-    return *this = std::make_unique<std::string>(std::move(value));
+    if (isString() && not interned_) {
+        *field_.s = std::move(value);
+        return *this;
+    }
+    auto str = new std::string(std::move(value));
+    clear();
+    field_.s = str;
+    type_ = Type::String;
+    return *this;
 }
 
 Self& Self::operator=(const ValueList& value) {
-    return *this = std::make_unique<ValueList>(value);
+    // Copy before clearing, value may be owned by this.
+    auto list = new ValueList(value);
+    clear();
+    field_.l = list;
+    type_ = Type::List;
+    return *this;
 }
 
 Self& Self::operator=(ValueList&& value) {
-    return *this = std::make_unique<ValueList>(std::move(value));
+    auto list = new ValueList(std::move(value));
+    clear();
+    field_.l = list;
+    type_ = Type::List;
+    return *this;
 }
 
 Self& Self::operator=(const ValueMap& value) {
-    return *this = std::make_unique<ValueMap>(value);
+    auto dict = new ValueMap(value);
+    clear();
+    field_.m = dict;
+    type_ = Type::Map;
+    return *this;
 }
 
 Self& Self::operator=(ValueMap&& value) {
-    return *this = std::make_unique<ValueMap>(std::move(value));
-}
-
-Self& Self::operator=(const std::unique_ptr<std::string>& value) {
+    auto dict = new ValueMap(std::move(value));
     clear();
-    new (&field_.s) std::unique_ptr<std::string>(new std::string(*value));
-    type_ = Type::String;
+    field_.m = dict;
+    type_ = Type::Map;
     return *this;
 }
 
-Self& Self::operator=(std::unique_ptr<std::string>&& value) {
+Self& Self::operator=(const cocos2d::Vec2& value) {
     clear();
-    new (&field_.s) std::unique_ptr<std::string>(std::move(value));
-    type_ = Type::String;
+    field_.v[0] = value.x;
+    field_.v[1] = value.y;
+    type_ = Type::Vec2;
     return *this;
 }
 
-Self& Self::operator=(const std::unique_ptr<ValueList>& value) {
+Self& Self::operator=(const cocos2d::Size& value) {
     clear();
-    new (&field_.l) std::unique_ptr<ValueList>(new ValueList(*value));
-    type_ = Type::List;
+    field_.v[0] = value.width;
+    field_.v[1] = value.height;
+    type_ = Type::Size;
     return *this;
 }
 
-Self& Self::operator=(std::unique_ptr<ValueList>&& value) {
+Self& Self::operator=(const cocos2d::Color3B& value) {
     clear();
-    new (&field_.l) std::unique_ptr<ValueList>(std::move(value));
-    type_ = Type::List;
+    field_.c[0] = value.r;
+    field_.c[1] = value.g;
+    field_.c[2] = value.b;
+    type_ = Type::Color;
     return *this;
 }
 
-Self& Self::operator=(const std::unique_ptr<ValueMap>& value) {
+Self& Self::operator=(const cocos2d::Rect& value) {
+    if (isRect()) {
+        *field_.r = value;
+        return *this;
+    }
+    auto rect = new cocos2d::Rect(value);
     clear();
-    new (&field_.m) std::unique_ptr<ValueMap>(new ValueMap(*value));
-    type_ = Type::Map;
+    field_.r = rect;
+    type_ = Type::Rect;
     return *this;
 }
 
-Self& Self::operator=(std::unique_ptr<ValueMap>&& value) {
+Self& Self::operator=(const cocos2d::BlendFunc& value) {
     clear();
-    new (&field_.m) std::unique_ptr<ValueMap>(std::move(value));
-    type_ = Type::Map;
+    field_.e[0] = value.src;
+    field_.e[1] = value.dst;
+    type_ = Type::Blend;
     return *this;
 }
 
@@ -298,11 +494,30 @@ bool Self::operator==(const Self& other) const {
         return std::abs(getFloat().value() - other.getFloat().value()) <=
                std::numeric_limits<float>::epsilon();
     case Type::String:
+        if (interned_ && other.interned_ && field_.p == other.field_.p) {
+            return true;
+        }
         return asString() == other.asString();
     case Type::List:
         return asList() == other.asList();
     case Type::Map:
         return asMap() == other.asMap();
+    case Type::Vec2:
+    case Type::Size:
+        return isNearlyEqual(field_.v[0], other.field_.v[0]) &&
+               isNearlyEqual(field_.v[1], other.field_.v[1]);
+    case Type::Color:
+        return std::memcmp(field_.c, other.field_.c, sizeof(field_.c)) == 0;
+    case Type::Rect:
+        return isNearlyEqual(field_.r->origin.x, other.field_.r->origin.x) &&
+               isNearlyEqual(field_.r->origin.y, other.field_.r->origin.y) &&
+               isNearlyEqual(field_.r->size.width,
+                             other.field_.r->size.width) &&
+               isNearlyEqual(field_.r->size.height,
+                             other.field_.r->size.height);
+    case Type::Blend:
+        return field_.e[0] == other.field_.e[0] &&
+               field_.e[1] == other.field_.e[1];
     }
     assert(false);
 }
@@ -343,6 +558,34 @@ bool Self::isMap() const {
     return getType() == Type::Map;
 }
 
+bool Self::isVec2() const {
+    return getType() == Type::Vec2;
+}
+
+bool Self::isSize() const {
+    return getType() == Type::Size;
+}
+
+bool Self::isColor() const {
+    return getType() == Type::Color;
+}
+
+bool Self::isRect() const {
+    return getType() == Type::Rect;
+}
+
+bool Self::isBlend() const {
+    return getType() == Type::Blend;
+}
+
+bool Self::isPacked() const {
+    return isVec2() || isSize() || isColor() || isRect() || isBlend();
+}
+
+bool Self::isInterned() const {
+    return isString() && interned_;
+}
+
 std::optional<bool> Self::getBool() const {
     return isBool() ? std::make_optional(field_.b) : std::nullopt;
 }
@@ -360,7 +603,7 @@ std::optional<float> Self::getFloat() const {
 }
 
 std::optional<std::string> Self::getString() const {
-    return isString() ? std::make_optional(*field_.s) : std::nullopt;
+    return isString() ? std::make_optional(asString()) : std::nullopt;
 }
 
 std::optional<ValueList> Self::getList() const {
@@ -371,9 +614,38 @@ std::optional<ValueMap> Self::getMap() const {
     return isMap() ? std::make_optional(*field_.m) : std::nullopt;
 }
 
+std::optional<cocos2d::Vec2> Self::getVec2() const {
+    return isVec2()
+               ? std::make_optional(cocos2d::Vec2(field_.v[0], field_.v[1]))
+               : std::nullopt;
+}
+
+std::optional<cocos2d::Size> Self::getSize() const {
+    return isSize()
+               ? std::make_optional(cocos2d::Size(field_.v[0], field_.v[1]))
+               : std::nullopt;
+}
+
+std::optional<cocos2d::Color3B> Self::getColor() const {
+    return isColor() ? std::make_optional(cocos2d::Color3B(
+                           field_.c[0], field_.c[1], field_.c[2]))
+                     : std::nullopt;
+}
+
+std::optional<cocos2d::Rect> Self::getRect() const {
+    return isRect() ? std::make_optional(*field_.r) : std::nullopt;
+}
+
+std::optional<cocos2d::BlendFunc> Self::getBlend() const {
+    return isBlend() ? std::make_optional(cocos2d::BlendFunc{
+                           static_cast<GLenum>(field_.e[0]),
+                           static_cast<GLenum>(field_.e[1])})
+                     : std::nullopt;
+}
+
 const std::string& Self::asString() const {
     assert(isString());
-    return *field_.s;
+    return interned_ ? detail::getString(field_.p) : *field_.s;
 }
 
 ValueList& Self::asList() {
@@ -410,15 +682,28 @@ void Self::clear() {
         field_.f = 0;
         break;
     case Type::String:
-        field_.s.~unique_ptr();
+        if (interned_) {
+            detail::release(field_.p);
+        } else {
+            delete field_.s;
+        }
         break;
     case Type::List:
-        field_.l.~unique_ptr();
+        delete field_.l;
         break;
     case Type::Map:
-        field_.m.~unique_ptr();
+        delete field_.m;
+        break;
+    case Type::Rect:
+        delete field_.r;
+        break;
+    case Type::Vec2:
+    case Type::Size:
+    case Type::Color:
+    case Type::Blend:
         break;
     }
     type_ = Type::None;
+    interned_ = false;
 }
 } // namespace ee
@@ -1,6 +1,7 @@
 #ifndef EE_PARSER_VALUE_HPP
 #define EE_PARSER_VALUE_HPP
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -9,25 +10,41 @@
 #include "parserfwd.hpp"
 
 namespace ee {
+namespace detail {
+struct PooledString;
+} // namespace detail
+
+class StringPool;
+
 class Value final {
 private:
     using Self = Value;
 
 public:
-    enum class Type {
+    enum class Type : std::uint8_t {
         None,   ///< Empty.
         Bool,   ///< Wraps a bool.
         Int,    ///< Wraps an integer.
         Float,  ///< Wraps a float.
-        String, ///< Wraps a string.
+        String, ///< Wraps a string, owned or interned.
         List,   ///< Wraps a list of values.
-        Map     ///< Wraps a map of values.
+        Map,    ///< Wraps a map of values.
+        Vec2,   ///< Wraps a point, stored inline.
+        Size,   ///< Wraps a size, stored inline.
+        Color,  ///< Wraps a Color3B, stored inline.
+        Rect,   ///< Wraps a rect, stored inline.
+        Blend   ///< Wraps a blend function, stored inline.
     };
 
     static const Self Null;
 
     static Self fromValue(const cocos2d::Value& value);
 
+    /// Decodes a packed value from the tagged map used by text formats,
+    /// e.g. {"@vec2": [x, y]}.
+    /// @return std::nullopt if the map is not a tagged value.
+    static std::optional<Self> fromTagged(const ValueMap& dict);
+
     Value();
 
     explicit Value(bool value);
@@ -39,14 +56,20 @@ public:
     explicit Value(ValueList&& value);
     explicit Value(const ValueMap& value);
     explicit Value(ValueMap&& value);
+    explicit Value(const cocos2d::Vec2& value);
+    explicit Value(const cocos2d::Size& value);
+    explicit Value(const cocos2d::Color3B& value);
+    explicit Value(const cocos2d::Rect& value);
+    explicit Value(const cocos2d::BlendFunc& value);
 
     Value(const Self& other);
-    Value(Self&& other);
+    /// Never throws, so that vectors of values move on reallocation.
+    Value(Self&& other) noexcept;
 
     ~Value();
 
     Self& operator=(const Self& other);
-    Self& operator=(Self&& other);
+    Self& operator=(Self&& other) noexcept;
 
     Self& operator=(bool value);
     Self& operator=(int value);
@@ -57,6 +80,11 @@ public:
     Self& operator=(ValueList&& value);
     Self& operator=(const ValueMap& value);
     Self& operator=(ValueMap&& value);
+    Self& operator=(const cocos2d::Vec2& value);
+    Self& operator=(const cocos2d::Size& value);
+    Self& operator=(const cocos2d::Color3B& value);
+    Self& operator=(const cocos2d::Rect& value);
+    Self& operator=(const cocos2d::BlendFunc& value);
 
     bool operator==(const Self& other) const;
     bool operator!=(const Self& other) const;
@@ -67,6 +95,11 @@ public:
     std::optional<std::string> getString() const;
     std::optional<ValueList> getList() const;
     std::optional<ValueMap> getMap() const;
+    std::optional<cocos2d::Vec2> getVec2() const;
+    std::optional<cocos2d::Size> getSize() const;
+    std::optional<cocos2d::Color3B> getColor() const;
+    std::optional<cocos2d::Rect> getRect() const;
+    std::optional<cocos2d::BlendFunc> getBlend() const;
 
     const std::string& asString() const;
     ValueList& asList();
@@ -81,6 +114,17 @@ public:
     bool isString() const;
     bool isList() const;
     bool isMap() const;
+    bool isVec2() const;
+    bool isSize() const;
+    bool isColor() const;
+    bool isRect() const;
+    bool isBlend() const;
+
+    /// Checks whether this is one of the inline vector-valued types.
+    bool isPacked() const;
+
+    /// Checks whether this is a string shared through a string pool.
+    bool isInterned() const;
 
     Type getType() const;
 
@@ -88,26 +132,32 @@ public:
 
     cocos2d::Value toValue() const;
 
+    /// Encodes a packed value to its tagged map.
+    ValueMap toTagged() const;
+
 private:
-    Self& operator=(const std::unique_ptr<std::string>& value);
-    Self& operator=(std::unique_ptr<std::string>&& value);
-    Self& operator=(const std::unique_ptr<ValueList>& value);
-    Self& operator=(std::unique_ptr<ValueList>&& value);
-    Self& operator=(const std::unique_ptr<ValueMap>& value);
-    Self& operator=(std::unique_ptr<ValueMap>&& value);
+    friend StringPool;
+
+    /// Shares the specified interned string.
+    explicit Value(const detail::PooledString* value);
 
     Type type_;
 
+    /// Whether the string is interned, only meaningful for strings.
+    bool interned_ = false;
+
     union Field {
         bool b;
         int i;
         float f;
-        std::unique_ptr<std::string> s;
-        std::unique_ptr<ValueList> l;
-        std::unique_ptr<ValueMap> m;
-
-        Field() {}
-        ~Field() {}
+        std::string* s;                ///< Owned string.
+        const detail::PooledString* p; ///< Interned string.
+        ValueList* l;
+        ValueMap* m;
+        cocos2d::Rect* r;   ///< Boxed, the only packed type over 8 bytes.
+        float v[2];         ///< Vec2 and Size components.
+        std::uint8_t c[3];  ///< Color components.
+        std::uint32_t e[2]; ///< Blend factors.
     } field_;
 };
 } // namespace ee
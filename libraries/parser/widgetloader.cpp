@@ -8,40 +8,35 @@ using Target = cocos2d::ui::Widget;
 using Helper = PropertyHelper<Target>;
 
 const PropertyBool Self::Property::Bright(
-    "bright", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isBright)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setBright)));
+    "bright",
+    Helper::makeAccessor<bool, &Target::isBright, &Target::setBright>());
 
 const PropertyBool Self::Property::Enabled(
-    "enabled", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setEnabled)));
+    "enabled",
+    Helper::makeAccessor<bool, &Target::isEnabled, &Target::setEnabled>());
 
 const PropertyBool Self::Property::FlippedX(
-    "flipped_x", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isFlippedX)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setFlippedX)));
+    "flipped_x",
+    Helper::makeAccessor<bool, &Target::isFlippedX, &Target::setFlippedX>());
 
 const PropertyBool Self::Property::FlippedY(
-    "flipped_y", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isFlippedY)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setFlippedY)));
+    "flipped_y",
+    Helper::makeAccessor<bool, &Target::isFlippedY, &Target::setFlippedY>());
 
 const PropertyBool Self::Property::Highlighted(
-    "highlighted", //
-    Helper::makeReader<bool>(std::mem_fn(&Target::isHighlighted)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setHighlighted)));
+    "highlighted",
+    Helper::makeAccessor<bool, &Target::isHighlighted,
+                         &Target::setHighlighted>());
 
 const PropertyBool Self::Property::IgnoreContentAdaptWithSize(
     "ignore_content_adapt_with_size",
-    Helper::makeReader<bool>(
-        std::mem_fn(&Target::isIgnoreContentAdaptWithSize)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::ignoreContentAdaptWithSize)));
+    Helper::makeAccessor<bool, &Target::isIgnoreContentAdaptWithSize,
+                         &Target::ignoreContentAdaptWithSize>());
 
 const PropertyBool Self::Property::LayoutComponentEnabled(
     "layout_component_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isLayoutComponentEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setLayoutComponentEnabled)));
+    Helper::makeAccessor<bool, &Target::isLayoutComponentEnabled,
+                         &Target::setLayoutComponentEnabled>());
 
 const PropertyPoint Self::Property::PositionPercent(
     "position_percent",
@@ -52,17 +47,15 @@ const PropertyPoint Self::Property::PositionPercent(
     Helper::makeWriter<cocos2d::Point>(
         std::mem_fn(&Target::setPositionPercent)));
 
-const PropertyEnum<Target::PositionType>
-    Self::Property::PositionType("position_type",
-                                 Helper::makeReader<Target::PositionType>(
-                                     std::mem_fn(&Target::getPositionType)),
-                                 Helper::makeWriter<Target::PositionType>(
-                                     std::mem_fn(&Target::setPositionType)));
+const PropertyEnum<Target::PositionType> Self::Property::PositionType(
+    "position_type",
+    Helper::makeAccessor<Target::PositionType, &Target::getPositionType,
+                         &Target::setPositionType>());
 
 const PropertyBool Self::Property::PropagateTouchEvents(
     "propagate_touch_events",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isPropagateTouchEvents)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setPropagateTouchEvents)));
+    Helper::makeAccessor<bool, &Target::isPropagateTouchEvents,
+                         &Target::setPropagateTouchEvents>());
 
 const PropertyPoint Self::Property::SizePercent(
     "size_percent", //
@@ -74,23 +67,23 @@ const PropertyPoint Self::Property::SizePercent(
 
 const PropertyEnum<Target::SizeType> Self::Property::SizeType(
     "size_type",
-    Helper::makeReader<Target::SizeType>(std::mem_fn(&Target::getSizeType)),
-    Helper::makeWriter<Target::SizeType>(std::mem_fn(&Target::setSizeType)));
+    Helper::makeAccessor<Target::SizeType, &Target::getSizeType,
+                         &Target::setSizeType>());
 
 const PropertyBool Self::Property::SwallowTouches(
     "swallow_touches",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isSwallowTouches)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setSwallowTouches)));
+    Helper::makeAccessor<bool, &Target::isSwallowTouches,
+                         &Target::setSwallowTouches>());
 
 const PropertyBool Self::Property::TouchEnabled(
     "touch_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isTouchEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setTouchEnabled)));
+    Helper::makeAccessor<bool, &Target::isTouchEnabled,
+                         &Target::setTouchEnabled>());
 
 const PropertyBool Self::Property::UnifySizeEnabled(
     "unify_size_enabled",
-    Helper::makeReader<bool>(std::mem_fn(&Target::isUnifySizeEnabled)),
-    Helper::makeWriter<bool>(std::mem_fn(&Target::setUnifySizeEnabled)));
+    Helper::makeAccessor<bool, &Target::isUnifySizeEnabled,
+                         &Target::setUnifySizeEnabled>());
 
 const std::string Self::Name = "_Widget";
 